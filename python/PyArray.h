@@ -0,0 +1,356 @@
+#pragma once
+#include "PyCommon.h"
+#include <pybind11/numpy.h>
+
+#include "Field.h"
+#include "Vector.h"
+
+#include <cstring>
+#include <type_traits>
+
+/**
+ * NumPy and DLPack access to array fields.
+ *
+ * Elements are exposed as rows of scalars, e.g. a FArray<Vec3f> of size N as an (N, 3) float32 array. Host arrays
+ * support the buffer protocol, numpy.asarray(field) is a view of the field that stays valid until the field is resized.
+ * Device arrays are copied through a single staged transfer. Both can be exported with __dlpack__ without a copy.
+ */
+
+// Minimal subset of the DLPack ABI (https://github.com/dmlc/dlpack), skipped if dlpack.h is already included
+#ifndef DLPACK_VERSION
+extern "C" {
+	typedef enum {
+		kDLCPU = 1,
+		kDLCUDA = 2,
+	} DLDeviceType;
+
+	typedef struct {
+		DLDeviceType device_type;
+		int32_t device_id;
+	} DLDevice;
+
+	typedef enum {
+		kDLInt = 0U,
+		kDLUInt = 1U,
+		kDLFloat = 2U,
+	} DLDataTypeCode;
+
+	typedef struct {
+		uint8_t code;
+		uint8_t bits;
+		uint16_t lanes;
+	} DLDataType;
+
+	typedef struct {
+		void* data;
+		DLDevice device;
+		int32_t ndim;
+		DLDataType dtype;
+		int64_t* shape;
+		int64_t* strides;
+		uint64_t byte_offset;
+	} DLTensor;
+
+	typedef struct DLManagedTensor {
+		DLTensor dl_tensor;
+		void* manager_ctx;
+		void (*deleter)(struct DLManagedTensor* self);
+	} DLManagedTensor;
+}
+#endif
+
+template<typename T>
+struct ArrayElement
+{
+	typedef T Scalar;
+	static const int dims = 1;
+};
+
+template<typename T, int dim>
+struct ArrayElement<dyno::Vector<T, dim>>
+{
+	typedef T Scalar;
+	static const int dims = dim;
+};
+
+template<typename T>
+std::vector<py::ssize_t> array_shape(size_t n)
+{
+	if (ArrayElement<T>::dims == 1)
+		return { (py::ssize_t)n };
+	else
+		return { (py::ssize_t)n, (py::ssize_t)ArrayElement<T>::dims };
+}
+
+// Strides in bytes, elements may be padded (e.g., Vec3f under the Vulkan backend)
+template<typename T>
+std::vector<py::ssize_t> array_strides()
+{
+	typedef typename ArrayElement<T>::Scalar Scalar;
+	if (ArrayElement<T>::dims == 1)
+		return { (py::ssize_t)sizeof(T) };
+	else
+		return { (py::ssize_t)sizeof(T), (py::ssize_t)sizeof(Scalar) };
+}
+
+// Whether an array of T has the same memory layout as a C-contiguous array of its scalars
+template<typename T>
+bool array_packed()
+{
+	return sizeof(T) == ArrayElement<T>::dims * sizeof(typename ArrayElement<T>::Scalar);
+}
+
+template<typename T>
+py::buffer_info array_buffer_info(T* data, size_t n)
+{
+	typedef typename ArrayElement<T>::Scalar Scalar;
+	return py::buffer_info(
+		data,
+		sizeof(Scalar),
+		py::format_descriptor<Scalar>::format(),
+		ArrayElement<T>::dims == 1 ? 1 : 2,
+		array_shape<T>(n),
+		array_strides<T>());
+}
+
+template<typename T>
+using NumpyArray = py::array_t<typename ArrayElement<T>::Scalar, py::array::c_style | py::array::forcecast>;
+
+template<typename T>
+size_t numpy_rows(const NumpyArray<T>& a)
+{
+	const int dims = ArrayElement<T>::dims;
+	if (dims == 1 && a.ndim() == 1)
+		return a.shape(0);
+
+	if (dims > 1 && a.ndim() == 2 && a.shape(1) == dims)
+		return a.shape(0);
+
+	throw py::value_error(dims == 1
+		? "expected an array of shape (N,)"
+		: "expected an array of shape (N, " + std::to_string(dims) + ")");
+}
+
+// Copies n rows from a C-contiguous buffer of scalars into the elements, and back
+template<typename T>
+void unpack_rows(T* dst, const typename ArrayElement<T>::Scalar* src, size_t n)
+{
+	const int dims = ArrayElement<T>::dims;
+	for (size_t i = 0; i < n; i++)
+		std::memcpy((void*)&dst[i], src + i * dims, dims * sizeof(typename ArrayElement<T>::Scalar));
+}
+
+template<typename T>
+void pack_rows(typename ArrayElement<T>::Scalar* dst, const T* src, size_t n)
+{
+	const int dims = ArrayElement<T>::dims;
+	for (size_t i = 0; i < n; i++)
+		std::memcpy(dst + i * dims, (const void*)&src[i], dims * sizeof(typename ArrayElement<T>::Scalar));
+}
+
+template<typename T, DeviceType deviceType>
+struct ArrayStorage;
+
+template<typename T>
+struct ArrayStorage<T, DeviceType::CPU>
+{
+	static void download(typename ArrayElement<T>::Scalar* dst, dyno::CArray<T>& src)
+	{
+		if (array_packed<T>())
+			std::memcpy(dst, src.begin(), src.size() * sizeof(T));
+		else
+			pack_rows(dst, src.begin(), src.size());
+	}
+
+	static void upload(dyno::CArray<T>& dst, const typename ArrayElement<T>::Scalar* src)
+	{
+		if (array_packed<T>())
+			std::memcpy(dst.begin(), src, dst.size() * sizeof(T));
+		else
+			unpack_rows(dst.begin(), src, dst.size());
+	}
+
+	static DLDevice device()
+	{
+		return DLDevice{ kDLCPU, 0 };
+	}
+};
+
+#ifndef NO_BACKEND
+template<typename T>
+struct ArrayStorage<T, DeviceType::GPU>
+{
+	static void download(typename ArrayElement<T>::Scalar* dst, dyno::DArray<T>& src)
+	{
+#ifdef CUDA_BACKEND
+		if (array_packed<T>())
+		{
+			cuSafeCall(cudaMemcpy(dst, src.begin(), src.size() * sizeof(T), cudaMemcpyDeviceToHost));
+			return;
+		}
+#endif
+		dyno::CArray<T> staged;
+		staged.assign(src);
+		ArrayStorage<T, DeviceType::CPU>::download(dst, staged);
+	}
+
+	static void upload(dyno::DArray<T>& dst, const typename ArrayElement<T>::Scalar* src)
+	{
+#ifdef CUDA_BACKEND
+		if (array_packed<T>())
+		{
+			cuSafeCall(cudaMemcpy(dst.begin(), src, dst.size() * sizeof(T), cudaMemcpyHostToDevice));
+			return;
+		}
+#endif
+		dyno::CArray<T> staged(dst.size());
+		ArrayStorage<T, DeviceType::CPU>::upload(staged, src);
+		dst.assign(staged);
+	}
+
+#ifdef CUDA_BACKEND
+	static DLDevice device()
+	{
+		int id = 0;
+		cuSafeCall(cudaGetDevice(&id));
+		return DLDevice{ kDLCUDA, id };
+	}
+#endif
+};
+#endif
+
+/**
+ * @brief Returns a new NumPy array holding a copy of the field
+ */
+template<typename T, DeviceType deviceType>
+NumpyArray<T> field_to_numpy(dyno::FArray<T, deviceType>& field)
+{
+	size_t n = field.size();
+	NumpyArray<T> out(array_shape<T>(n));
+	if (n > 0)
+		ArrayStorage<T, deviceType>::download(out.mutable_data(), *field.constDataPtr());
+
+	return out;
+}
+
+/**
+ * @brief Resizes the field to the number of rows of a and copies a into it
+ */
+template<typename T, DeviceType deviceType>
+void field_from_numpy(dyno::FArray<T, deviceType>& field, const NumpyArray<T>& a)
+{
+	size_t n = numpy_rows<T>(a);
+	field.resize((uint)n);
+	if (n > 0)
+		ArrayStorage<T, deviceType>::upload(field.getData(), a.data());
+}
+
+template<typename Scalar>
+DLDataType dlpack_dtype()
+{
+	DLDataType type;
+	type.code = std::is_floating_point<Scalar>::value ? kDLFloat : (std::is_signed<Scalar>::value ? kDLInt : kDLUInt);
+	type.bits = (uint8_t)(8 * sizeof(Scalar));
+	type.lanes = 1;
+	return type;
+}
+
+/**
+ * @brief Exports the field as a DLPack capsule without copying, the tensor keeps the array of the field alive
+ * 	but is invalidated if the field is resized
+ */
+template<typename T, DeviceType deviceType>
+py::capsule field_to_dlpack(dyno::FArray<T, deviceType>& field)
+{
+	typedef typename ArrayElement<T>::Scalar Scalar;
+	typedef dyno::Array<T, deviceType> Data;
+
+	struct Context
+	{
+		std::shared_ptr<Data> data;
+		int64_t shape[2];
+		int64_t strides[2];
+		DLManagedTensor tensor;
+	};
+
+	auto data = field.allocate();
+
+	Context* ctx = new Context;
+	ctx->data = data;
+	ctx->shape[0] = data->size();
+	ctx->shape[1] = ArrayElement<T>::dims;
+	ctx->strides[0] = sizeof(T) / sizeof(Scalar);
+	ctx->strides[1] = 1;
+
+	DLTensor& t = ctx->tensor.dl_tensor;
+	t.data = data->begin();
+	t.device = ArrayStorage<T, deviceType>::device();
+	t.ndim = ArrayElement<T>::dims == 1 ? 1 : 2;
+	t.dtype = dlpack_dtype<Scalar>();
+	t.shape = ctx->shape;
+	t.strides = ctx->strides;
+	t.byte_offset = 0;
+
+	ctx->tensor.manager_ctx = ctx;
+	ctx->tensor.deleter = [](DLManagedTensor* self) {
+		Context* c = static_cast<Context*>(self->manager_ctx);
+
+		// device arrays are not released by their destructors, see FArray::~FArray()
+		if (c->data.use_count() == 1)
+			c->data->clear();
+
+		delete c;
+	};
+
+	// a consumer renames the capsule to "used_dltensor" and becomes responsible for calling the deleter
+	return py::capsule(&ctx->tensor, "dltensor", [](PyObject* capsule) {
+		if (PyCapsule_IsValid(capsule, "dltensor"))
+		{
+			DLManagedTensor* tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, "dltensor"));
+			tensor->deleter(tensor);
+		}
+	});
+}
+
+template<typename T, DeviceType deviceType>
+struct ArrayBinding;
+
+template<typename T>
+struct ArrayBinding<T, DeviceType::CPU>
+{
+	template<typename PyClass>
+	static void bind(PyClass& cls)
+	{
+		using Class = dyno::FArray<T, DeviceType::CPU>;
+		cls.def_buffer([](Class& f) -> py::buffer_info {
+				auto& data = f.constDataPtr();
+				return array_buffer_info<T>(data == nullptr ? nullptr : data->begin(), f.size());
+			})
+			.def("__dlpack__", [](Class& f, py::object stream) { return field_to_dlpack(f); }, py::arg("stream") = py::none())
+			.def("__dlpack_device__", [](Class& f) { return py::make_tuple((int)kDLCPU, 0); });
+	}
+};
+
+#ifndef NO_BACKEND
+template<typename T>
+struct ArrayBinding<T, DeviceType::GPU>
+{
+	template<typename PyClass>
+	static void bind(PyClass& cls)
+	{
+#ifdef CUDA_BACKEND
+		using Class = dyno::FArray<T, DeviceType::GPU>;
+
+		// all simulation kernels run on the default stream, wait for them instead of recording an event on the stream of the consumer
+		cls.def("__dlpack__", [](Class& f, py::object stream) {
+				cuSafeCall(cudaDeviceSynchronize());
+				return field_to_dlpack(f);
+			}, py::arg("stream") = py::none())
+			.def("__dlpack_device__", [](Class& f) {
+				DLDevice device = ArrayStorage<T, DeviceType::GPU>::device();
+				return py::make_tuple((int)device.device_type, device.device_id);
+			});
+#endif
+	}
+};
+#endif
@@ -1,4 +1,5 @@
 #include "PyFramework.h"
+#include "PyArray.h"
 
 #include "Node.h"
 #include "FInstance.h"
@@ -29,6 +30,9 @@
 #include "SceneGraph.h"
 #include "Log.h"
 
+#include <future>
+#include <chrono>
+
 using FBase = dyno::FBase;
 using InstanceBase = dyno::InstanceBase;
 using Node = dyno::Node;
@@ -43,6 +47,49 @@ using SceneGraph = dyno::SceneGraph;
 using VisualModule = dyno::VisualModule;
 using Log = dyno::Log;
 
+/**
+ * Handle to frames taken on a worker thread, returned by SceneGraph.take_one_frame_async().
+ * The worker keeps the scene alive until it finishes.
+ */
+class FrameFuture
+{
+public:
+	explicit FrameFuture(std::shared_future<void> future)
+		: mFuture(future) {}
+
+	bool done() const {
+		return mFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	// Waits for at most timeout seconds, or until the frames are taken if timeout is negative
+	bool wait(double timeout) const {
+		if (timeout < 0.0) {
+			mFuture.wait();
+			return true;
+		}
+
+		return mFuture.wait_for(std::chrono::duration<double>(timeout)) == std::future_status::ready;
+	}
+
+	// Waits and rethrows an exception raised while taking the frames
+	void result() const {
+		mFuture.get();
+	}
+
+private:
+	std::shared_future<void> mFuture;
+};
+
+FrameFuture take_frames_async(std::shared_ptr<SceneGraph> scene, int frames)
+{
+	std::shared_future<void> future = std::async(std::launch::async, [scene, frames]() {
+		for (int i = 0; i < frames; i++)
+			scene->takeOneFrame();
+	}).share();
+
+	return FrameFuture(future);
+}
+
 template<class TNode, class ...Args>
 std::shared_ptr<TNode> create_root(SceneGraph& scene, Args&& ... args) {
 	return scene.createNewScene<TNode>(std::forward<Args>(args)...);
@@ -73,9 +120,15 @@ void declare_array(py::module& m, std::string typestr) {
 	using Class = dyno::FArray<T, deviceType>;
 	using Parent = FBase;
 	std::string pyclass_name = std::string("Array") + typestr;
-	py::class_<Class, Parent, std::shared_ptr<Class>>(m, pyclass_name.c_str(), py::buffer_protocol(), py::dynamic_attr())
+	auto cls = py::class_<Class, Parent, std::shared_ptr<Class>>(m, pyclass_name.c_str(), py::buffer_protocol(), py::dynamic_attr())
 		.def(py::init<>())
-		.def("resize", &Class::resize);
+		.def("resize", &Class::resize)
+		.def("size", &Class::size)
+		.def("__len__", &Class::size)
+		.def("to_numpy", &field_to_numpy<T, deviceType>)
+		.def("from_numpy", &field_from_numpy<T, deviceType>, py::arg("array"));
+
+	ArrayBinding<T, deviceType>::bind(cls);
 }
 
 template<typename T>
@@ -246,6 +299,14 @@ void pybind_framework(py::module& m)
 {
 	pybind_log(m);
 
+	// native work below runs without the GIL so that other Python threads, or other scenes, can proceed meanwhile
+	using release_gil = py::call_guard<py::gil_scoped_release>;
+
+	py::class_<FrameFuture>(m, "FrameFuture")
+		.def("done", &FrameFuture::done)
+		.def("wait", &FrameFuture::wait, py::arg("timeout") = -1.0, release_gil())
+		.def("result", &FrameFuture::result, release_gil());
+
 	py::class_<Node, std::shared_ptr<Node>>(m, "Node")
 		.def(py::init<>())
 		.def("set_name", &Node::setName)
@@ -253,6 +314,8 @@ void pybind_framework(py::module& m)
 		.def("connect", &Node::connect)
 		.def("set_visible", &Node::setVisible)
 		.def("disconnect", &Node::disconnect)
+		.def("update", &Node::update, release_gil())
+		.def("reset", &Node::reset, release_gil())
 		.def("graphics_pipeline", &Node::graphicsPipeline, py::return_value_policy::reference)
 		.def("animation_pipeline", &Node::animationPipeline, py::return_value_policy::reference);
 
@@ -284,7 +347,12 @@ void pybind_framework(py::module& m)
 	py::class_<SceneGraph, std::shared_ptr<SceneGraph>>(m, "SceneGraph")
 		.def(py::init<>())
 		.def("is_initialized", &SceneGraph::isInitialized)
-		.def("initialize", &SceneGraph::initialize)
+		.def("initialize", &SceneGraph::initialize, release_gil())
+		.def("take_one_frame", &SceneGraph::takeOneFrame, release_gil())
+		.def("take_one_frame_async", &take_frames_async, py::arg("frames") = 1)
+		.def("run", &SceneGraph::run, release_gil())
+		.def("reset", static_cast<void(SceneGraph::*)()>(&SceneGraph::reset), release_gil())
+		.def("print_frame_info", &SceneGraph::printFrameInfo)
 		.def("set_total_time", &SceneGraph::setTotalTime)
 		.def("get_total_time", &SceneGraph::getTotalTime)
 		.def("set_frame_rate", &SceneGraph::setFrameRate)
@@ -315,6 +383,11 @@ void pybind_framework(py::module& m)
 
 	declare_array<float, DeviceType::GPU>(m, "1fD");
 	declare_array<dyno::Vec3f, DeviceType::GPU>(m, "3fD");
+	declare_array<int, DeviceType::GPU>(m, "1iD");
+
+	declare_array<float, DeviceType::CPU>(m, "1fH");
+	declare_array<dyno::Vec3f, DeviceType::CPU>(m, "3fH");
+	declare_array<int, DeviceType::CPU>(m, "1iH");
 
 	declare_instance<TopologyModule>(m, "");
 	declare_instance<dyno::PointSet<dyno::DataType3f>>(m, "PointSet3f");
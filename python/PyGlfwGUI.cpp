@@ -9,5 +9,5 @@ void pybind_glfw_gui(py::module& m)
 		.def(py::init())
 		.def("set_scenegraph", &dyno::GlfwApp::setSceneGraph)
 		.def("initialize", &dyno::GlfwApp::initialize)
-		.def("main_loop", &dyno::GlfwApp::mainLoop);
+		.def("main_loop", &dyno::GlfwApp::mainLoop, py::call_guard<py::gil_scoped_release>());
 }
@@ -0,0 +1,349 @@
+#include "VkCommandBatch.h"
+#include "VkSystem.h"
+#include "VkVariable.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dyno {
+
+	// Size of each chunk used to store uniform values of recorded dispatches
+	const VkDeviceSize UNIFORM_CHUNK_SIZE = 64 * 1024;
+
+	// Number of descriptor sets in each descriptor pool
+	const uint32_t DESCRIPTOR_SETS_PER_POOL = 256;
+
+	static thread_local VkCommandBatch* gCurrentBatch = nullptr;
+
+	VkCommandBatch::VkCommandBatch()
+	{
+	}
+
+	VkCommandBatch::~VkCommandBatch()
+	{
+		if (ctx == nullptr)
+			return;
+
+		if (mRecording)
+			end(true);
+		else
+			wait();
+
+		VkDevice device = ctx->deviceHandle();
+		for (auto& frame : mFree)
+		{
+			for (auto pool : frame.descriptorPools)
+				vkDestroyDescriptorPool(device, pool, nullptr);
+
+			for (auto& chunk : frame.uniformChunks)
+			{
+				chunk->unmap();
+				chunk->destroy();
+			}
+
+			vkDestroyFence(device, frame.fence, nullptr);
+		}
+		mFree.clear();
+
+		vkDestroyCommandPool(device, mCommandPool, nullptr);
+	}
+
+	VkCommandBatch* VkCommandBatch::current()
+	{
+		return gCurrentBatch;
+	}
+
+	bool VkCommandBatch::deferRelease(std::shared_ptr<vks::Buffer>& buffer)
+	{
+		VkCommandBatch* batch = gCurrentBatch;
+		if (batch == nullptr || !batch->mRecording)
+			return false;
+
+		if (buffer->buffer == VK_NULL_HANDLE)
+			return false;
+
+		batch->mFrame.released.push_back(buffer);
+		buffer = std::make_shared<vks::Buffer>();
+
+		return true;
+	}
+
+	void VkCommandBatch::initialize()
+	{
+		ctx = VkSystem::instance()->currentContext();
+		assert(ctx != nullptr);
+
+		// Use the same queue as VkProgram so that batched and individually submitted dispatches stay ordered
+		vkGetDeviceQueue(ctx->deviceHandle(), ctx->queueFamilyIndices.compute, 0, &mQueue);
+
+		mCommandPool = ctx->createCommandPool(ctx->queueFamilyIndices.compute,
+			VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+	}
+
+	void VkCommandBatch::begin()
+	{
+		if (gCurrentBatch != nullptr && gCurrentBatch != this)
+		{
+			mJoined = true;
+			return;
+		}
+
+		assert(!mRecording);
+
+		if (ctx == nullptr)
+			initialize();
+
+		acquireFrame();
+
+		gCurrentBatch = this;
+		mRecording = true;
+	}
+
+	void VkCommandBatch::end(bool sync)
+	{
+		if (mJoined)
+		{
+			mJoined = false;
+			return;
+		}
+
+		if (!mRecording)
+			return;
+
+		submitFrame();
+
+		mRecording = false;
+		gCurrentBatch = nullptr;
+
+		if (sync)
+			wait();
+	}
+
+	void VkCommandBatch::submit()
+	{
+		if (!hasCommands())
+			return;
+
+		submitFrame();
+		acquireFrame();
+	}
+
+	void VkCommandBatch::wait()
+	{
+		while (!mInFlight.empty())
+		{
+			Frame frame = mInFlight.front();
+			mInFlight.pop_front();
+
+			VK_CHECK_RESULT(vkWaitForFences(ctx->deviceHandle(), 1, &frame.fence, VK_TRUE, UINT64_MAX));
+
+			retireFrame(frame);
+		}
+	}
+
+	VkDescriptorSet VkCommandBatch::allocateDescriptorSet(VkDescriptorSetLayout layout)
+	{
+		assert(mRecording);
+
+		VkDescriptorSet set = VK_NULL_HANDLE;
+		while (true)
+		{
+			if (mFrame.poolIndex == mFrame.descriptorPools.size())
+				mFrame.descriptorPools.push_back(createDescriptorPool());
+
+			VkDescriptorSetAllocateInfo allocInfo =
+				vks::initializers::descriptorSetAllocateInfo(mFrame.descriptorPools[mFrame.poolIndex], &layout, 1);
+
+			VkResult ret = vkAllocateDescriptorSets(ctx->deviceHandle(), &allocInfo, &set);
+			if (ret == VK_SUCCESS)
+				break;
+
+			if (ret != VK_ERROR_OUT_OF_POOL_MEMORY && ret != VK_ERROR_FRAGMENTED_POOL)
+				VK_CHECK_RESULT(ret);
+
+			mFrame.poolIndex++;
+		}
+
+		return set;
+	}
+
+	VkDescriptorBufferInfo VkCommandBatch::stageUniform(const void* data, uint32_t size)
+	{
+		assert(mRecording);
+
+		VkDeviceSize alignment = std::max<VkDeviceSize>(ctx->properties.limits.minUniformBufferOffsetAlignment, 16);
+		VkDeviceSize aligned = (size + alignment - 1) / alignment * alignment;
+
+		auto& chunks = mFrame.uniformChunks;
+		while (mFrame.chunkIndex < chunks.size() && mFrame.chunkOffset + aligned > chunks[mFrame.chunkIndex]->size)
+		{
+			mFrame.chunkIndex++;
+			mFrame.chunkOffset = 0;
+		}
+
+		if (mFrame.chunkIndex == chunks.size())
+		{
+			auto chunk = std::make_shared<vks::Buffer>();
+			ctx->createBuffer(
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+				chunk,
+				std::max(UNIFORM_CHUNK_SIZE, aligned));
+			VK_CHECK_RESULT(chunk->map());
+
+			chunks.push_back(chunk);
+			mFrame.chunkOffset = 0;
+		}
+
+		auto& chunk = chunks[mFrame.chunkIndex];
+		if (data != nullptr)
+			memcpy((uint8_t*)chunk->mapped + mFrame.chunkOffset, data, size);
+
+		VkDescriptorBufferInfo info;
+		info.buffer = chunk->buffer;
+		info.offset = mFrame.chunkOffset;
+		info.range = size;
+
+		mFrame.chunkOffset += aligned;
+
+		return info;
+	}
+
+	void VkCommandBatch::addDispatchBarrier(const std::vector<VkVariable*>& buffers)
+	{
+		assert(mRecording);
+
+		bool hazard = false;
+		for (auto var : buffers)
+		{
+			if (std::find(mTouched.begin(), mTouched.end(), var->bufferHandle()) != mTouched.end())
+			{
+				hazard = true;
+				break;
+			}
+		}
+
+		if (hazard)
+		{
+			VkMemoryBarrier barrier = vks::initializers::memoryBarrier();
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			vkCmdPipelineBarrier(
+				mFrame.cmd,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_FLAGS_NONE,
+				1, &barrier,
+				0, nullptr,
+				0, nullptr);
+
+			mTouched.clear();
+		}
+
+		for (auto var : buffers)
+		{
+			mTouched.push_back(var->bufferHandle());
+		}
+
+		mFrame.dispatches++;
+	}
+
+	void VkCommandBatch::acquireFrame()
+	{
+		// Recycle frames that have finished executing
+		while (!mInFlight.empty() && vkGetFenceStatus(ctx->deviceHandle(), mInFlight.front().fence) == VK_SUCCESS)
+		{
+			Frame frame = mInFlight.front();
+			mInFlight.pop_front();
+
+			retireFrame(frame);
+		}
+
+		if (mFree.empty())
+		{
+			Frame frame;
+			frame.cmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, mCommandPool, false);
+
+			VkFenceCreateInfo fenceInfo = vks::initializers::fenceCreateInfo(VK_FLAGS_NONE);
+			VK_CHECK_RESULT(vkCreateFence(ctx->deviceHandle(), &fenceInfo, nullptr, &frame.fence));
+
+			mFrame = frame;
+		}
+		else
+		{
+			mFrame = mFree.back();
+			mFree.pop_back();
+		}
+
+		mTouched.clear();
+
+		VkCommandBufferBeginInfo beginInfo = vks::initializers::commandBufferBeginInfo();
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT(vkBeginCommandBuffer(mFrame.cmd, &beginInfo));
+	}
+
+	void VkCommandBatch::submitFrame()
+	{
+		// Make the results visible to everything submitted afterwards
+		VkMemoryBarrier barrier = vks::initializers::memoryBarrier();
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		vkCmdPipelineBarrier(
+			mFrame.cmd,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VK_FLAGS_NONE,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr);
+
+		VK_CHECK_RESULT(vkEndCommandBuffer(mFrame.cmd));
+
+		VkSubmitInfo submitInfo = vks::initializers::submitInfo();
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &mFrame.cmd;
+		VK_CHECK_RESULT(vkQueueSubmit(mQueue, 1, &submitInfo, mFrame.fence));
+
+		mInFlight.push_back(mFrame);
+		mFrame = Frame();
+
+		mTouched.clear();
+	}
+
+	void VkCommandBatch::retireFrame(Frame& frame)
+	{
+		VkDevice device = ctx->deviceHandle();
+
+		VK_CHECK_RESULT(vkResetFences(device, 1, &frame.fence));
+		VK_CHECK_RESULT(vkResetCommandBuffer(frame.cmd, 0));
+
+		for (auto pool : frame.descriptorPools)
+			VK_CHECK_RESULT(vkResetDescriptorPool(device, pool, 0));
+
+		for (auto& buffer : frame.released)
+			buffer->destroy();
+
+		frame.released.clear();
+		frame.dispatches = 0;
+		frame.poolIndex = 0;
+		frame.chunkIndex = 0;
+		frame.chunkOffset = 0;
+
+		mFree.push_back(frame);
+	}
+
+	VkDescriptorPool VkCommandBatch::createDescriptorPool()
+	{
+		std::vector<VkDescriptorPoolSize> poolSizes;
+		poolSizes.push_back(vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 8 * DESCRIPTOR_SETS_PER_POOL));
+		poolSizes.push_back(vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 * DESCRIPTOR_SETS_PER_POOL));
+
+		VkDescriptorPoolCreateInfo descriptorPoolInfo =
+			vks::initializers::descriptorPoolCreateInfo(poolSizes, DESCRIPTOR_SETS_PER_POOL);
+
+		VkDescriptorPool pool;
+		VK_CHECK_RESULT(vkCreateDescriptorPool(ctx->deviceHandle(), &descriptorPoolInfo, nullptr, &pool));
+
+		return pool;
+	}
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include "VkContext.h"
+#include "VulkanBuffer.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace dyno {
+
+	class VkVariable;
+
+	/*!
+	*	\class	VkCommandBatch
+	*	\brief	Records dispatches of many VkProgram/VkMultiProgram into one command buffer that is submitted once.
+	*
+	*	While a batch is recording on the current thread, VkProgram::flush() records its dispatch into the batch
+	*	instead of submitting and waiting on its own. A compute barrier is only inserted in front of a dispatch that
+	*	touches a storage buffer used since the last barrier. Uniform values are copied at record time, and storage
+	*	buffers released during recording are kept alive until the batch has finished executing.
+	*
+	*	Transfers through vkTransfer() submit the recorded dispatches first, so host reads observe their results.
+	*	No host transfer should happen between VkMultiProgram::begin() and VkMultiProgram::end().
+	*/
+	class VkCommandBatch
+	{
+	public:
+		VkCommandBatch();
+		~VkCommandBatch();
+
+		/**
+		 * @brief Start recording, joins the batch already recording on this thread if there is one
+		 */
+		void begin();
+
+		/**
+		 * @brief Stop recording and submit all recorded dispatches
+		 *
+		 * @param sync wait for the dispatches to finish. Otherwise, all buffers used by the batch must stay alive until wait() is called.
+		 */
+		void end(bool sync = true);
+
+		/**
+		 * @brief Submit what has been recorded so far and continue recording into a new command buffer
+		 */
+		void submit();
+
+		/**
+		 * @brief Wait for all submitted dispatches to finish
+		 */
+		void wait();
+
+		bool isRecording() { return mRecording; }
+
+		bool hasCommands() { return mRecording && mFrame.dispatches > 0; }
+
+		VkCommandBuffer commandBuffer() { return mFrame.cmd; }
+
+		/**
+		 * @brief Allocate a descriptor set that is only valid for the current submission
+		 */
+		VkDescriptorSet allocateDescriptorSet(VkDescriptorSetLayout layout);
+
+		/**
+		 * @brief Copy a uniform value into memory owned by the batch
+		 *
+		 * @return descriptor of the copied value
+		 */
+		VkDescriptorBufferInfo stageUniform(const void* data, uint32_t size);
+
+		/**
+		 * @brief Insert a compute barrier if any of the buffers has been used since the last barrier, to be called before each dispatch
+		 */
+		void addDispatchBarrier(const std::vector<VkVariable*>& buffers);
+
+		/**
+		 * @brief Hand over a buffer that is about to be destroyed, it is destroyed once the batch has finished executing
+		 *
+		 * @return false if no batch is recording and the caller should destroy the buffer
+		 */
+		static bool deferRelease(std::shared_ptr<vks::Buffer>& buffer);
+
+		/**
+		 * @brief The batch recording on the current thread, nullptr if there is none
+		 */
+		static VkCommandBatch* current();
+
+	private:
+		struct Frame
+		{
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+
+			uint32_t dispatches = 0;
+
+			std::vector<VkDescriptorPool> descriptorPools;
+			uint32_t poolIndex = 0;
+
+			std::vector<std::shared_ptr<vks::Buffer>> uniformChunks;
+			uint32_t chunkIndex = 0;
+			VkDeviceSize chunkOffset = 0;
+
+			std::vector<std::shared_ptr<vks::Buffer>> released;
+		};
+
+		void initialize();
+
+		void acquireFrame();
+		void submitFrame();
+		void retireFrame(Frame& frame);
+
+		VkDescriptorPool createDescriptorPool();
+
+		VkContext* ctx = nullptr;
+
+		VkQueue mQueue = VK_NULL_HANDLE;
+		VkCommandPool mCommandPool = VK_NULL_HANDLE;
+
+		bool mRecording = false;
+		bool mJoined = false;
+
+		Frame mFrame;
+
+		std::deque<Frame> mInFlight;
+		std::vector<Frame> mFree;
+
+		//Storage buffers used since the last barrier
+		std::vector<VkBuffer> mTouched;
+	};
+
+	/*!
+	*	\class	VkCommandBatchScope
+	*	\brief	Keeps a VkCommandBatch recording for the lifetime of the scope.
+	*
+	*	The batch is ended when the scope is left, including by an exception, so that the batch recording on the
+	*	current thread never outlives the code that started it.
+	*/
+	class VkCommandBatchScope
+	{
+	public:
+		/**
+		 * @param enabled start the batch, otherwise the scope does nothing
+		 */
+		explicit VkCommandBatchScope(VkCommandBatch& batch, bool enabled = true)
+			: mBatch(enabled ? &batch : nullptr)
+		{
+			if (mBatch != nullptr)
+				mBatch->begin();
+		}
+
+		~VkCommandBatchScope()
+		{
+			if (mBatch != nullptr)
+				mBatch->end();
+		}
+
+		VkCommandBatchScope(const VkCommandBatchScope&) = delete;
+		VkCommandBatchScope& operator=(const VkCommandBatchScope&) = delete;
+
+	private:
+		VkCommandBatch* mBatch;
+	};
+}
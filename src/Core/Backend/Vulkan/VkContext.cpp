@@ -1,4 +1,19 @@
 #include "VkContext.h"
+#include "VkStagingRing.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <ghc/fs_std.hpp>
 
 #define VMA_IMPLEMENTATION
 #include "VulkanMemoryAllocator/include/vk_mem_alloc.h"
@@ -51,6 +66,14 @@ namespace dyno {
 	*/
 	VkContext::~VkContext()
 	{
+		if (mStagingRing != nullptr)
+		{
+			delete mStagingRing;
+			mStagingRing = nullptr;
+		}
+
+		destroyPipelineCache();
+
 	    for (const auto &pool : poolMap)
         {
 	        vmaDestroyPool(g_Allocator, pool.second.pool);
@@ -68,6 +91,16 @@ namespace dyno {
 	}
 
 
+	VkStagingRing* VkContext::stagingRing()
+	{
+		if (mStagingRing == nullptr)
+		{
+			mStagingRing = new VkStagingRing(this);
+		}
+
+		return mStagingRing;
+	}
+
 	bool VkContext::isComputeQueueSpecial()
 	{
 		return this->queueFamilyIndices.graphics != this->queueFamilyIndices.compute;
@@ -324,11 +357,194 @@ namespace dyno {
 	}
 
 
+	/**
+	* Header of the pipeline cache file, the cache is only reused by the same device running the same driver
+	*/
+	struct PipelineCacheFileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint32_t driverVersion;
+		uint8_t deviceUUID[VK_UUID_SIZE];
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+		uint64_t dataSize;
+		uint64_t checksum;
+	};
+
+	static const uint32_t PIPELINE_CACHE_MAGIC = 0x43504450;	// "PDPC"
+	static const uint32_t PIPELINE_CACHE_VERSION = 1;
+
+	static uint64_t fnv1a(const std::vector<char>& data)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : data)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	static PipelineCacheFileHeader pipelineCacheHeader(VkPhysicalDevice physicalDevice, const VkPhysicalDeviceProperties& properties)
+	{
+		VkPhysicalDeviceIDProperties idProperties = {};
+		idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+		VkPhysicalDeviceProperties2 properties2 = {};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &idProperties;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+		PipelineCacheFileHeader header = {};
+		header.magic = PIPELINE_CACHE_MAGIC;
+		header.version = PIPELINE_CACHE_VERSION;
+		header.vendorID = properties.vendorID;
+		header.deviceID = properties.deviceID;
+		header.driverVersion = properties.driverVersion;
+		memcpy(header.deviceUUID, idProperties.deviceUUID, VK_UUID_SIZE);
+		memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+		return header;
+	}
+
+	std::string VkContext::pipelineCacheFile()
+	{
+		if (pipelineCacheDirectory.empty())
+			return std::string();
+
+		std::stringstream ss;
+		ss << std::hex << properties.vendorID << "_" << properties.deviceID;
+
+		return (fs::path(pipelineCacheDirectory) / ("vk_pipeline_cache_" + ss.str() + ".bin")).string();
+	}
+
 	void VkContext::createPipelineCache()
 	{
+		std::vector<char> data;
+
+		std::string fileName = pipelineCacheFile();
+		if (!fileName.empty())
+		{
+			std::ifstream input(fileName, std::ios::binary);
+			if (input.is_open())
+			{
+				PipelineCacheFileHeader expected = pipelineCacheHeader(physicalDevice, properties);
+
+				PipelineCacheFileHeader header;
+				input.read((char*)&header, sizeof(header));
+
+				bool valid = input.good()
+					&& header.magic == expected.magic
+					&& header.version == expected.version
+					&& header.vendorID == expected.vendorID
+					&& header.deviceID == expected.deviceID
+					&& header.driverVersion == expected.driverVersion
+					&& memcmp(header.deviceUUID, expected.deviceUUID, VK_UUID_SIZE) == 0
+					&& memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+				// Bound the size by the file so that a corrupted header never triggers a huge allocation
+				std::error_code ec;
+				uint64_t fileSize = fs::file_size(fileName, ec);
+				valid = valid && !ec && header.dataSize <= fileSize - sizeof(header);
+
+				if (valid)
+				{
+					data.resize(header.dataSize);
+					input.read(data.data(), header.dataSize);
+
+					valid = input.good() && fnv1a(data) == header.checksum;
+				}
+
+				if (!valid)
+				{
+					std::cout << "Pipeline cache " << fileName << " is outdated or corrupted, it will be rebuilt" << std::endl;
+					data.clear();
+				}
+			}
+		}
+
 		VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
 		pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-		VK_CHECK_RESULT(vkCreatePipelineCache(logicalDevice, &pipelineCacheCreateInfo, nullptr, &pipelineCache));
+		pipelineCacheCreateInfo.initialDataSize = data.size();
+		pipelineCacheCreateInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+		pipelineCacheChecksum = data.empty() ? 0 : fnv1a(data);
+
+		// The driver validates the data again, fall back to an empty cache if it is rejected
+		if (vkCreatePipelineCache(logicalDevice, &pipelineCacheCreateInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+		{
+			pipelineCacheCreateInfo.initialDataSize = 0;
+			pipelineCacheCreateInfo.pInitialData = nullptr;
+			VK_CHECK_RESULT(vkCreatePipelineCache(logicalDevice, &pipelineCacheCreateInfo, nullptr, &pipelineCache));
+
+			pipelineCacheChecksum = 0;
+		}
+	}
+
+	bool VkContext::savePipelineCache()
+	{
+		std::string fileName = pipelineCacheFile();
+		if (pipelineCache == VK_NULL_HANDLE || fileName.empty())
+			return false;
+
+		size_t size = 0;
+		if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+			return false;
+
+		std::vector<char> data(size);
+		if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &size, data.data()) != VK_SUCCESS)
+			return false;
+		data.resize(size);
+
+		// Nothing new has been compiled since the cache was loaded
+		uint64_t checksum = fnv1a(data);
+		if (checksum == pipelineCacheChecksum)
+			return true;
+
+		PipelineCacheFileHeader header = pipelineCacheHeader(physicalDevice, properties);
+		header.dataSize = data.size();
+		header.checksum = checksum;
+
+		std::error_code ec;
+		fs::create_directories(pipelineCacheDirectory, ec);
+
+		// Write to a temporary file of this process first so that a concurrently starting process never reads a partial cache
+		std::string tmpName = fileName + "." + std::to_string(getpid()) + ".tmp";
+		{
+			std::ofstream output(tmpName, std::ios::binary | std::ios::trunc);
+			if (!output.is_open())
+				return false;
+
+			output.write((const char*)&header, sizeof(header));
+			output.write(data.data(), data.size());
+
+			if (!output.good())
+				return false;
+		}
+
+		fs::rename(tmpName, fileName, ec);
+		if (ec)
+		{
+			fs::remove(tmpName, ec);
+			return false;
+		}
+
+		pipelineCacheChecksum = checksum;
+
+		return true;
+	}
+
+	void VkContext::destroyPipelineCache()
+	{
+		if (pipelineCache == VK_NULL_HANDLE)
+			return;
+
+		savePipelineCache();
+
+		vkDestroyPipelineCache(logicalDevice, pipelineCache, nullptr);
+		pipelineCache = VK_NULL_HANDLE;
 	}
 
 	/**
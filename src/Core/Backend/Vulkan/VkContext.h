@@ -7,12 +7,15 @@
 #include <assert.h>
 #include <exception>
 #include <map>
+#include <string>
 
 VK_DEFINE_HANDLE(VmaAllocator)
 VK_DEFINE_HANDLE(VmaPool)
 
 namespace dyno {
 
+	class VkStagingRing;
+
 	class VkContext
 	{
 	public:
@@ -21,8 +24,26 @@ namespace dyno {
 
 		VkResult createLogicalDevice(VkPhysicalDeviceFeatures enabledFeatures, std::vector<const char *> enabledExtensions, void *pNextChain, bool useSwapChain = true, VkQueueFlags requestedQueueTypes = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
 
+		/**
+		 * @brief Create the pipeline cache, initialized from the cache file of this device if there is a valid one
+		 */
 		void createPipelineCache();
 
+		/**
+		 * @brief Serialize the pipeline cache to the cache file of this device
+		 */
+		bool savePipelineCache();
+
+		/**
+		 * @brief Save and destroy the pipeline cache
+		 */
+		void destroyPipelineCache();
+
+		/**
+		 * @brief Cache file of the current device, empty if the cache is not persisted
+		 */
+		std::string pipelineCacheFile();
+
 		inline	VkDevice		deviceHandle() { return logicalDevice; }
 		inline	VkQueue			graphicsQueueHandle() { return graphicsQueue; }
 		inline	VkQueue			computeQueueHandle() { return computeQueue; }
@@ -32,6 +53,9 @@ namespace dyno {
 
 		inline  VkPipelineCache	pipelineCacheHandle() { return pipelineCache; }
 
+		// Persistently mapped staging buffer shared by all transfers between host and device, created on first use
+		VkStagingRing*	stagingRing();
+
 		// Check whether the compute queue family is distinct from the graphics queue family
 		bool isComputeQueueSpecial();
 
@@ -78,7 +102,16 @@ namespace dyno {
 		/** @brief Contains queue family indices */
 
 		// Pipeline cache object
-		VkPipelineCache pipelineCache;
+		VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+		// Checksum of the data last read from or written to the cache file, an unchanged cache is not saved again
+		uint64_t pipelineCacheChecksum = 0;
+
+		// Directory the pipeline cache is persisted to, the cache is not persisted if empty
+		std::string pipelineCacheDirectory;
+
+		// Whether compute pipelines are built on a background thread while the scene is being set up
+		bool usePipelinePrewarm = false;
 
 		struct
 		{
@@ -108,5 +141,8 @@ namespace dyno {
 		std::map<VkFlags, MemoryPoolInfo> poolMap;
 		VmaAllocator g_Allocator;
 		bool useMemoryPool = false;
+
+	private:
+		VkStagingRing* mStagingRing = nullptr;
 	};
 }
\ No newline at end of file
@@ -21,7 +21,7 @@ namespace dyno {
 		{
 			m_num = num;
 
-			buffer->destroy();
+			this->releaseBuffer();
 
 			if (num > 0)
 			{
@@ -61,7 +61,7 @@ namespace dyno {
 	void VkDeviceArray<T>::clear()
 	{
 		m_num = 0;
-		buffer->destroy();
+		this->releaseBuffer();
 	}
 
 	template<typename T>
@@ -14,7 +14,7 @@ namespace dyno {
 	template<typename T>
 	void VkDeviceArray2D<T>::resize(uint32_t nx, uint32_t ny, VkBufferUsageFlags usageFlags)
 	{
-		buffer->destroy();
+		this->releaseBuffer();
 
 		m_nx = nx;
 		m_ny = ny;
@@ -53,7 +53,7 @@ namespace dyno {
 		m_num = 0;
 		m_nx = 0;
 		m_ny = 0;
-		buffer->destroy();
+		this->releaseBuffer();
 	}
 
 	template<typename T>
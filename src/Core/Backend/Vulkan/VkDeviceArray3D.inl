@@ -14,7 +14,7 @@ namespace dyno {
 	template<typename T>
 	void VkDeviceArray3D<T>::resize(uint32_t nx, uint32_t ny, uint32_t nz, VkBufferUsageFlags usageFlags)
 	{
-		buffer->destroy();
+		this->releaseBuffer();
 
 		m_nx = nx;
 		m_ny = ny;
@@ -59,7 +59,7 @@ namespace dyno {
 		m_ny = 0;
 		m_nz = 0;
 		m_num = 0;
-		buffer->destroy();
+		this->releaseBuffer();
 	}
 
 	template<typename T>
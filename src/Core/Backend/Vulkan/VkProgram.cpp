@@ -7,6 +7,8 @@ namespace dyno
 {
 	VkProgram::~VkProgram()
 	{
+		this->waitForPipeline();
+
 		mAllArgs.clear();
 		mBufferArgs.clear();
 		mUniformArgs.clear();
@@ -38,6 +40,8 @@ namespace dyno
 
 	void VkProgram::dispatch(dim3 groupSize)
 	{
+		this->waitForPipeline();
+
 		vkCmdBindDescriptorSets(mCommandBuffers, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, 0);
 		uint32_t offset = 0;
 		for (size_t i = 0; i < mAllArgs.size(); i++)
@@ -62,6 +66,11 @@ namespace dyno
 
 	void VkProgram::update(bool sync)
 	{
+		// Dispatches recorded into a batch before this one have to be executed first
+		VkCommandBatch* batch = VkCommandBatch::current();
+		if (batch != nullptr && batch->hasCommands())
+			batch->submit();
+
 		vkResetFences(ctx->deviceHandle(), 1, &mFence);
 
 		static bool firstDraw = true;
@@ -184,6 +193,8 @@ namespace dyno
 
 	void VkProgram::bindPipeline()
 	{
+		this->waitForPipeline();
+
 		vkCmdBindPipeline(mCommandBuffers, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 	}
 
@@ -200,6 +211,8 @@ namespace dyno
 
 	bool VkProgram::load(std::string fileName)
 	{
+		this->waitForPipeline();
+
 		//Create pipeline layout
 		std::vector<VkPushConstantRange> pushConstantRanges;
 		for (size_t i = 0; i < mFormalConstants.size(); i++)
@@ -215,13 +228,30 @@ namespace dyno
 		VK_CHECK_RESULT(vkCreatePipelineLayout(ctx->deviceHandle(), &pipelineLayoutCreateInfo, nullptr, &pipelineLayout));
 
 		// Create pipeline
-		VkComputePipelineCreateInfo computePipelineCreateInfo = vks::initializers::computePipelineCreateInfo(pipelineLayout, 0);
-		computePipelineCreateInfo.stage = this->createComputeStage(fileName);
-		VK_CHECK_RESULT(vkCreateComputePipelines(ctx->deviceHandle(), ctx->pipelineCacheHandle(), 1, &computePipelineCreateInfo, nullptr, &pipeline));
+		auto build = [this, fileName]() {
+			VkComputePipelineCreateInfo computePipelineCreateInfo = vks::initializers::computePipelineCreateInfo(pipelineLayout, 0);
+			computePipelineCreateInfo.stage = this->createComputeStage(fileName);
+			VK_CHECK_RESULT(vkCreateComputePipelines(ctx->deviceHandle(), ctx->pipelineCacheHandle(), 1, &computePipelineCreateInfo, nullptr, &pipeline));
+		};
+
+		// Building pipelines is thread safe with respect to the shared pipeline cache, the pipeline is waited for on first use
+		if (ctx->usePipelinePrewarm) {
+			mPipelineBuild = std::async(std::launch::async, build);
+		}
+		else {
+			build();
+		}
 
 		return true;
 	}
 
+	void VkProgram::waitForPipeline()
+	{
+		if (mPipelineBuild.valid()) {
+			mPipelineBuild.get();
+		}
+	}
+
 	VkPipelineShaderStageCreateInfo VkProgram::createComputeStage(std::string fileName)
 	{
 		VkPipelineShaderStageCreateInfo shaderStage = {};
@@ -322,16 +352,29 @@ namespace dyno
 		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
 		cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 
-		VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffers, &cmdBufInfo));
+		VkCommandBatch* batch = VkCommandBatch::current();
+		mBatched = batch != nullptr;
+
+		VkCommandBuffer cmdBuffer = commandBuffers;
+		if (mBatched) {
+			cmdBuffer = batch->commandBuffer();
+		}
+		else {
+			VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffers, &cmdBufInfo));
+		}
 
 		for (auto &pgm : mPrograms) {
-			pgm.second->suspendInherentCmdBuffer(commandBuffers);
+			pgm.second->suspendInherentCmdBuffer(cmdBuffer);
 		}
 		//vkCmdBindPipeline(commandBuffers, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 	}
 
 	void VkMultiProgram::update(bool sync)
 	{
+		// Submitted together with the batch
+		if (mBatched)
+			return;
+
 		vkResetFences(ctx->deviceHandle(), 1, &mFence);
 
 		//		static bool firstDraw = true;
@@ -367,11 +410,15 @@ namespace dyno
 		}
 
 		// release the storage buffers back to the graphics queue
-		vkEndCommandBuffer(commandBuffers);
+		if (!mBatched)
+			vkEndCommandBuffer(commandBuffers);
 	}
 
 	void VkMultiProgram::wait()
 	{
+		if (mBatched)
+			return;
+
 		VK_CHECK_RESULT(vkWaitForFences(ctx->deviceHandle(), 1, &mFence, VK_TRUE, UINT64_MAX));
 	}
 }
\ No newline at end of file
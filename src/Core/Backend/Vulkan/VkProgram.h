@@ -6,8 +6,10 @@
 #include "VkDeviceArray3D.h"
 #include "VkUniform.h"
 #include "VkConstant.h"
+#include "VkCommandBatch.h"
 #include <memory>
 #include <map>
+#include <future>
 
 namespace dyno {
 
@@ -131,6 +133,15 @@ namespace dyno {
 
 		template<typename... Args>
 		void flush(dim3 groupSize, Args... args) {
+			// Only record the dispatch if a batch is recording, it is submitted together with the whole batch
+			VkCommandBatch* batch = VkCommandBatch::current();
+			if (batch != nullptr) {
+				this->suspendInherentCmdBuffer(batch->commandBuffer());
+				this->enqueue(groupSize, args...);
+				this->restoreInherentCmdBuffer();
+				return;
+			}
+
 			this->begin();
 			this->enqueue(groupSize, args...);
 			this->end();
@@ -172,6 +183,9 @@ namespace dyno {
 	private:
 		VkPipelineShaderStageCreateInfo createComputeStage(std::string fileName);
 
+		// Block until the pipeline built on a background thread is ready
+		void waitForPipeline();
+
 		VkContext* ctx = nullptr;
 
 		std::vector<VkVariable*> mFormalParamters;
@@ -196,6 +210,9 @@ namespace dyno {
 
 		VkCommandBuffer mCmdBufferCopy = VK_NULL_HANDLE;
 		std::vector<VkShaderModule> shaderModules;
+
+		// Pending pipeline build if pipelines are pre-warmed
+		std::future<void> mPipelineBuild;
 	};
 
 	template<typename... Args>
@@ -323,21 +340,35 @@ namespace dyno {
 			}
 		}
 
+		// A batch may record several dispatches of this program, each of which requires its own descriptor set
+		VkCommandBatch* batch = VkCommandBatch::current();
+		bool batched = batch != nullptr && batch->commandBuffer() == mCommandBuffers;
+		VkDescriptorSet dstSet = batched ? batch->allocateDescriptorSet(descriptorSetLayout) : descriptorSet;
+
 		//Create descriptor set layout
 		std::vector<VkWriteDescriptorSet> writeDescriptorSets;
+		std::vector<VkDescriptorBufferInfo> uniformInfos;
+		uniformInfos.reserve(variables.size());
 		for (size_t i = 0; i < variables.size(); i++)
 		{
 			auto variable = *(variables.begin() + i);
 			if ((mAllArgs[i]->type() == VariableType::DeviceBuffer && mAllArgs[i]->bufferSize() > 0) || mAllArgs[i]->type() == VariableType::Uniform) {
+				VkDescriptorBufferInfo* info = &variable->getDescriptor();
+				if (batched && variable->type() == VariableType::Uniform) {
+					uniformInfos.push_back(batch->stageUniform(variable->data(), variable->bufferSize()));
+					info = &uniformInfos.back();
+				}
+
 				writeDescriptorSets.push_back(
-					vks::initializers::writeDescriptorSet(descriptorSet, VkVariable::descriptorType(variable->type()), i, &variable->getDescriptor()));
+					vks::initializers::writeDescriptorSet(dstSet, VkVariable::descriptorType(variable->type()), i, info));
 			}
 		}
 
 		vkUpdateDescriptorSets(ctx->deviceHandle(), static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, NULL);
-		vkCmdBindDescriptorSets(mCommandBuffers, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, 0);
+		vkCmdBindDescriptorSets(mCommandBuffers, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &dstSet, 0, 0);
 		writeDescriptorSets.clear();
 		
+		this->waitForPipeline();
 		vkCmdBindPipeline(mCommandBuffers, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 
 		uint32_t offset = 0;
@@ -350,9 +381,14 @@ namespace dyno {
 			}
 		}
 
-		vkCmdDispatch(mCommandBuffers, groupSize.x, groupSize.y, groupSize.z);
-
-		addComputeToComputeBarriers(mCommandBuffers);
+		if (batched) {
+			batch->addDispatchBarrier(mBufferArgs);
+			vkCmdDispatch(mCommandBuffers, groupSize.x, groupSize.y, groupSize.z);
+		}
+		else {
+			vkCmdDispatch(mCommandBuffers, groupSize.x, groupSize.y, groupSize.z);
+			addComputeToComputeBarriers(mCommandBuffers);
+		}
 	}
 
 	template<typename... Args>
@@ -442,5 +478,8 @@ namespace dyno {
 		VkQueue queue = VK_NULL_HANDLE;
 		VkCommandPool commandPool = VK_NULL_HANDLE;
 		VkCommandBuffer commandBuffers = VK_NULL_HANDLE;
+
+		// Whether the programs are recorded into a VkCommandBatch between begin() and end()
+		bool mBatched = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,443 @@
+#include "VkStagingRing.h"
+#include "VkCommandBatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dyno {
+
+	VkStagingRing::VkStagingRing(VkContext* ctx, VkDeviceSize capacity)
+	{
+		assert(ctx != nullptr);
+		this->ctx = ctx;
+
+		mQueue = ctx->graphicsQueueHandle();
+		mCommandPool = ctx->createCommandPool(ctx->queueFamilyIndices.graphics,
+			VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+		mAlignment = std::max<VkDeviceSize>(mAlignment, ctx->properties.limits.nonCoherentAtomSize);
+		mAlignment = std::max<VkDeviceSize>(mAlignment, ctx->properties.limits.optimalBufferCopyOffsetAlignment);
+		mCapacity = (capacity + mAlignment - 1) / mAlignment * mAlignment;
+
+		// Prefer cached memory, reading back from uncached memory is very slow on most hosts
+		VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		VkBool32 cachedFound = VK_FALSE;
+		ctx->getMemoryType(~0u, flags | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, &cachedFound);
+		if (cachedFound)
+			flags |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+		mBuffer = std::make_shared<vks::Buffer>();
+		ctx->createBuffer(
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			flags,
+			mBuffer,
+			mCapacity);
+
+		VK_CHECK_RESULT(mBuffer->map());
+		mMapped = (uint8_t*)mBuffer->mapped;
+	}
+
+	VkStagingRing::~VkStagingRing()
+	{
+		flush();
+
+		VkDevice device = ctx->deviceHandle();
+		for (auto& batch : mFree)
+		{
+			vkDestroyFence(device, batch.fence, nullptr);
+		}
+		mFree.clear();
+
+		if (mOpen.fence != VK_NULL_HANDLE)
+			vkDestroyFence(device, mOpen.fence, nullptr);
+
+		vkDestroyCommandPool(device, mCommandPool, nullptr);
+
+		mBuffer->unmap();
+		mBuffer->destroy();
+		mMapped = nullptr;
+	}
+
+	uint64_t VkStagingRing::upload(VkBuffer dst, VkDeviceSize dstOffset, const void* src, VkDeviceSize size)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// Large transfers are split so that a single chunk never occupies more than half of the ring
+		const VkDeviceSize chunk = mCapacity / 2;
+		const uint8_t* data = (const uint8_t*)src;
+
+		VkDeviceSize copied = 0;
+		while (copied < size)
+		{
+			VkDeviceSize n = std::min(chunk, size - copied);
+
+			VkBuffer staging = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			uint8_t* mapped = allocate(n, staging, offset);
+
+			memcpy(mapped, data + copied, n);
+
+			resolveHazard(VK_NULL_HANDLE, dst);
+
+			VkBufferCopy region = {};
+			region.srcOffset = offset;
+			region.dstOffset = dstOffset + copied;
+			region.size = n;
+			vkCmdCopyBuffer(mOpen.cmd, staging, dst, 1, &region);
+
+			copied += n;
+		}
+
+		return mSubmitted + 1;
+	}
+
+	uint64_t VkStagingRing::download(void* dst, VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize size)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		const VkDeviceSize chunk = mCapacity / 2;
+		uint8_t* data = (uint8_t*)dst;
+
+		VkDeviceSize copied = 0;
+		while (copied < size)
+		{
+			VkDeviceSize n = std::min(chunk, size - copied);
+
+			VkBuffer staging = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			uint8_t* mapped = allocate(n, staging, offset);
+
+			resolveHazard(src, VK_NULL_HANDLE);
+
+			VkBufferCopy region = {};
+			region.srcOffset = srcOffset + copied;
+			region.dstOffset = offset;
+			region.size = n;
+			vkCmdCopyBuffer(mOpen.cmd, src, staging, 1, &region);
+
+			mOpen.readbacks.push_back(Readback{ data + copied, mapped, n });
+
+			copied += n;
+		}
+
+		return mSubmitted + 1;
+	}
+
+	uint64_t VkStagingRing::copy(VkBuffer dst, VkDeviceSize dstOffset, VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize size)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (size > 0)
+		{
+			if (!mRecording)
+				beginBatch();
+
+			resolveHazard(src, dst);
+
+			VkBufferCopy region = {};
+			region.srcOffset = srcOffset;
+			region.dstOffset = dstOffset;
+			region.size = size;
+			vkCmdCopyBuffer(mOpen.cmd, src, dst, 1, &region);
+		}
+
+		return mSubmitted + 1;
+	}
+
+	uint64_t VkStagingRing::submit()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		return submitBatch();
+	}
+
+	bool VkStagingRing::isComplete(uint64_t ticket)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		retireCompleted(ticket, false);
+
+		return mRetired >= ticket;
+	}
+
+	void VkStagingRing::wait(uint64_t ticket)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (ticket > mSubmitted && mRecording)
+			submitBatch();
+
+		retireCompleted(ticket, true);
+	}
+
+	void VkStagingRing::flush()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		uint64_t ticket = submitBatch();
+		retireCompleted(ticket, true);
+	}
+
+	void VkStagingRing::beginBatch()
+	{
+		if (mFree.empty())
+		{
+			Batch batch;
+			batch.cmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, mCommandPool, false);
+
+			VkFenceCreateInfo fenceInfo = vks::initializers::fenceCreateInfo(VK_FLAGS_NONE);
+			VK_CHECK_RESULT(vkCreateFence(ctx->deviceHandle(), &fenceInfo, nullptr, &batch.fence));
+
+			mOpen = batch;
+		}
+		else
+		{
+			mOpen = mFree.back();
+			mFree.pop_back();
+		}
+
+		mOpen.ticket = mSubmitted + 1;
+		mOpen.end = mHead;
+		mOpen.bytes = 0;
+		mOpen.readbacks.clear();
+		mOpen.written.clear();
+		mOpen.dedicated.clear();
+
+		VkCommandBufferBeginInfo beginInfo = vks::initializers::commandBufferBeginInfo();
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT(vkBeginCommandBuffer(mOpen.cmd, &beginInfo));
+
+		// Make writes of previously submitted work visible to the copies and avoid overwriting buffers still being read
+		VkMemoryBarrier barrier = vks::initializers::memoryBarrier();
+		barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(
+			mOpen.cmd,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_FLAGS_NONE,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr);
+
+		mRecording = true;
+	}
+
+	void VkStagingRing::resolveHazard(VkBuffer src, VkBuffer dst)
+	{
+		auto& written = mOpen.written;
+		bool hazard = (src != VK_NULL_HANDLE && std::find(written.begin(), written.end(), src) != written.end())
+			|| (dst != VK_NULL_HANDLE && std::find(written.begin(), written.end(), dst) != written.end());
+
+		if (hazard)
+		{
+			VkMemoryBarrier barrier = vks::initializers::memoryBarrier();
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+			vkCmdPipelineBarrier(
+				mOpen.cmd,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_FLAGS_NONE,
+				1, &barrier,
+				0, nullptr,
+				0, nullptr);
+
+			written.clear();
+		}
+
+		if (dst != VK_NULL_HANDLE)
+			written.push_back(dst);
+	}
+
+	uint64_t VkStagingRing::submitBatch()
+	{
+		if (!mRecording)
+			return mSubmitted;
+
+		// Dispatches recorded before the transfers have to be executed first
+		VkCommandBatch* batch = VkCommandBatch::current();
+		if (batch != nullptr && batch->hasCommands())
+		{
+			batch->submit();
+
+			if (ctx->isComputeQueueSpecial())
+				batch->wait();
+		}
+
+		// Make the copies visible to subsequent commands and to the host
+		VkMemoryBarrier barrier = vks::initializers::memoryBarrier();
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(
+			mOpen.cmd,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+			VK_FLAGS_NONE,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr);
+
+		VK_CHECK_RESULT(vkEndCommandBuffer(mOpen.cmd));
+
+		VkSubmitInfo submitInfo = vks::initializers::submitInfo();
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &mOpen.cmd;
+		VK_CHECK_RESULT(vkQueueSubmit(mQueue, 1, &submitInfo, mOpen.fence));
+
+		mSubmitted = mOpen.ticket;
+		mInFlight.push_back(mOpen);
+
+		mOpen = Batch();
+		mRecording = false;
+
+		// Without a shared queue, compute dispatches are not ordered after the copies
+		if (ctx->isComputeQueueSpecial())
+			retireCompleted(mSubmitted, true);
+
+		return mSubmitted;
+	}
+
+	bool VkStagingRing::tryAllocate(VkDeviceSize size, VkDeviceSize& offset)
+	{
+		VkDeviceSize aligned = (size + mAlignment - 1) / mAlignment * mAlignment;
+
+		if (mUsed == 0)
+		{
+			mHead = 0;
+			mTail = 0;
+			mOpen.end = 0;
+		}
+		else if (mHead == mTail)
+		{
+			return false;
+		}
+
+		VkDeviceSize padding = 0;
+		if (mHead >= mTail)
+		{
+			if (mHead + aligned <= mCapacity)
+			{
+				offset = mHead;
+			}
+			else if (aligned <= mTail)
+			{
+				padding = mCapacity - mHead;
+				offset = 0;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if (mHead + aligned <= mTail)
+				offset = mHead;
+			else
+				return false;
+		}
+
+		mHead = offset + aligned;
+		mUsed += padding + aligned;
+
+		mOpen.bytes += padding + aligned;
+		mOpen.end = mHead;
+
+		return true;
+	}
+
+	uint8_t* VkStagingRing::allocate(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset)
+	{
+		if (!mRecording)
+			beginBatch();
+
+		while (!tryAllocate(size, offset))
+		{
+			// Submit what has been recorded so far and try again, with a dedicated compute queue this already retires all batches
+			if (mOpen.bytes > 0)
+			{
+				submitBatch();
+				beginBatch();
+				continue;
+			}
+
+			// The ring is empty and still too small
+			if (mInFlight.empty())
+				return allocateDedicated(size, buffer, offset);
+
+			retireOldest();
+		}
+
+		buffer = mBuffer->buffer;
+		return mMapped + offset;
+	}
+
+	uint8_t* VkStagingRing::allocateDedicated(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset)
+	{
+		auto staging = std::make_shared<vks::Buffer>();
+		ctx->createBuffer(
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			staging,
+			size);
+
+		VK_CHECK_RESULT(staging->map());
+		mOpen.dedicated.push_back(staging);
+
+		buffer = staging->buffer;
+		offset = 0;
+		return (uint8_t*)staging->mapped;
+	}
+
+	void VkStagingRing::retireOldest()
+	{
+		Batch batch = mInFlight.front();
+		mInFlight.pop_front();
+
+		VK_CHECK_RESULT(vkWaitForFences(ctx->deviceHandle(), 1, &batch.fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
+
+		for (auto& rb : batch.readbacks)
+		{
+			memcpy(rb.dst, rb.src, rb.size);
+		}
+
+		for (auto& staging : batch.dedicated)
+		{
+			staging->unmap();
+			staging->destroy();
+		}
+
+		mUsed -= batch.bytes;
+		mTail = batch.end;
+		mRetired = batch.ticket;
+
+		VK_CHECK_RESULT(vkResetFences(ctx->deviceHandle(), 1, &batch.fence));
+		VK_CHECK_RESULT(vkResetCommandBuffer(batch.cmd, 0));
+
+		batch.readbacks.clear();
+		batch.written.clear();
+		batch.dedicated.clear();
+		mFree.push_back(batch);
+	}
+
+	void VkStagingRing::retireCompleted(uint64_t ticket, bool block)
+	{
+		while (!mInFlight.empty())
+		{
+			Batch& oldest = mInFlight.front();
+
+			if (block)
+			{
+				if (oldest.ticket > ticket)
+					break;
+			}
+			else if (vkGetFenceStatus(ctx->deviceHandle(), oldest.fence) != VK_SUCCESS)
+			{
+				break;
+			}
+
+			retireOldest();
+		}
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "VkContext.h"
+
+#include <deque>
+#include <mutex>
+
+namespace dyno {
+
+	/*!
+	*	\class	VkStagingRing
+	*	\brief	A persistently mapped host visible buffer used to stage all transfers between host and device.
+	*
+	*	Transfers are suballocated from the ring and recorded into a shared command buffer, which is submitted
+	*	as one batch. Each submitted batch is tracked by a fence and identified by a monotonically increasing ticket,
+	*	its part of the ring is recycled once the fence is signaled.
+	*/
+	class VkStagingRing
+	{
+	public:
+		explicit VkStagingRing(VkContext* ctx, VkDeviceSize capacity = 32 * 1024 * 1024);
+		~VkStagingRing();
+
+		/**
+		 * @brief Copy size bytes from src into the ring and record a copy into dst
+		 *
+		 * @return ticket of the batch the copy belongs to
+		 */
+		uint64_t upload(VkBuffer dst, VkDeviceSize dstOffset, const void* src, VkDeviceSize size);
+
+		/**
+		 * @brief Record a copy from src into the ring, dst is written once the batch is waited for.
+		 *	dst must stay valid until then.
+		 *
+		 * @return ticket of the batch the copy belongs to
+		 */
+		uint64_t download(void* dst, VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize size);
+
+		/**
+		 * @brief Record a copy between two device buffers
+		 *
+		 * @return ticket of the batch the copy belongs to
+		 */
+		uint64_t copy(VkBuffer dst, VkDeviceSize dstOffset, VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize size);
+
+		/**
+		 * @brief Submit all recorded copies without waiting
+		 *
+		 * @return ticket of the submitted batch
+		 */
+		uint64_t submit();
+
+		/**
+		 * @brief Check without blocking whether the batch of a ticket has finished executing
+		 */
+		bool isComplete(uint64_t ticket);
+
+		/**
+		 * @brief Block until the batch of a ticket has finished executing, the batch is submitted first if required
+		 */
+		void wait(uint64_t ticket);
+
+		/**
+		 * @brief Submit all recorded copies and wait for all of them
+		 */
+		void flush();
+
+		VkDeviceSize capacity() { return mCapacity; }
+
+	private:
+		struct Readback
+		{
+			void* dst;
+			const uint8_t* src;
+			VkDeviceSize size;
+		};
+
+		struct Batch
+		{
+			uint64_t ticket = 0;
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+
+			//Ring offset one past the last byte used by the batch
+			VkDeviceSize end = 0;
+			//Ring bytes used by the batch, including padding skipped at wraparound
+			VkDeviceSize bytes = 0;
+
+			std::vector<Readback> readbacks;
+
+			//Device buffers written since the last transfer barrier
+			std::vector<VkBuffer> written;
+
+			//Staging buffers of transfers that do not fit into the ring, released once the batch is retired
+			std::vector<std::shared_ptr<vks::Buffer>> dedicated;
+		};
+
+		void beginBatch();
+		void resolveHazard(VkBuffer src, VkBuffer dst);
+		uint64_t submitBatch();
+
+		bool tryAllocate(VkDeviceSize size, VkDeviceSize& offset);
+		uint8_t* allocate(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset);
+		uint8_t* allocateDedicated(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset);
+
+		void retireOldest();
+		void retireCompleted(uint64_t ticket, bool block);
+
+		VkContext* ctx = nullptr;
+
+		VkQueue mQueue = VK_NULL_HANDLE;
+		VkCommandPool mCommandPool = VK_NULL_HANDLE;
+
+		std::shared_ptr<vks::Buffer> mBuffer;
+		uint8_t* mMapped = nullptr;
+
+		VkDeviceSize mCapacity = 0;
+		VkDeviceSize mAlignment = 16;
+
+		VkDeviceSize mHead = 0;
+		VkDeviceSize mTail = 0;
+		VkDeviceSize mUsed = 0;
+
+		bool mRecording = false;
+		Batch mOpen;
+
+		std::deque<Batch> mInFlight;
+		std::vector<Batch> mFree;
+
+		uint64_t mSubmitted = 0;
+		uint64_t mRetired = 0;
+
+		std::mutex mMutex;
+	};
+}
@@ -3,6 +3,7 @@
 #include "VulkanDebug.h"
 #include "VkContext.h"
 
+#include <ghc/fs_std.hpp>
 #include <iostream>
 
 namespace dyno {
@@ -123,6 +124,17 @@ namespace dyno {
 		// This is handled by a separate class that gets a logical device representation
 		// and encapsulates functions related to a device
 		ctx = new VkContext(physicalDevice);
+
+		if (!pipelineCacheDirSet) {
+			std::error_code ec;
+			auto tmpDir = fs::temp_directory_path(ec);
+			if (!ec) {
+				pipelineCacheDir = (tmpDir / "peridyno").string();
+			}
+		}
+		ctx->pipelineCacheDirectory = pipelineCacheDir;
+		ctx->usePipelinePrewarm = usePipelinePrewarm;
+
 		VkResult res = ctx->createLogicalDevice(enabledFeatures, enabledDeviceExtensions, deviceCreatepNextChain);
 		if (res != VK_SUCCESS) {
 			vks::tools::exitFatal("Could not create Vulkan device: \n" + vks::tools::errorString(res), res);
@@ -30,6 +30,22 @@ namespace dyno
 			useMemoryPool = enableMemPool;
 		}
 
+		/*!
+		 *	\brief	Persist the pipeline cache to dir, should be called before initialize(). An empty dir disables persistence.
+		 *		Defaults to a peridyno folder in the temporary directory of the system.
+		 */
+		void setPipelineCacheDirectory(std::string dir) {
+			pipelineCacheDir = dir;
+			pipelineCacheDirSet = true;
+		}
+
+		/*!
+		 *	\brief	Build compute pipelines on a background thread once programs are loaded, should be called before initialize().
+		 */
+		void enablePipelinePrewarm(bool enablePrewarm = true) {
+			usePipelinePrewarm = enablePrewarm;
+		}
+
 		VkPhysicalDeviceProperties getDeviceProperties() {
 			return deviceProperties;
 		}
@@ -54,6 +70,9 @@ namespace dyno
 
 		bool validation;
 		bool useMemoryPool = true;
+		bool usePipelinePrewarm = false;
+		bool pipelineCacheDirSet = false;
+		std::string pipelineCacheDir;
 		std::string name = "Vulkan";
 		uint32_t apiVersion = VK_API_VERSION_1_2;
 
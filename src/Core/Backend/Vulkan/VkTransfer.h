@@ -43,8 +43,29 @@ namespace dyno
 	template<typename T>
 	bool vkTransfer(VkDeviceArray3D<T>& dst, const VkDeviceArray3D<T>& src);
 
+	/**
+	 * Asynchronous transfers, the copies are recorded into the staging ring of the current context and
+	 * submitted together as one batch. Host data is staged immediately, but the device arrays and the destination
+	 * vectors must stay alive until vkTransferWait() is called with the returned ticket.
+	 */
+	template<typename T>
+	uint64_t vkTransferAsync(VkDeviceArray<T>& dst, const std::vector<T>& src);
+
+	template<typename T>
+	uint64_t vkTransferAsync(std::vector<T>& dst, const VkDeviceArray<T>& src);
+
+	template<typename T>
+	uint64_t vkTransferAsync(VkDeviceArray<T>& dst, uint64_t dstOffset, const VkDeviceArray<T>& src, uint64_t srcOffset, uint64_t copySize);
 
+	/**
+	 * Submit all recorded asynchronous transfers without waiting
+	 */
+	inline uint64_t vkTransferSubmit();
 
+	/**
+	 * Block until the batch identified by ticket has finished, it is submitted first if still being recorded
+	 */
+	inline void vkTransferWait(uint64_t ticket);
 }
 
 #include "VkTransfer.inl"
\ No newline at end of file
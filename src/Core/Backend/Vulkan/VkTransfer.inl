@@ -1,5 +1,7 @@
 #include <assert.h>
 #include "VkContext.h"
+#include "VkStagingRing.h"
+#include "VkSystem.h"
 
 namespace dyno
 {
@@ -12,32 +14,9 @@ namespace dyno
 		assert(dst.currentContext() == src.currentContext());
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-/*		VkBufferMemoryBarrier bufferBarrier = vks::initializers::bufferMemoryBarrier();
-		bufferBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-		bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-		bufferBarrier.srcQueueFamilyIndex = ctx->queueFamilyIndices.compute;
-		bufferBarrier.dstQueueFamilyIndex = ctx->queueFamilyIndices.graphics;
-		bufferBarrier.size = VK_WHOLE_SIZE;
-		bufferBarrier.buffer = dst.bufferHandle();
-		std::vector<VkBufferMemoryBarrier> bufferBarriers;
-		bufferBarriers.push_back(bufferBarrier);
-
-		vkCmdPipelineBarrier(
-			copyCmd,
-			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			VK_FLAGS_NONE,
-			0, nullptr,
-			static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
-			0, nullptr);*/
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -51,44 +30,13 @@ namespace dyno
 		assert(dst.currentContext() == src.currentContext());
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		/*		VkBufferMemoryBarrier bufferBarrier = vks::initializers::bufferMemoryBarrier();
-				bufferBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-				bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-				bufferBarrier.srcQueueFamilyIndex = ctx->queueFamilyIndices.compute;
-				bufferBarrier.dstQueueFamilyIndex = ctx->queueFamilyIndices.graphics;
-				bufferBarrier.size = VK_WHOLE_SIZE;
-				bufferBarrier.buffer = dst.bufferHandle();
-				std::vector<VkBufferMemoryBarrier> bufferBarriers;
-				bufferBarriers.push_back(bufferBarrier);
-
-				vkCmdPipelineBarrier(
-					copyCmd,
-					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-					VK_FLAGS_NONE,
-					0, nullptr,
-					static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
-					0, nullptr);*/
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
 
-// 	VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
-// 	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-// 	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-// 	barrier.buffer = pair.dst;
-// 	barrier.size = pair.src.m_size;
-// 	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, 0, 1, &barrier, 0, 0);
-
-
 	template<typename T>
 	bool vkTransfer(VkDeviceArray<T>& dst, const VkHostArray<T>& src)
 	{
@@ -98,13 +46,9 @@ namespace dyno
 		assert(dst.currentContext() == src.currentContext());
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size()*sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -117,14 +61,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		VkHostArray<T> vkHostSrc;
-		vkHostSrc.resize(src.size());
-
-		vkTransfer(vkHostSrc, src);
-
-		memcpy(dst.data(), vkHostSrc.mapped(), sizeof(T)*src.size());
-
-		vkHostSrc.clear();
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->download(dst.data(), src.bufferHandle(), 0, sizeof(T) * src.size());
+		ring->flush();
 
 		return true;
 	}
@@ -137,18 +76,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		VkHostArray<T> vkHostSrc;
-		vkHostSrc.resize(src.size(), src.data());
-
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, vkHostSrc.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
-
-		vkHostSrc.clear();
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->upload(dst.bufferHandle(), 0, src.data(), sizeof(T) * dst.size());
+		ring->flush();
 
 		return true;
 	}
@@ -163,13 +93,9 @@ namespace dyno
 		assert(dst.currentContext() == src.currentContext());
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -187,15 +113,9 @@ namespace dyno
 		assert(dst.size() >= dstOffset + copySize);
 		assert(src.size() >= srcOffset + copySize);
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.dstOffset = dstOffset * sizeof(T);
-		copyRegion.srcOffset = srcOffset * sizeof(T);
-		copyRegion.size = src.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), dstOffset * sizeof(T), src.bufferHandle(), srcOffset * sizeof(T), copySize * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -208,14 +128,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		VkHostArray<T> vkHostSrc;
-		vkHostSrc.resize(src.size());
-
-		vkTransfer(vkHostSrc, src);
-
-		memcpy(dst.data(), vkHostSrc.mapped(), sizeof(T)*src.size());
-
-		vkHostSrc.clear();
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->download(dst.data(), src.bufferHandle(), 0, sizeof(T) * src.size());
+		ring->flush();
 
 		return true;
 	}
@@ -228,18 +143,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		VkHostArray<T> vkHostSrc;
-		vkHostSrc.resize(src.size(), src.data());
-
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, vkHostSrc.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
-
-		vkHostSrc.clear();
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->upload(dst.bufferHandle(), 0, src.data(), sizeof(T) * dst.size());
+		ring->flush();
 
 		return true;
 	}
@@ -252,13 +158,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -272,18 +174,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		VkHostArray<T> vkHostSrc;
-		vkHostSrc.resize(src.size(), src.data());
-
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, vkHostSrc.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
-
-		vkHostSrc.clear();
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->upload(dst.bufferHandle(), 0, src.data(), sizeof(T) * dst.size());
+		ring->flush();
 
 		return true;
 	}
@@ -296,13 +189,9 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -316,13 +205,9 @@ namespace dyno
 		assert(dst.currentContext() == src.currentContext());
 		assert(dst.size() == src.size());
 
-		// Copy from staging buffer
-		VkCommandBuffer copyCmd = ctx->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBufferCopy copyRegion = {};
-		copyRegion.size = dst.size() * sizeof(T);
-		vkCmdCopyBuffer(copyCmd, src.bufferHandle(), dst.bufferHandle(), 1, &copyRegion);
-
-		ctx->flushCommandBuffer(copyCmd, ctx->graphicsQueueHandle(), true);
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->copy(dst.bufferHandle(), 0, src.bufferHandle(), 0, dst.size() * sizeof(T));
+		ring->flush();
 
 		return true;
 	}
@@ -335,17 +220,55 @@ namespace dyno
 		assert(ctx != nullptr);
 		assert(dst.size() == src.size());
 
-		VkHostArray<T> vkHostSrc;
-		vkHostSrc.resize(src.size());
+		VkStagingRing* ring = ctx->stagingRing();
+		ring->download(dst.data(), src.bufferHandle(), 0, sizeof(T) * src.size());
+		ring->flush();
 
-		vkTransfer(vkHostSrc, src);
+		return true;
+	}
 
-		memcpy(dst.data(), vkHostSrc.mapped(), sizeof(T)*src.size());
+	template<typename T>
+	uint64_t vkTransferAsync(VkDeviceArray<T>& dst, const std::vector<T>& src)
+	{
+		VkContext* ctx = dst.currentContext();
 
-		vkHostSrc.clear();
+		assert(ctx != nullptr);
+		assert(dst.size() == src.size());
 
-		return true;
+		return ctx->stagingRing()->upload(dst.bufferHandle(), 0, src.data(), sizeof(T) * dst.size());
 	}
 
+	template<typename T>
+	uint64_t vkTransferAsync(std::vector<T>& dst, const VkDeviceArray<T>& src)
+	{
+		VkContext* ctx = src.currentContext();
+
+		assert(ctx != nullptr);
+		assert(dst.size() == src.size());
+
+		return ctx->stagingRing()->download(dst.data(), src.bufferHandle(), 0, sizeof(T) * src.size());
+	}
 
-}
\ No newline at end of file
+	template<typename T>
+	uint64_t vkTransferAsync(VkDeviceArray<T>& dst, uint64_t dstOffset, const VkDeviceArray<T>& src, uint64_t srcOffset, uint64_t copySize)
+	{
+		VkContext* ctx = src.currentContext();
+
+		assert(ctx != nullptr);
+		assert(dst.currentContext() == src.currentContext());
+		assert(dst.size() >= dstOffset + copySize);
+		assert(src.size() >= srcOffset + copySize);
+
+		return ctx->stagingRing()->copy(dst.bufferHandle(), dstOffset * sizeof(T), src.bufferHandle(), srcOffset * sizeof(T), copySize * sizeof(T));
+	}
+
+	inline uint64_t vkTransferSubmit()
+	{
+		return VkSystem::instance()->currentContext()->stagingRing()->submit();
+	}
+
+	inline void vkTransferWait(uint64_t ticket)
+	{
+		VkSystem::instance()->currentContext()->stagingRing()->wait(ticket);
+	}
+}
@@ -17,6 +17,8 @@ namespace dyno {
 
 		uint32_t bufferSize() override { return sizeof(T); }
 
+		void* data() const override { return buffer->mapped; }
+
 	protected:
 	};
 }
@@ -1,5 +1,6 @@
 #include "VkVariable.h"
 #include "VkSystem.h"
+#include "VkCommandBatch.h"
 
 namespace dyno {
 
@@ -15,6 +16,14 @@ namespace dyno {
 		// buffer.destroy();
 	}
 
+	void VkVariable::releaseBuffer()
+	{
+		if (!VkCommandBatch::deferRelease(buffer))
+		{
+			buffer->destroy();
+		}
+	}
+
 	VkDescriptorType VkVariable::descriptorType(const VariableType varType)
 	{
 		switch (varType)
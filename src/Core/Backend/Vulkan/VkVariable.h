@@ -45,6 +45,11 @@ namespace dyno {
 		virtual void* data() const { return nullptr; }
 
 	protected:
+		/**
+		 * @brief Destroy the buffer, or hand it over to the recording VkCommandBatch that may still use it
+		 */
+		void releaseBuffer();
+
 		VkContext* ctx = nullptr;
 
 		std::shared_ptr<vks::Buffer> buffer;
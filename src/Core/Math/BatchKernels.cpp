@@ -0,0 +1,899 @@
+#include "BatchKernels.h"
+
+#include <cfloat>
+#include <cmath>
+
+#if defined(PERIDYNO_NO_SIMD)
+#elif defined(__AVX512F__)
+#	define BATCH_AVX512
+#elif defined(__AVX2__)
+#	define BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define BATCH_SSE
+#endif
+
+#if defined(BATCH_AVX512) || defined(BATCH_AVX2) || defined(BATCH_SSE)
+#include <immintrin.h>
+#endif
+
+namespace dyno
+{
+	namespace kernel
+	{
+#if defined(BATCH_AVX512)
+		struct Tables
+		{
+			// x, y and z of 16 interleaved vectors, first picked from the first two registers, then merged with the third
+			int load1[3][16];
+			int load2[3][16];
+
+			// three output registers, first merged from x and y, then from z
+			int store1[3][16];
+			int store2[3][16];
+
+			int iota[16];
+
+			Tables()
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					for (int i = 0; i < 16; i++)
+					{
+						int f = 3 * i + k;
+						load1[k][i] = f < 32 ? f : 0;
+						load2[k][i] = f < 32 ? i : ((f - 32) | 16);
+					}
+				}
+
+				for (int b = 0; b < 3; b++)
+				{
+					for (int j = 0; j < 16; j++)
+					{
+						int f = 16 * b + j;
+						int c = f % 3;
+						int lane = f / 3;
+						store1[b][j] = c == 0 ? lane : (c == 1 ? (lane | 16) : 0);
+						store2[b][j] = c == 2 ? (lane | 16) : j;
+					}
+				}
+
+				for (int i = 0; i < 16; i++)
+					iota[i] = i;
+			}
+		};
+
+		static const Tables sTables;
+
+		struct Pack
+		{
+			typedef __m512 Reg;
+			typedef __mmask16 Mask;
+			enum { Width = 16 };
+
+			static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+			static void store(float* p, Reg v) { _mm512_storeu_ps(p, v); }
+			static Reg set1(float v) { return _mm512_set1_ps(v); }
+			static Reg zero() { return _mm512_setzero_ps(); }
+
+			static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+			static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+			static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+			static Reg div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+			static Reg sqrt(Reg a) { return _mm512_sqrt_ps(a); }
+			static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+			static Reg fmsub(Reg a, Reg b, Reg c) { return _mm512_fmsub_ps(a, b, c); }
+
+			static Reg abs(Reg a) { return _mm512_abs_ps(a); }
+			static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+
+			static Mask less(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+			// m ? x : y
+			static Reg select(Mask m, Reg x, Reg y) { return _mm512_mask_blend_ps(m, y, x); }
+
+			static __m512i index(const int* idx) { return _mm512_loadu_si512(idx); }
+
+			static void load3(const float* p, Reg& x, Reg& y, Reg& z)
+			{
+				Reg a = load(p);
+				Reg b = load(p + 16);
+				Reg c = load(p + 32);
+
+				x = _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, index(sTables.load1[0]), b), index(sTables.load2[0]), c);
+				y = _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, index(sTables.load1[1]), b), index(sTables.load2[1]), c);
+				z = _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, index(sTables.load1[2]), b), index(sTables.load2[2]), c);
+			}
+
+			static void store3(float* p, Reg x, Reg y, Reg z)
+			{
+				for (int b = 0; b < 3; b++)
+				{
+					Reg xy = _mm512_permutex2var_ps(x, index(sTables.store1[b]), y);
+					store(p + 16 * b, _mm512_permutex2var_ps(xy, index(sTables.store2[b]), z));
+				}
+			}
+
+			// p[i * stride]
+			static Reg gather(const float* p, int stride)
+			{
+				__m512i offset = _mm512_mullo_epi32(index(sTables.iota), _mm512_set1_epi32(stride));
+				return _mm512_i32gather_ps(offset, p, 4);
+			}
+
+			static void scatter(float* p, int stride, Reg v)
+			{
+				__m512i offset = _mm512_mullo_epi32(index(sTables.iota), _mm512_set1_epi32(stride));
+				_mm512_i32scatter_ps(p, offset, v, 4);
+			}
+		};
+
+		const char* instructionSet() { return "AVX-512"; }
+
+#elif defined(BATCH_AVX2)
+		struct Tables
+		{
+			// x, y and z of 8 interleaved vectors, every register is permuted with the same index and then blended
+			int loadIndex[3][8];
+			int loadMask1[3][8];
+			int loadMask2[3][8];
+
+			// three output registers, x, y and z are permuted per register and then blended
+			int storeIndex[3][8];
+			int storeMask1[3][8];
+			int storeMask2[3][8];
+
+			int iota[8];
+
+			Tables()
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					for (int i = 0; i < 8; i++)
+					{
+						int f = 3 * i + k;
+						loadIndex[k][i] = f % 8;
+						loadMask1[k][i] = f / 8 == 1 ? -1 : 0;
+						loadMask2[k][i] = f / 8 == 2 ? -1 : 0;
+					}
+				}
+
+				for (int b = 0; b < 3; b++)
+				{
+					for (int j = 0; j < 8; j++)
+					{
+						int f = 8 * b + j;
+						storeIndex[b][j] = f / 3;
+						storeMask1[b][j] = f % 3 == 1 ? -1 : 0;
+						storeMask2[b][j] = f % 3 == 2 ? -1 : 0;
+					}
+				}
+
+				for (int i = 0; i < 8; i++)
+					iota[i] = i;
+			}
+		};
+
+		static const Tables sTables;
+
+		struct Pack
+		{
+			typedef __m256 Reg;
+			typedef __m256 Mask;
+			enum { Width = 8 };
+
+			static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+			static void store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+			static Reg set1(float v) { return _mm256_set1_ps(v); }
+			static Reg zero() { return _mm256_setzero_ps(); }
+
+			static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+			static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+			static Reg sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+#ifdef __FMA__
+			static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+			static Reg fmsub(Reg a, Reg b, Reg c) { return _mm256_fmsub_ps(a, b, c); }
+#else
+			static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+			static Reg fmsub(Reg a, Reg b, Reg c) { return _mm256_sub_ps(_mm256_mul_ps(a, b), c); }
+#endif
+
+			static Reg abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+			static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+
+			static Mask less(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static Reg select(Mask m, Reg x, Reg y) { return _mm256_blendv_ps(y, x, m); }
+
+			static __m256i index(const int* idx) { return _mm256_loadu_si256((const __m256i*)idx); }
+			static Reg mask(const int* m) { return _mm256_castsi256_ps(index(m)); }
+
+			static void load3(const float* p, Reg& x, Reg& y, Reg& z)
+			{
+				Reg a = load(p);
+				Reg b = load(p + 8);
+				Reg c = load(p + 16);
+
+				Reg* out[3] = { &x, &y, &z };
+				for (int k = 0; k < 3; k++)
+				{
+					__m256i idx = index(sTables.loadIndex[k]);
+					Reg r = _mm256_permutevar8x32_ps(a, idx);
+					r = _mm256_blendv_ps(r, _mm256_permutevar8x32_ps(b, idx), mask(sTables.loadMask1[k]));
+					r = _mm256_blendv_ps(r, _mm256_permutevar8x32_ps(c, idx), mask(sTables.loadMask2[k]));
+					*out[k] = r;
+				}
+			}
+
+			static void store3(float* p, Reg x, Reg y, Reg z)
+			{
+				for (int b = 0; b < 3; b++)
+				{
+					__m256i idx = index(sTables.storeIndex[b]);
+					Reg r = _mm256_permutevar8x32_ps(x, idx);
+					r = _mm256_blendv_ps(r, _mm256_permutevar8x32_ps(y, idx), mask(sTables.storeMask1[b]));
+					r = _mm256_blendv_ps(r, _mm256_permutevar8x32_ps(z, idx), mask(sTables.storeMask2[b]));
+					store(p + 8 * b, r);
+				}
+			}
+
+			static Reg gather(const float* p, int stride)
+			{
+				__m256i offset = _mm256_mullo_epi32(index(sTables.iota), _mm256_set1_epi32(stride));
+				return _mm256_i32gather_ps(p, offset, 4);
+			}
+
+			static void scatter(float* p, int stride, Reg v)
+			{
+				float tmp[8];
+				store(tmp, v);
+				for (int i = 0; i < 8; i++)
+					p[i * stride] = tmp[i];
+			}
+		};
+
+		const char* instructionSet() { return "AVX2"; }
+
+#elif defined(BATCH_SSE)
+		struct Pack
+		{
+			typedef __m128 Reg;
+			typedef __m128 Mask;
+			enum { Width = 4 };
+
+			static Reg load(const float* p) { return _mm_loadu_ps(p); }
+			static void store(float* p, Reg v) { _mm_storeu_ps(p, v); }
+			static Reg set1(float v) { return _mm_set1_ps(v); }
+			static Reg zero() { return _mm_setzero_ps(); }
+
+			static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+			static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+			static Reg sqrt(Reg a) { return _mm_sqrt_ps(a); }
+			static Reg fmadd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+			static Reg fmsub(Reg a, Reg b, Reg c) { return _mm_sub_ps(_mm_mul_ps(a, b), c); }
+
+			static Reg abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+			static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+
+			static Mask less(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+			static Reg select(Mask m, Reg x, Reg y) { return _mm_or_ps(_mm_and_ps(m, x), _mm_andnot_ps(m, y)); }
+
+			// a = (x0 y0 z0 x1), b = (y1 z1 x2 y2), c = (z2 x3 y3 z3)
+			static void load3(const float* p, Reg& x, Reg& y, Reg& z)
+			{
+				Reg a = load(p);
+				Reg b = load(p + 4);
+				Reg c = load(p + 8);
+
+				Reg t = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));		// x2 y2 x3 y3
+				x = _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 3, 0));
+
+				Reg s = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));		// y0 y0 y1 y1
+				y = _mm_shuffle_ps(s, t, _MM_SHUFFLE(3, 1, 2, 0));
+
+				Reg u = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));		// z0 z0 z1 z1
+				Reg v = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));		// z2 z2 z3 z3
+				z = _mm_shuffle_ps(u, v, _MM_SHUFFLE(2, 0, 2, 0));
+			}
+
+			static void store3(float* p, Reg x, Reg y, Reg z)
+			{
+				Reg xy0 = _mm_unpacklo_ps(x, y);							// x0 y0 x1 y1
+				Reg xy1 = _mm_unpackhi_ps(x, y);							// x2 y2 x3 y3
+
+				Reg t0 = _mm_shuffle_ps(z, xy0, _MM_SHUFFLE(2, 2, 0, 0));	// z0 z0 x1 x1
+				store(p, _mm_shuffle_ps(xy0, t0, _MM_SHUFFLE(2, 0, 1, 0)));
+
+				Reg t1 = _mm_shuffle_ps(xy0, z, _MM_SHUFFLE(1, 1, 3, 3));	// y1 y1 z1 z1
+				store(p + 4, _mm_shuffle_ps(t1, xy1, _MM_SHUFFLE(1, 0, 2, 0)));
+
+				Reg t2 = _mm_shuffle_ps(z, xy1, _MM_SHUFFLE(2, 2, 2, 2));	// z2 z2 x3 x3
+				Reg t3 = _mm_shuffle_ps(xy1, z, _MM_SHUFFLE(3, 3, 3, 3));	// y3 y3 z3 z3
+				store(p + 8, _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0)));
+			}
+
+			static Reg gather(const float* p, int stride)
+			{
+				return _mm_set_ps(p[3 * stride], p[2 * stride], p[stride], p[0]);
+			}
+
+			static void scatter(float* p, int stride, Reg v)
+			{
+				float tmp[4];
+				store(tmp, v);
+				for (int i = 0; i < 4; i++)
+					p[i * stride] = tmp[i];
+			}
+		};
+
+		const char* instructionSet() { return "SSE2"; }
+
+#else
+		const char* instructionSet() { return "None"; }
+#endif
+
+		// scalar versions for the remainder of a batch
+		static inline void axpy1(float* y, const float* x, float a)
+		{
+			y[0] += a * x[0];
+		}
+
+		static inline void dot1(float* out, const float* a, const float* b)
+		{
+			out[0] = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+		}
+
+		static inline void normalize1(float* v)
+		{
+			float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+			float inv = len > FLT_EPSILON ? 1.0f / len : 0.0f;
+			v[0] *= inv;
+			v[1] *= inv;
+			v[2] *= inv;
+		}
+
+		static inline void cross1(float* out, const float* a, const float* b)
+		{
+			float x = a[1] * b[2] - a[2] * b[1];
+			float y = a[2] * b[0] - a[0] * b[2];
+			float z = a[0] * b[1] - a[1] * b[0];
+			out[0] = x;
+			out[1] = y;
+			out[2] = z;
+		}
+
+		// m is stored column by column
+		static inline void multiply1(float* out, const float* m, const float* v)
+		{
+			float x = m[0] * v[0] + m[3] * v[1] + m[6] * v[2];
+			float y = m[1] * v[0] + m[4] * v[1] + m[7] * v[2];
+			float z = m[2] * v[0] + m[5] * v[1] + m[8] * v[2];
+			out[0] = x;
+			out[1] = y;
+			out[2] = z;
+		}
+
+		static inline void transform1(float* out, const float* m, const float* t, const float* v)
+		{
+			multiply1(out, m, v);
+			out[0] += t[0];
+			out[1] += t[1];
+			out[2] += t[2];
+		}
+
+#if defined(BATCH_AVX512) || defined(BATCH_AVX2) || defined(BATCH_SSE)
+		typedef Pack P;
+		typedef Pack::Reg Reg;
+		const size_t W = Pack::Width;
+
+		void axpy(float* y, const float* x, float a, size_t n)
+		{
+			// the operation is component-wise, so the vectors are treated as a flat array of 3n floats
+			size_t m = 3 * n;
+			size_t i = 0;
+
+			Reg va = P::set1(a);
+			for (; i + W <= m; i += W)
+				P::store(y + i, P::fmadd(va, P::load(x + i), P::load(y + i)));
+
+			for (; i < m; i++)
+				axpy1(y + i, x + i, a);
+		}
+
+		void dot(float* out, const float* a, const float* b, size_t n)
+		{
+			size_t i = 0;
+			for (; i + W <= n; i += W)
+			{
+				Reg ax, ay, az, bx, by, bz;
+				P::load3(a + 3 * i, ax, ay, az);
+				P::load3(b + 3 * i, bx, by, bz);
+
+				P::store(out + i, P::fmadd(ax, bx, P::fmadd(ay, by, P::mul(az, bz))));
+			}
+
+			for (; i < n; i++)
+				dot1(out + i, a + 3 * i, b + 3 * i);
+		}
+
+		void normalize(float* v, size_t n)
+		{
+			Reg eps = P::set1(FLT_EPSILON);
+			Reg one = P::set1(1.0f);
+
+			size_t i = 0;
+			for (; i + W <= n; i += W)
+			{
+				Reg x, y, z;
+				P::load3(v + 3 * i, x, y, z);
+
+				Reg len = P::sqrt(P::fmadd(x, x, P::fmadd(y, y, P::mul(z, z))));
+				Reg inv = P::select(P::less(eps, len), P::div(one, len), P::zero());
+
+				P::store3(v + 3 * i, P::mul(x, inv), P::mul(y, inv), P::mul(z, inv));
+			}
+
+			for (; i < n; i++)
+				normalize1(v + 3 * i);
+		}
+
+		void cross(float* out, const float* a, const float* b, size_t n)
+		{
+			size_t i = 0;
+			for (; i + W <= n; i += W)
+			{
+				Reg ax, ay, az, bx, by, bz;
+				P::load3(a + 3 * i, ax, ay, az);
+				P::load3(b + 3 * i, bx, by, bz);
+
+				P::store3(out + 3 * i,
+					P::fmsub(ay, bz, P::mul(az, by)),
+					P::fmsub(az, bx, P::mul(ax, bz)),
+					P::fmsub(ax, by, P::mul(ay, bx)));
+			}
+
+			for (; i < n; i++)
+				cross1(out + 3 * i, a + 3 * i, b + 3 * i);
+		}
+
+		void multiply(float* out, const float* m, const float* v, size_t n)
+		{
+			size_t i = 0;
+			for (; i + W <= n; i += W)
+			{
+				const float* mi = m + 9 * i;
+
+				Reg x, y, z;
+				P::load3(v + 3 * i, x, y, z);
+
+				Reg rx = P::fmadd(P::gather(mi + 0, 9), x, P::fmadd(P::gather(mi + 3, 9), y, P::mul(P::gather(mi + 6, 9), z)));
+				Reg ry = P::fmadd(P::gather(mi + 1, 9), x, P::fmadd(P::gather(mi + 4, 9), y, P::mul(P::gather(mi + 7, 9), z)));
+				Reg rz = P::fmadd(P::gather(mi + 2, 9), x, P::fmadd(P::gather(mi + 5, 9), y, P::mul(P::gather(mi + 8, 9), z)));
+
+				P::store3(out + 3 * i, rx, ry, rz);
+			}
+
+			for (; i < n; i++)
+				multiply1(out + 3 * i, m + 9 * i, v + 3 * i);
+		}
+
+		void transform(float* out, const float* m, const float* t, const float* v, size_t n)
+		{
+			Reg m00 = P::set1(m[0]), m10 = P::set1(m[1]), m20 = P::set1(m[2]);
+			Reg m01 = P::set1(m[3]), m11 = P::set1(m[4]), m21 = P::set1(m[5]);
+			Reg m02 = P::set1(m[6]), m12 = P::set1(m[7]), m22 = P::set1(m[8]);
+			Reg tx = P::set1(t[0]), ty = P::set1(t[1]), tz = P::set1(t[2]);
+
+			size_t i = 0;
+			for (; i + W <= n; i += W)
+			{
+				Reg x, y, z;
+				P::load3(v + 3 * i, x, y, z);
+
+				Reg rx = P::fmadd(m00, x, P::fmadd(m01, y, P::fmadd(m02, z, tx)));
+				Reg ry = P::fmadd(m10, x, P::fmadd(m11, y, P::fmadd(m12, z, ty)));
+				Reg rz = P::fmadd(m20, x, P::fmadd(m21, y, P::fmadd(m22, z, tz)));
+
+				P::store3(out + 3 * i, rx, ry, rz);
+			}
+
+			for (; i < n; i++)
+				transform1(out + 3 * i, m, t, v + 3 * i);
+		}
+#else
+		void axpy(float* y, const float* x, float a, size_t n)
+		{
+			for (size_t i = 0; i < 3 * n; i++)
+				axpy1(y + i, x + i, a);
+		}
+
+		void dot(float* out, const float* a, const float* b, size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				dot1(out + i, a + 3 * i, b + 3 * i);
+		}
+
+		void normalize(float* v, size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				normalize1(v + 3 * i);
+		}
+
+		void cross(float* out, const float* a, const float* b, size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				cross1(out + 3 * i, a + 3 * i, b + 3 * i);
+		}
+
+		void multiply(float* out, const float* m, const float* v, size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				multiply1(out + 3 * i, m + 9 * i, v + 3 * i);
+		}
+
+		void transform(float* out, const float* m, const float* t, const float* v, size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				transform1(out + 3 * i, m, t, v + 3 * i);
+		}
+#endif
+
+		// one element per lane, used for the remainder of a batch and when no instruction set is available
+		struct Scalar
+		{
+			typedef float Reg;
+			typedef bool Mask;
+			enum { Width = 1 };
+
+			static Reg set1(float v) { return v; }
+			static Reg add(Reg a, Reg b) { return a + b; }
+			static Reg sub(Reg a, Reg b) { return a - b; }
+			static Reg mul(Reg a, Reg b) { return a * b; }
+			static Reg div(Reg a, Reg b) { return a / b; }
+			static Reg sqrt(Reg a) { return std::sqrt(a); }
+			static Reg fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+			static Reg abs(Reg a) { return std::fabs(a); }
+			static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+
+			static Mask less(Reg a, Reg b) { return a < b; }
+			static Reg select(Mask m, Reg x, Reg y) { return m ? x : y; }
+
+			static Reg gather(const float* p, int) { return p[0]; }
+			static void scatter(float* p, int, Reg v) { p[0] = v; }
+		};
+
+		// arithmetic operators on the registers of a pack, so that the decomposition below reads like scalar code
+		template<class P>
+		struct Lane
+		{
+			typedef typename P::Reg Reg;
+			typedef typename P::Mask Mask;
+
+			Lane() {}
+			Lane(Reg r) : v(r) {}
+
+			Lane operator+ (const Lane& b) const { return P::add(v, b.v); }
+			Lane operator- (const Lane& b) const { return P::sub(v, b.v); }
+			Lane operator* (const Lane& b) const { return P::mul(v, b.v); }
+			Lane operator/ (const Lane& b) const { return P::div(v, b.v); }
+			Lane operator- () const { return P::sub(P::set1(0.0f), v); }
+
+			Lane operator* (float b) const { return P::mul(v, P::set1(b)); }
+			Lane operator+ (float b) const { return P::add(v, P::set1(b)); }
+
+			Lane& operator+= (const Lane& b) { v = P::add(v, b.v); return *this; }
+			Lane& operator-= (const Lane& b) { v = P::sub(v, b.v); return *this; }
+			Lane& operator*= (const Lane& b) { v = P::mul(v, b.v); return *this; }
+
+			Mask operator< (const Lane& b) const { return P::less(v, b.v); }
+
+			Reg v;
+		};
+
+		template<class P> Lane<P> sqrt(const Lane<P>& a) { return P::sqrt(a.v); }
+		template<class P> Lane<P> rsqrt(const Lane<P>& a) { return P::div(P::set1(1.0f), P::sqrt(a.v)); }
+		template<class P> Lane<P> abs(const Lane<P>& a) { return P::abs(a.v); }
+		template<class P> Lane<P> max(const Lane<P>& a, const Lane<P>& b) { return P::max(a.v, b.v); }
+		template<class P> Lane<P> select(typename P::Mask m, const Lane<P>& x, const Lane<P>& y) { return P::select(m, x.v, y.v); }
+
+		template<class P>
+		void condSwap(typename P::Mask c, Lane<P>& x, Lane<P>& y)
+		{
+			Lane<P> z = x;
+			x = select<P>(c, y, x);
+			y = select<P>(c, z, y);
+		}
+
+		template<class P>
+		void condNegSwap(typename P::Mask c, Lane<P>& x, Lane<P>& y)
+		{
+			Lane<P> z = -x;
+			x = select<P>(c, y, x);
+			y = select<P>(c, z, y);
+		}
+
+		/**
+		 * SVD of 3x3 matrices with a fixed number of Jacobi sweeps and without branches, following
+		 * A. McAdams et al., Computing the Singular Value Decomposition of 3x3 matrices with minimal branching and
+		 * elementary floating point operations, 2011, which is also the algorithm behind svd3_cuda.h of the CUDA backend.
+		 *
+		 * Matrices are indexed as m[3 * row + col].
+		 */
+		template<class P>
+		struct Svd3
+		{
+			typedef Lane<P> L;
+
+			static L k(float f) { return P::set1(f); }
+
+			// svd3_cuda.h does 4 sweeps, which leaves errors of up to 5e-3 for some random matrices, 6 sweeps stay below 1e-4
+			static const int JacobiSweeps = 6;
+
+			// one Jacobi rotation on the 2x2 block (s11, s21, s22), then the indices are cycled for the next pair
+			static void jacobiConjugation(int x, int y, int z, L& s11, L& s21, L& s22, L& s31, L& s32, L& s33, L* q)
+			{
+				const float gamma = 5.828427124f;	// 3 + 2 sqrt(2)
+				const float cstar = 0.923879532f;	// cos(pi / 8)
+				const float sstar = 0.3826834323f;	// sin(pi / 8)
+
+				// approximate Givens quaternion
+				L ch = (s11 - s22) * 2.0f;
+				L sh = s21;
+
+				// no rotation if the off diagonal entry is already negligible
+				typename P::Mask tiny = sh * sh < k(1e-20f);
+				sh = select<P>(tiny, k(0.0f), sh);
+				ch = select<P>(tiny, k(1.0f), ch);
+
+				typename P::Mask b = sh * sh * gamma < ch * ch;
+				L w = rsqrt(ch * ch + sh * sh);
+				ch = select<P>(b, w * ch, k(cstar));
+				sh = select<P>(b, w * sh, k(sstar));
+
+				L scale = ch * ch + sh * sh;
+				L a = (ch * ch - sh * sh) / scale;
+				L c = (sh * ch * 2.0f) / scale;
+
+				// S = Q^T S Q
+				L t11 = s11, t21 = s21, t22 = s22, t31 = s31, t32 = s32, t33 = s33;
+				s11 = a * (a * t11 + c * t21) + c * (a * t21 + c * t22);
+				s21 = a * (-c * t11 + a * t21) + c * (-c * t21 + a * t22);
+				s22 = -c * (-c * t11 + a * t21) + a * (-c * t21 + a * t22);
+				s31 = a * t31 + c * t32;
+				s32 = -c * t31 + a * t32;
+				s33 = t33;
+
+				// accumulate the rotation as a quaternion (x, y, z, w)
+				L tmp[3] = { q[0] * sh, q[1] * sh, q[2] * sh };
+				sh *= q[3];
+				q[0] *= ch;
+				q[1] *= ch;
+				q[2] *= ch;
+				q[3] *= ch;
+
+				q[z] += sh;
+				q[3] -= tmp[z];
+				q[x] += tmp[y];
+				q[y] -= tmp[x];
+
+				// cycle the indices
+				t11 = s22; t21 = s32; t22 = s33; t31 = s21; t32 = s31; t33 = s11;
+				s11 = t11; s21 = t21; s22 = t22; s31 = t31; s32 = t32; s33 = t33;
+			}
+
+			// Givens rotation (c, s) annihilating a2 against a1
+			static void givensQR(const L& a1, const L& a2, L& c, L& s)
+			{
+				const float epsilon = 1e-6f;
+
+				L rho = sqrt(a1 * a1 + a2 * a2);
+				L sh = select<P>(k(epsilon) < rho, a2, k(0.0f));
+				L ch = abs(a1) + max(rho, k(epsilon));
+				condSwap<P>(a1 < k(0.0f), sh, ch);
+
+				L w = rsqrt(ch * ch + sh * sh);
+				ch *= w;
+				sh *= w;
+
+				c = k(1.0f) - sh * sh * 2.0f;
+				s = ch * sh * 2.0f;
+			}
+
+			// A = U diag(s) V^T, U and V are rotations, |s0| >= |s1| >= |s2| and s2 is negative if A is a reflection
+			static void compute(const L* A, L* U, L* s, L* V)
+			{
+				// symmetric A^T A
+				L s11 = A[0] * A[0] + A[3] * A[3] + A[6] * A[6];
+				L s21 = A[1] * A[0] + A[4] * A[3] + A[7] * A[6];
+				L s22 = A[1] * A[1] + A[4] * A[4] + A[7] * A[7];
+				L s31 = A[2] * A[0] + A[5] * A[3] + A[8] * A[6];
+				L s32 = A[2] * A[1] + A[5] * A[4] + A[8] * A[7];
+				L s33 = A[2] * A[2] + A[5] * A[5] + A[8] * A[8];
+
+				L q[4] = { k(0.0f), k(0.0f), k(0.0f), k(1.0f) };
+				for (int i = 0; i < JacobiSweeps; i++)
+				{
+					jacobiConjugation(0, 1, 2, s11, s21, s22, s31, s32, s33, q);
+					jacobiConjugation(1, 2, 0, s11, s21, s22, s31, s32, s33, q);
+					jacobiConjugation(2, 0, 1, s11, s21, s22, s31, s32, s33, q);
+				}
+
+				L norm = rsqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+				L qx = q[0] * norm, qy = q[1] * norm, qz = q[2] * norm, qw = q[3] * norm;
+
+				L qxx = qx * qx, qyy = qy * qy, qzz = qz * qz;
+				L qxy = qx * qy, qxz = qx * qz, qyz = qy * qz;
+				L qwx = qw * qx, qwy = qw * qy, qwz = qw * qz;
+
+				V[0] = k(1.0f) - (qyy + qzz) * 2.0f;	V[1] = (qxy - qwz) * 2.0f;				V[2] = (qxz + qwy) * 2.0f;
+				V[3] = (qxy + qwz) * 2.0f;				V[4] = k(1.0f) - (qxx + qzz) * 2.0f;	V[5] = (qyz - qwx) * 2.0f;
+				V[6] = (qxz - qwy) * 2.0f;				V[7] = (qyz + qwx) * 2.0f;				V[8] = k(1.0f) - (qxx + qyy) * 2.0f;
+
+				// B = A V
+				L B[9];
+				for (int i = 0; i < 3; i++)
+					for (int j = 0; j < 3; j++)
+						B[3 * i + j] = A[3 * i] * V[j] + A[3 * i + 1] * V[3 + j] + A[3 * i + 2] * V[6 + j];
+
+				// sort the columns of B by decreasing norm, negating one of each swapped pair to keep V a rotation
+				L rho[3];
+				for (int j = 0; j < 3; j++)
+					rho[j] = B[j] * B[j] + B[3 + j] * B[3 + j] + B[6 + j] * B[6 + j];
+
+				const int pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+				for (int k = 0; k < 3; k++)
+				{
+					int a = pairs[k][0];
+					int b = pairs[k][1];
+
+					typename P::Mask c = rho[a] < rho[b];
+					for (int i = 0; i < 3; i++)
+					{
+						condNegSwap<P>(c, B[3 * i + a], B[3 * i + b]);
+						condNegSwap<P>(c, V[3 * i + a], V[3 * i + b]);
+					}
+					condSwap<P>(c, rho[a], rho[b]);
+				}
+
+				// QR decomposition of B with three Givens rotations, B = U R
+				L c1, s1, c2, s2, c3, s3;
+				L R[9];
+
+				givensQR(B[0], B[3], c1, s1);
+				for (int j = 0; j < 3; j++)
+				{
+					L b0 = B[j], b1 = B[3 + j];
+					R[j] = c1 * b0 + s1 * b1;
+					R[3 + j] = -s1 * b0 + c1 * b1;
+					R[6 + j] = B[6 + j];
+				}
+
+				givensQR(R[0], R[6], c2, s2);
+				for (int j = 0; j < 3; j++)
+				{
+					L r0 = R[j], r2 = R[6 + j];
+					R[j] = c2 * r0 + s2 * r2;
+					R[6 + j] = -s2 * r0 + c2 * r2;
+				}
+
+				givensQR(R[4], R[7], c3, s3);
+				for (int j = 0; j < 3; j++)
+				{
+					L r1 = R[3 + j], r2 = R[6 + j];
+					R[3 + j] = c3 * r1 + s3 * r2;
+					R[6 + j] = -s3 * r1 + c3 * r2;
+				}
+
+				// U = G1 G2 G3
+				L G12[9] = {
+					c1 * c2,	-s1,		-c1 * s2,
+					s1 * c2,	c1,			-s1 * s2,
+					s2,			k(0.0f),	c2 };
+
+				for (int i = 0; i < 3; i++)
+				{
+					U[3 * i] = G12[3 * i];
+					U[3 * i + 1] = G12[3 * i + 1] * c3 + G12[3 * i + 2] * s3;
+					U[3 * i + 2] = -G12[3 * i + 1] * s3 + G12[3 * i + 2] * c3;
+				}
+
+				s[0] = R[0];
+				s[1] = R[4];
+				s[2] = R[8];
+			}
+		};
+
+		// matrices are stored column by column, so that the entry (row, col) of the i-th matrix is at p[9 * i + 3 * col + row]
+		template<class P>
+		void loadMatrices(const float* p, Lane<P>* m)
+		{
+			for (int r = 0; r < 3; r++)
+				for (int c = 0; c < 3; c++)
+					m[3 * r + c] = P::gather(p + 3 * c + r, 9);
+		}
+
+		template<class P>
+		void storeMatrices(float* p, const Lane<P>* m)
+		{
+			for (int r = 0; r < 3; r++)
+				for (int c = 0; c < 3; c++)
+					P::scatter(p + 3 * c + r, 9, m[3 * r + c].v);
+		}
+
+		template<class P>
+		size_t svdBatch(float* u, float* s, float* v, const float* a, size_t first, size_t n)
+		{
+			const size_t W = P::Width;
+
+			size_t i = first;
+			for (; i + W <= n; i += W)
+			{
+				Lane<P> A[9], U[9], S[3], V[9];
+				loadMatrices<P>(a + 9 * i, A);
+
+				Svd3<P>::compute(A, U, S, V);
+
+				storeMatrices<P>(u + 9 * i, U);
+				storeMatrices<P>(v + 9 * i, V);
+				for (int k = 0; k < 3; k++)
+					P::scatter(s + 3 * i + k, 3, S[k].v);
+			}
+
+			return i;
+		}
+
+		template<class P>
+		size_t polarBatch(float* r, float* sym, const float* a, size_t first, size_t n)
+		{
+			const size_t W = P::Width;
+
+			size_t i = first;
+			for (; i + W <= n; i += W)
+			{
+				Lane<P> A[9], U[9], S[3], V[9];
+				loadMatrices<P>(a + 9 * i, A);
+
+				Svd3<P>::compute(A, U, S, V);
+
+				// A = (U V^T) (V diag(S) V^T)
+				Lane<P> R[9];
+				for (int p = 0; p < 3; p++)
+					for (int q = 0; q < 3; q++)
+						R[3 * p + q] = U[3 * p] * V[3 * q] + U[3 * p + 1] * V[3 * q + 1] + U[3 * p + 2] * V[3 * q + 2];
+
+				storeMatrices<P>(r + 9 * i, R);
+
+				if (sym != nullptr)
+				{
+					Lane<P> H[9];
+					for (int p = 0; p < 3; p++)
+						for (int q = 0; q < 3; q++)
+							H[3 * p + q] = V[3 * p] * S[0] * V[3 * q] + V[3 * p + 1] * S[1] * V[3 * q + 1] + V[3 * p + 2] * S[2] * V[3 * q + 2];
+
+					storeMatrices<P>(sym + 9 * i, H);
+				}
+			}
+
+			return i;
+		}
+
+		void svd(float* u, float* s, float* v, const float* a, size_t n)
+		{
+			size_t i = 0;
+#if defined(BATCH_AVX512) || defined(BATCH_AVX2) || defined(BATCH_SSE)
+			i = svdBatch<Pack>(u, s, v, a, i, n);
+#endif
+			svdBatch<Scalar>(u, s, v, a, i, n);
+		}
+
+		void polar(float* r, float* sym, const float* a, size_t n)
+		{
+			size_t i = 0;
+#if defined(BATCH_AVX512) || defined(BATCH_AVX2) || defined(BATCH_SSE)
+			i = polarBatch<Pack>(r, sym, a, i, n);
+#endif
+			polarBatch<Scalar>(r, sym, a, i, n);
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+
+namespace dyno
+{
+	/**
+	 * Kernels behind the float overloads in BatchMath.h, working on tightly packed floats.
+	 *
+	 * BatchKernels.cpp is the only file compiled with the instruction set selected by PERIDYNO_CPU_SIMD, it must not
+	 * include the vector and matrix headers, otherwise their inline functions may be emitted with instructions the
+	 * rest of the library does not assume.
+	 */
+	namespace kernel
+	{
+		void axpy(float* y, const float* x, float a, size_t n);
+		void dot(float* out, const float* a, const float* b, size_t n);
+		void normalize(float* v, size_t n);
+		void cross(float* out, const float* a, const float* b, size_t n);
+		void multiply(float* out, const float* m, const float* v, size_t n);
+		void transform(float* out, const float* m, const float* t, const float* v, size_t n);
+
+		void svd(float* u, float* s, float* v, const float* a, size_t n);
+		void polar(float* r, float* sym, const float* a, size_t n);
+
+		const char* instructionSet();
+	}
+}
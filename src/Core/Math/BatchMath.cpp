@@ -0,0 +1,133 @@
+#include "BatchMath.h"
+#include "BatchKernels.h"
+
+namespace dyno
+{
+	// the kernels assume Vec3f and Mat3f are tightly packed, which is not the case if Vec3f is padded to 16 bytes
+	static const bool sPacked = sizeof(Vec3f) == 3 * sizeof(float) && sizeof(Mat3f) == 9 * sizeof(float);
+
+	void batchAxpy(Vec3f* y, const Vec3f* x, float a, size_t n)
+	{
+		if (sPacked)
+			kernel::axpy((float*)y, (const float*)x, a, n);
+		else
+			batchAxpy<float>(y, x, a, n);
+	}
+
+	void batchDot(float* out, const Vec3f* a, const Vec3f* b, size_t n)
+	{
+		if (sPacked)
+			kernel::dot(out, (const float*)a, (const float*)b, n);
+		else
+			batchDot<float>(out, a, b, n);
+	}
+
+	void batchNormalize(Vec3f* v, size_t n)
+	{
+		if (sPacked)
+			kernel::normalize((float*)v, n);
+		else
+			batchNormalize<float>(v, n);
+	}
+
+	void batchCross(Vec3f* out, const Vec3f* a, const Vec3f* b, size_t n)
+	{
+		if (sPacked)
+			kernel::cross((float*)out, (const float*)a, (const float*)b, n);
+		else
+			batchCross<float>(out, a, b, n);
+	}
+
+	void batchMultiply(Vec3f* out, const Mat3f* m, const Vec3f* v, size_t n)
+	{
+		if (sPacked)
+			kernel::multiply((float*)out, (const float*)m, (const float*)v, n);
+		else
+			batchMultiply<float>(out, m, v, n);
+	}
+
+	void batchTransform(Vec3f* out, const Mat3f& m, const Vec3f& t, const Vec3f* v, size_t n)
+	{
+		if (sPacked)
+			kernel::transform((float*)out, (const float*)&m, (const float*)&t, (const float*)v, n);
+		else
+			batchTransform<float>(out, m, t, v, n);
+	}
+
+	void batchSVD(Mat3f* U, Vec3f* S, Mat3f* V, const Mat3f* A, size_t n)
+	{
+		if (sPacked)
+		{
+			kernel::svd((float*)U, (float*)S, (float*)V, (const float*)A, n);
+			return;
+		}
+
+		for (size_t i = 0; i < n; i++)
+		{
+			float a[9], u[9], s[3], v[9];
+			for (int c = 0; c < 3; c++)
+				for (int r = 0; r < 3; r++)
+					a[3 * c + r] = A[i](r, c);
+
+			kernel::svd(u, s, v, a, 1);
+
+			for (int c = 0; c < 3; c++)
+			{
+				for (int r = 0; r < 3; r++)
+				{
+					U[i](r, c) = u[3 * c + r];
+					V[i](r, c) = v[3 * c + r];
+				}
+				S[i][c] = s[c];
+			}
+		}
+	}
+
+	void batchPolarDecomposition(Mat3f* R, Mat3f* S, const Mat3f* A, size_t n)
+	{
+		if (sPacked)
+		{
+			kernel::polar((float*)R, (float*)S, (const float*)A, n);
+			return;
+		}
+
+		for (size_t i = 0; i < n; i++)
+		{
+			float a[9], r[9], s[9];
+			for (int c = 0; c < 3; c++)
+				for (int k = 0; k < 3; k++)
+					a[3 * c + k] = A[i](k, c);
+
+			kernel::polar(r, S != nullptr ? s : nullptr, a, 1);
+
+			for (int c = 0; c < 3; c++)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					R[i](k, c) = r[3 * c + k];
+					if (S != nullptr)
+						S[i](k, c) = s[3 * c + k];
+				}
+			}
+		}
+	}
+
+	void batchSVD(CArray<Mat3f>& U, CArray<Vec3f>& S, CArray<Mat3f>& V, const CArray<Mat3f>& A)
+	{
+		U.resize(A.size());
+		S.resize(A.size());
+		V.resize(A.size());
+		batchSVD(U.begin(), S.begin(), V.begin(), A.begin(), A.size());
+	}
+
+	void batchPolarDecomposition(CArray<Mat3f>& R, const CArray<Mat3f>& A)
+	{
+		R.resize(A.size());
+		batchPolarDecomposition(R.begin(), nullptr, A.begin(), A.size());
+	}
+
+	const char* batchInstructionSet()
+	{
+		return sPacked ? kernel::instructionSet() : "None";
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix.h"
+#include "Array/Array.h"
+
+namespace dyno
+{
+	/**
+	 * Batch operations on arrays of 3D vectors and 3x3 matrices on the host.
+	 *
+	 * The overloads for float process 4, 8 or 16 elements per instruction, depending on whether the Core library
+	 * is compiled with SSE, AVX2 or AVX-512 (see PERIDYNO_CPU_SIMD), and fall back to plain loops otherwise. The
+	 * templates are the scalar versions for all other types.
+	 *
+	 * An output may be the same array as an input, but must not partially overlap with it.
+	 */
+
+	// y[i] += a * x[i]
+	void batchAxpy(Vec3f* y, const Vec3f* x, float a, size_t n);
+
+	// out[i] = a[i].dot(b[i])
+	void batchDot(float* out, const Vec3f* a, const Vec3f* b, size_t n);
+
+	// v[i].normalize(), vectors not longer than the machine epsilon become zero
+	void batchNormalize(Vec3f* v, size_t n);
+
+	// out[i] = a[i].cross(b[i])
+	void batchCross(Vec3f* out, const Vec3f* a, const Vec3f* b, size_t n);
+
+	// out[i] = m[i] * v[i]
+	void batchMultiply(Vec3f* out, const Mat3f* m, const Vec3f* v, size_t n);
+
+	// out[i] = m * v[i] + t
+	void batchTransform(Vec3f* out, const Mat3f& m, const Vec3f& t, const Vec3f* v, size_t n);
+
+	/**
+	 * @brief Singular value decomposition A[i] = U[i] * diag(S[i]) * V[i]^T
+	 *
+	 * Uses a fixed number of Jacobi sweeps without data dependent branches, the algorithm of svd in svd3_cuda.h.
+	 * U[i] and V[i] are rotations, the singular values are sorted by decreasing magnitude and the last
+	 * one is negative if A[i] is a reflection.
+	 */
+	void batchSVD(Mat3f* U, Vec3f* S, Mat3f* V, const Mat3f* A, size_t n);
+
+	/**
+	 * @brief Polar decomposition A[i] = R[i] * S[i] with R[i] = U[i] * V[i]^T a rotation and S[i] symmetric,
+	 * 	S may be nullptr if only the rotations are needed
+	 */
+	void batchPolarDecomposition(Mat3f* R, Mat3f* S, const Mat3f* A, size_t n);
+
+	void batchSVD(CArray<Mat3f>& U, CArray<Vec3f>& S, CArray<Mat3f>& V, const CArray<Mat3f>& A);
+
+	void batchPolarDecomposition(CArray<Mat3f>& R, const CArray<Mat3f>& A);
+
+	/**
+	 * @brief Name of the instruction set the float overloads are compiled for
+	 */
+	const char* batchInstructionSet();
+
+	template<typename T>
+	void batchAxpy(Vector<T, 3>* y, const Vector<T, 3>* x, T a, size_t n);
+
+	template<typename T>
+	void batchDot(T* out, const Vector<T, 3>* a, const Vector<T, 3>* b, size_t n);
+
+	template<typename T>
+	void batchNormalize(Vector<T, 3>* v, size_t n);
+
+	template<typename T>
+	void batchCross(Vector<T, 3>* out, const Vector<T, 3>* a, const Vector<T, 3>* b, size_t n);
+
+	template<typename T>
+	void batchMultiply(Vector<T, 3>* out, const SquareMatrix<T, 3>* m, const Vector<T, 3>* v, size_t n);
+
+	template<typename T>
+	void batchTransform(Vector<T, 3>* out, const SquareMatrix<T, 3>& m, const Vector<T, 3>& t, const Vector<T, 3>* v, size_t n);
+
+	template<typename T>
+	void batchAxpy(CArray<Vector<T, 3>>& y, const CArray<Vector<T, 3>>& x, T a);
+
+	template<typename T>
+	void batchDot(CArray<T>& out, const CArray<Vector<T, 3>>& a, const CArray<Vector<T, 3>>& b);
+
+	template<typename T>
+	void batchNormalize(CArray<Vector<T, 3>>& v);
+
+	template<typename T>
+	void batchCross(CArray<Vector<T, 3>>& out, const CArray<Vector<T, 3>>& a, const CArray<Vector<T, 3>>& b);
+
+	template<typename T>
+	void batchMultiply(CArray<Vector<T, 3>>& out, const CArray<SquareMatrix<T, 3>>& m, const CArray<Vector<T, 3>>& v);
+
+	template<typename T>
+	void batchTransform(CArray<Vector<T, 3>>& out, const SquareMatrix<T, 3>& m, const Vector<T, 3>& t, const CArray<Vector<T, 3>>& v);
+}
+
+#include "BatchMath.inl"
@@ -0,0 +1,88 @@
+namespace dyno
+{
+	template<typename T>
+	void batchAxpy(Vector<T, 3>* y, const Vector<T, 3>* x, T a, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			y[i] += x[i] * a;
+	}
+
+	template<typename T>
+	void batchDot(T* out, const Vector<T, 3>* a, const Vector<T, 3>* b, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			out[i] = a[i].dot(b[i]);
+	}
+
+	template<typename T>
+	void batchNormalize(Vector<T, 3>* v, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			v[i].normalize();
+	}
+
+	template<typename T>
+	void batchCross(Vector<T, 3>* out, const Vector<T, 3>* a, const Vector<T, 3>* b, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			out[i] = a[i].cross(b[i]);
+	}
+
+	template<typename T>
+	void batchMultiply(Vector<T, 3>* out, const SquareMatrix<T, 3>* m, const Vector<T, 3>* v, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			out[i] = m[i] * v[i];
+	}
+
+	template<typename T>
+	void batchTransform(Vector<T, 3>* out, const SquareMatrix<T, 3>& m, const Vector<T, 3>& t, const Vector<T, 3>* v, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			out[i] = m * v[i] + t;
+	}
+
+	template<typename T>
+	void batchAxpy(CArray<Vector<T, 3>>& y, const CArray<Vector<T, 3>>& x, T a)
+	{
+		assert(y.size() == x.size());
+		batchAxpy(y.begin(), x.begin(), a, y.size());
+	}
+
+	template<typename T>
+	void batchDot(CArray<T>& out, const CArray<Vector<T, 3>>& a, const CArray<Vector<T, 3>>& b)
+	{
+		assert(a.size() == b.size());
+		out.resize(a.size());
+		batchDot(out.begin(), a.begin(), b.begin(), a.size());
+	}
+
+	template<typename T>
+	void batchNormalize(CArray<Vector<T, 3>>& v)
+	{
+		batchNormalize(v.begin(), v.size());
+	}
+
+	template<typename T>
+	void batchCross(CArray<Vector<T, 3>>& out, const CArray<Vector<T, 3>>& a, const CArray<Vector<T, 3>>& b)
+	{
+		assert(a.size() == b.size());
+		out.resize(a.size());
+		batchCross(out.begin(), a.begin(), b.begin(), a.size());
+	}
+
+	template<typename T>
+	void batchMultiply(CArray<Vector<T, 3>>& out, const CArray<SquareMatrix<T, 3>>& m, const CArray<Vector<T, 3>>& v)
+	{
+		assert(m.size() == v.size());
+		out.resize(v.size());
+		batchMultiply(out.begin(), m.begin(), v.begin(), v.size());
+	}
+
+	template<typename T>
+	void batchTransform(CArray<Vector<T, 3>>& out, const SquareMatrix<T, 3>& m, const Vector<T, 3>& t, const CArray<Vector<T, 3>>& v)
+	{
+		out.resize(v.size());
+		batchTransform(out.begin(), m, t, v.begin(), v.size());
+	}
+}
@@ -1,23 +1,12 @@
 #include "ImplicitViscosity.h"
 #include "Node.h"
+#include "Kernel.h"
 
 namespace dyno
 {
 //	IMPLEMENT_TCLASS(ImplicitViscosity, TDataType)
 
-	template<typename Real>
-	__device__ Real IV_Weight(const Real r, const Real h)
-	{
-		Real q = r / h;
-		if (q > 1.0f) return 0.0;
-		else {
-			const Real d = 1.0f - q;
-			const Real hh = h*h;
-			return 45.0f / (13.0f * (Real)M_PI * hh *h) *d;
-		}
-	}
-
-	template<typename Real, typename Coord>
+	template<typename Real, typename Coord, typename Kernel>
 	__global__ void IV_ApplyViscosity(
 		DArray<Coord> velNew,
 		DArray<Coord> posArr,
@@ -26,7 +15,8 @@ namespace dyno
 		DArrayList<int> neighbors,
 		Real viscosity,
 		Real smoothingLength,
-		Real dt)
+		Real dt,
+		Kernel kernel)
 	{
 		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
 		if (pId >= velNew.size()) return;
@@ -45,7 +35,7 @@ namespace dyno
 
 			if (r > EPSILON)
 			{
-				Real weight = IV_Weight(r, smoothingLength);
+				Real weight = kernel.weight(r);
 				totalWeight += weight;
 				dv_i += weight * velBuf[j];
 			}
@@ -107,7 +97,8 @@ namespace dyno
 				nbrIds,
 				vis,
 				h,
-				dt);
+				dt,
+				LinearKernelPolicy<Real>(h, Real(1)));
 		}
 	}
 
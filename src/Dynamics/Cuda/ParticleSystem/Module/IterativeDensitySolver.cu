@@ -38,9 +38,7 @@ namespace dyno
 		DArray<Real> rhoArr,
 		DArray<Coord> posArr,
 		DArrayList<int> neighbors,
-		Real smoothingLength,
-		Kernel gradient,
-		Real scale)
+		Kernel kernel)
 	{
 		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
 		if (pId >= posArr.size()) return;
@@ -59,7 +57,7 @@ namespace dyno
 
 			if (r > EPSILON)
 			{
-				Coord g = gradient(r, smoothingLength, scale) * (pos_i - posArr[j]) * (1.0f / r);
+				Coord g = kernel.gradient(r) * (pos_i - posArr[j]) * (1.0f / r);
 				grad_ci += g;
 				lamda_i += g.dot(g);
 			}
@@ -80,10 +78,8 @@ namespace dyno
 		DArray<Real> lambdas,
 		DArray<Coord> posArr,
 		DArrayList<int> neighbors,
-		Real smoothingLength,
 		Real dt,
-		Kernel gradient,
-		Real scale)
+		Kernel kernel)
 	{
 		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
 		if (pId >= posArr.size()) return;
@@ -100,7 +96,7 @@ namespace dyno
 			Real r = (pos_i - posArr[j]).norm();
 			if (r > EPSILON)
 			{
-				Coord dp_ij = 10.0f * (pos_i - posArr[j]) * (lamda_i + lambdas[j]) * gradient(r, smoothingLength, scale) * (1.0 / r);
+				Coord dp_ij = 10.0f * (pos_i - posArr[j]) * (lamda_i + lambdas[j]) * kernel.gradient(r) * (1.0 / r);
 				dP_i += dp_ij;
 
 				atomicAdd(&dPos[pId][0], dp_ij[0]);
@@ -176,23 +172,24 @@ namespace dyno
 		mDeltaPos.reset();
 		mSummation->varRestDensity()->setValue(this->varRestDensity()->getValue());
 		mSummation->varKernelType()->setCurrentKey(this->varKernelType()->currentKey());
+		mSummation->varTabulatedKernel()->setValue(this->varTabulatedKernel()->getValue());
 		mSummation->update();
 
-		cuFirstOrder(num, this->varKernelType()->getDataPtr()->currentKey(), this->mScalingFactor,
+		Real h = this->inSmoothingLength()->getValue();
+
+		cuKernelPolicy(num, h,
 			K_ComputeLambdas,
 			mLamda,
 			mSummation->outDensity()->getData(),
 			this->inPosition()->getData(),
-			this->inNeighborIds()->getData(),
-			this->inSmoothingLength()->getValue());
+			this->inNeighborIds()->getData());
 
-		cuFirstOrder(num, this->varKernelType()->getDataPtr()->currentKey(), this->mScalingFactor,
+		cuKernelPolicy(num, h,
 			K_ComputeDisplacement,
 			mDeltaPos,
 			mLamda,
 			this->inPosition()->getData(),
 			this->inNeighborIds()->getData(),
-			this->inSmoothingLength()->getData(),
 			dt);
 
 		cuExecute(num, K_UpdatePosition,
@@ -1,6 +1,7 @@
 #pragma once
 #include "Platform.h"
 #include "DeclareEnum.h"
+#include "Array/Array.h"
 
 namespace dyno {
 
@@ -334,4 +335,145 @@ namespace dyno {
 			}
 		}
 	};
+
+	/**
+	 * Kernel policies for a fixed smoothing length.
+	 *
+	 * The classes above take the smoothing length with every call and recompute the normalization per neighbor pair.
+	 * A policy is constructed once per launch on the host, keeps 1/h and the normalization, and is passed by value
+	 * into the kernel, where weight() and gradient() are inlined into the summation loop.
+	 */
+	template<typename Real>
+	struct SmoothKernelPolicy
+	{
+		DYN_FUNC SmoothKernelPolicy(const Real h, const Real scale)
+			: invH(Real(1) / h)
+			, norm(scale) {}
+
+		DYN_FUNC inline Real weight(const Real r) const
+		{
+			const Real q = r * invH;
+			return q > Real(1) ? Real(0) : norm * (Real(1) - q * q);
+		}
+
+		DYN_FUNC inline Real gradient(const Real r) const
+		{
+			const Real q = r * invH;
+			return q > Real(1) ? Real(0) : -norm * (Real(1) - q * q);
+		}
+
+		Real invH;
+		Real norm;
+	};
+
+	template<typename Real>
+	struct SpikyKernelPolicy
+	{
+		DYN_FUNC SpikyKernelPolicy(const Real h, const Real scale)
+			: invH(Real(1) / h)
+			, norm(Real(15) / ((Real)M_PI * h * h * h) * scale) {}
+
+		DYN_FUNC inline Real weight(const Real r) const
+		{
+			const Real q = r * invH;
+			const Real d = Real(1) - q;
+			return q > Real(1) ? Real(0) : norm * d * d * d;
+		}
+
+		DYN_FUNC inline Real gradient(const Real r) const
+		{
+			const Real q = r * invH;
+			const Real d = Real(1) - q;
+			return q > Real(1) ? Real(0) : Real(-3) * norm * d * d;
+		}
+
+		Real invH;
+		Real norm;
+	};
+
+	//linear falloff used to smooth the velocity field in ImplicitViscosity
+	template<typename Real>
+	struct LinearKernelPolicy
+	{
+		DYN_FUNC LinearKernelPolicy(const Real h, const Real scale)
+			: invH(Real(1) / h)
+			, norm(Real(45) / (Real(13) * (Real)M_PI * h * h * h) * scale) {}
+
+		DYN_FUNC inline Real weight(const Real r) const
+		{
+			const Real q = r * invH;
+			return q > Real(1) ? Real(0) : norm * (Real(1) - q);
+		}
+
+		DYN_FUNC inline Real gradient(const Real r) const
+		{
+			const Real q = r * invH;
+			return q > Real(1) ? Real(0) : -norm;
+		}
+
+		Real invH;
+		Real norm;
+	};
+
+	/**
+	 * @brief Weights and gradients of a kernel policy sampled at uniform steps of r in [0, h] and linearly interpolated,
+	 * 	the normalization is folded into the samples. Rebuild the tables whenever h or the scaling factor changes.
+	 */
+	template<typename Real>
+	struct TabulatedKernel
+	{
+		template<typename Policy>
+		void build(const Policy& policy, const Real h, const uint resolution = 1024)
+		{
+			std::vector<Real> w(resolution + 1);
+			std::vector<Real> g(resolution + 1);
+			for (uint i = 0; i <= resolution; i++)
+			{
+				Real r = h * Real(i) / Real(resolution);
+				w[i] = policy.weight(r);
+				g[i] = policy.gradient(r);
+			}
+
+			//the last sample is the value at the border of the support, the kernel is only zero beyond it
+			weights.assign(w);
+			gradients.assign(g);
+
+			invStep = Real(resolution) / h;
+			last = resolution;
+		}
+
+		void clear()
+		{
+			weights.clear();
+			gradients.clear();
+			last = 0;
+		}
+
+		GPU_FUNC inline Real weight(const Real r) const
+		{
+			return lookup(weights, r);
+		}
+
+		GPU_FUNC inline Real gradient(const Real r) const
+		{
+			return lookup(gradients, r);
+		}
+
+		GPU_FUNC inline Real lookup(const DArray<Real>& table, const Real r) const
+		{
+			const Real x = r * invStep;
+			if (last == 0 || x > Real(last)) return Real(0);
+
+			//r == h maps onto the last sample, as the policies are only zero beyond the support
+			const uint i = x < Real(last) ? (uint)x : last - 1;
+			const Real t = x - Real(i);
+			return table[i] + t * (table[i + 1] - table[i]);
+		}
+
+		DArray<Real> weights;
+		DArray<Real> gradients;
+
+		Real invStep = Real(0);
+		uint last = 0;
+	};
 }
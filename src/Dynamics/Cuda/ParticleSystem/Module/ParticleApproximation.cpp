@@ -25,6 +25,7 @@ namespace dyno
 	template<typename TDataType>
 	ParticleApproximation<TDataType>::~ParticleApproximation()
 	{
+		mTable.clear();
 	}
 
 	template<typename TDataType>
@@ -35,18 +36,9 @@ namespace dyno
 
 		Real V = d * d*d;
 
-		Kernel<Real>* kern;
-		switch (this->varKernelType()->currentKey())
-		{
-		case KT_Spiky:
-			kern = new SpikyKernel<Real>();
-			break;
-		case KT_Smooth:
-			kern = new SmoothKernel<Real>();
-			break;
-		default:
-			break;
-		}
+		int key = this->varKernelType()->currentKey();
+		SmoothKernelPolicy<Real> smooth(H, Real(1));
+		SpikyKernelPolicy<Real> spiky(H, Real(1));
 
 		Real total_weight(0);
 		int half_res = (int)(H / d + 1);
@@ -58,12 +50,29 @@ namespace dyno
 					Real y = j * d;
 					Real z = k * d;
 					Real r = sqrt(x * x + y * y + z * z);
-					total_weight += V * kern->Weight(r, H);
+					total_weight += V * (key == KT_Smooth ? smooth.weight(r) : spiky.weight(r));
 				}
 
 		mScalingFactor = Real(1) / total_weight;
+	}
+
+	template<typename TDataType>
+	TabulatedKernel<typename TDataType::Real>& ParticleApproximation<TDataType>::tabulatedKernel(Real h)
+	{
+		int key = this->varKernelType()->currentKey();
+		if (h != mTableLength || mScalingFactor != mTableScale || key != mTableKernel)
+		{
+			if (key == KT_Smooth)
+				mTable.build(SmoothKernelPolicy<Real>(h, mScalingFactor), h);
+			else
+				mTable.build(SpikyKernelPolicy<Real>(h, mScalingFactor), h);
+
+			mTableLength = h;
+			mTableScale = mScalingFactor;
+			mTableKernel = key;
+		}
 
-		delete kern;
+		return mTable;
 	}
 
 	DEFINE_CLASS(ParticleApproximation);
@@ -97,6 +97,28 @@ namespace dyno
 		cuSynchronize();												\
 	}
 
+/**
+ * Launches Func with a kernel policy as its last argument, the policy is chosen once per launch so that
+ * the summation loop inside Func is compiled without virtual calls or branches on the kernel type.
+ * Must be called inside a member function of ParticleApproximation.
+ */
+#define cuKernelPolicy(size, smoothingLength, Func,...){					\
+		uint pDims = cudaGridSize((uint)size, BLOCK_SIZE);				\
+		if (this->varTabulatedKernel()->getValue())						\
+		{																\
+			Func << <pDims, BLOCK_SIZE >> > (__VA_ARGS__, this->tabulatedKernel(smoothingLength));	\
+		}																\
+		else if (this->varKernelType()->currentKey() == 0)				\
+		{																\
+			Func << <pDims, BLOCK_SIZE >> > (__VA_ARGS__, SmoothKernelPolicy<Real>(smoothingLength, this->mScalingFactor));	\
+		}																\
+		else if (this->varKernelType()->currentKey() == 1)				\
+		{																\
+			Func << <pDims, BLOCK_SIZE >> > (__VA_ARGS__, SpikyKernelPolicy<Real>(smoothingLength, this->mScalingFactor));	\
+		}																\
+		cuSynchronize();												\
+	}
+
 	template<typename TDataType>
 	class ParticleApproximation : public ComputeModule
 	{
@@ -119,10 +141,24 @@ namespace dyno
 
 		DEF_ENUM(EKernelType, KernelType, EKernelType::KT_Spiky, "Rendering mode");
 
+		DEF_VAR(bool, TabulatedKernel, false, "Evaluate the kernel by interpolating precomputed tables");
+
 	protected:
+		/**
+		 * @brief Tables of the current kernel for the smoothing length h, rebuilt only if h, the kernel type
+		 * 	or the scaling factor changed since the last call
+		 */
+		TabulatedKernel<Real>& tabulatedKernel(Real h);
+
 		Real mScalingFactor = Real(1);
 
 	private:
 		void calculateScalingFactor();
+
+		TabulatedKernel<Real> mTable;
+
+		Real mTableLength = Real(0);
+		Real mTableScale = Real(0);
+		int mTableKernel = -1;
 	};
 }
\ No newline at end of file
@@ -57,10 +57,8 @@ namespace dyno
 		DArray<Real> rhoArr,
 		DArray<Coord> posArr,
 		DArrayList<int> neighbors,
-		Real smoothingLength,
 		Real mass,
-		Kernel weight,
-		Real scale)
+		Kernel kernel)
 	{
 		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
 		if (pId >= posArr.size()) return;
@@ -74,7 +72,7 @@ namespace dyno
 		{
 			int j = list_i[ne];
 			r = (pos_i - posArr[j]).norm();
-			rho_i += mass * weight(r, smoothingLength, scale);
+			rho_i += mass * kernel.weight(r);
 		}
 
 		rhoArr[pId] = rho_i;
@@ -86,10 +84,8 @@ namespace dyno
 		DArray<Coord> posArr,
 		DArray<Coord> posQueried,
 		DArrayList<int> neighbors,
-		Real smoothingLength,
 		Real mass,
-		Kernel weight,
-		Real scale)
+		Kernel kernel)
 	{
 		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
 		if (pId >= posArr.size()) return;
@@ -103,7 +99,7 @@ namespace dyno
 		{
 			int j = list_i[ne];
 			r = (pos_i - posQueried[j]).norm();
-			rho_i += mass * weight(r, smoothingLength, scale);
+			rho_i += mass * kernel.weight(r);
 		}
 
 		rhoArr[pId] = rho_i;
@@ -117,25 +113,23 @@ namespace dyno
 		Real smoothingLength,
 		Real mass)
 	{
-		cuZerothOrder(rho.size(), this->varKernelType()->getDataPtr()->currentKey(), this->mScalingFactor,
+		cuKernelPolicy(rho.size(), smoothingLength,
 			SD_ComputeDensity,
 			rho,
 			pos,
 			neighbors,
-			smoothingLength,
 			mass);
 	}
 
 	template<typename TDataType>
 	void SummationDensity<TDataType>::compute(DArray<Real>& rho, DArray<Coord>& pos, DArray<Coord>& posQueried, DArrayList<int>& neighbors, Real smoothingLength, Real mass)
 	{
-		cuZerothOrder(rho.size(), this->varKernelType()->getDataPtr()->currentKey(), this->mScalingFactor,
+		cuKernelPolicy(rho.size(), smoothingLength,
 			SD_ComputeDensity,
 			rho,
 			pos,
 			posQueried,
 			neighbors,
-			smoothingLength,
 			mass);
 	}
 
@@ -42,6 +42,12 @@ namespace dyno
 		m_r.clear();
 		m_p.clear();
 
+		mInvDiagonal.clear();
+		m_u.clear();
+		m_w.clear();
+		m_s.clear();
+		mDots.clear();
+
 		mPressure.clear();
 
 		if (m_reduce)
@@ -440,6 +446,100 @@ namespace dyno
 		}
 	}
 
+	template <typename Real>
+	__global__ void VC_ComputeInverseDiagonal
+	(
+		DArray<Real> invDiagonal,
+		DArray<Real> aii,
+		DArray<Attribute> attribute)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= invDiagonal.size()) return;
+
+		if (!attribute[pId].isDynamic())
+			invDiagonal[pId] = Real(0);
+		else
+			invDiagonal[pId] = aii[pId] > EPSILON ? Real(1) / aii[pId] : Real(1);
+	}
+
+	template <typename Real>
+	__global__ void VC_Precondition
+	(
+		DArray<Real> u,
+		DArray<Real> r,
+		DArray<Real> invDiagonal)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= u.size()) return;
+
+		u[pId] = invDiagonal[pId] * r[pId];
+	}
+
+	// p = u + beta * p, s = w + beta * s, x += alpha * p, r -= alpha * s, u = M^-1 r
+	template <typename Real>
+	__global__ void VC_PipelinedUpdate
+	(
+		DArray<Real> x,
+		DArray<Real> r,
+		DArray<Real> p,
+		DArray<Real> s,
+		DArray<Real> u,
+		DArray<Real> w,
+		DArray<Real> invDiagonal,
+		Real alpha,
+		Real beta)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= x.size()) return;
+
+		Real p_i = u[pId] + beta * p[pId];
+		Real s_i = w[pId] + beta * s[pId];
+		Real r_i = r[pId] - alpha * s_i;
+
+		p[pId] = p_i;
+		s[pId] = s_i;
+		x[pId] += alpha * p_i;
+		r[pId] = r_i;
+		u[pId] = invDiagonal[pId] * r_i;
+	}
+
+	// dots = ((r, u), (w, u), (r, r)), partial sums are reduced within each warp before being added to the global sum
+	template <typename Real>
+	__global__ void VC_FusedDots
+	(
+		DArray<Real> dots,
+		DArray<Real> r,
+		DArray<Real> u,
+		DArray<Real> w)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+
+		//All threads in a warp have to participate in the shuffle, do not return early
+		Real ru = 0;
+		Real wu = 0;
+		Real rr = 0;
+		if (pId < r.size())
+		{
+			ru = r[pId] * u[pId];
+			wu = w[pId] * u[pId];
+			rr = r[pId] * r[pId];
+		}
+
+		for (int offset = 16; offset > 0; offset /= 2)
+		{
+			ru += __shfl_down_sync(0xffffffff, ru, offset);
+			wu += __shfl_down_sync(0xffffffff, wu, offset);
+			rr += __shfl_down_sync(0xffffffff, rr, offset);
+		}
+
+		if ((threadIdx.x & 31) == 0)
+		{
+			atomicAdd(&dots[0], ru);
+			atomicAdd(&dots[1], wu);
+			atomicAdd(&dots[2], rr);
+		}
+	}
+
 	template <typename Real, typename Coord>
 	__global__ void VC_UpdateVelocity1rd
 	(
@@ -751,6 +851,151 @@ namespace dyno
 // 		return true;
 // 	}
 
+	template<typename TDataType>
+	void VariationalApproximateProjection<TDataType>::computeAx(DArray<Real>& Ax, DArray<Real>& x)
+	{
+		uint pDims = cudaGridSize(this->inPosition()->size(), BLOCK_SIZE);
+
+		Ax.reset();
+		VC_ComputeAx << <pDims, BLOCK_SIZE >> > (
+			Ax,
+			x,
+			mAii,
+			mAlpha,
+			this->inPosition()->getData(),
+			this->inAttribute()->getData(),
+			this->inNeighborIds()->getData(),
+			this->inSmoothingLength()->getData());
+	}
+
+	template<typename TDataType>
+	void VariationalApproximateProjection<TDataType>::solveCG()
+	{
+		uint maxIter = this->varMaxIterations()->getValue();
+
+		this->computeAx(m_y, mPressure);
+
+		m_r.reset();
+		Function2Pt::subtract(m_r, mDivergence, m_y);
+		m_p.assign(m_r);
+		Real rr = m_arithmetic->Dot(m_r, m_r);
+		Real err = sqrt(rr / m_r.size());
+
+		uint itor = 0;
+		while (itor < maxIter && err > 1.0f)
+		{
+			this->computeAx(m_y, m_p);
+
+			float alpha = rr / m_arithmetic->Dot(m_p, m_y);
+			Function2Pt::saxpy(mPressure, m_p, mPressure, alpha);
+			Function2Pt::saxpy(m_r, m_y, m_r, -alpha);
+
+			Real rr_old = rr;
+
+			rr = m_arithmetic->Dot(m_r, m_r);
+
+			Real beta = rr / rr_old;
+			Function2Pt::saxpy(m_p, m_p, m_r, beta);
+
+			err = sqrt(rr / m_r.size());
+
+			itor++;
+		}
+
+		mIterations = itor;
+	}
+
+	template<typename TDataType>
+	void VariationalApproximateProjection<TDataType>::solvePipelinedPCG()
+	{
+		uint num = mPressure.size();
+		uint pDims = cudaGridSize(num, BLOCK_SIZE);
+
+		uint maxIter = this->varMaxIterations()->getValue();
+		Real tol = this->varRelativeTolerance()->getValue();
+
+		VC_ComputeInverseDiagonal << <pDims, BLOCK_SIZE >> > (
+			mInvDiagonal,
+			mAii,
+			this->inAttribute()->getData());
+
+		//r = b - Ax, u = M^-1 r, w = Au
+		this->computeAx(m_y, mPressure);
+		Function2Pt::subtract(m_r, mDivergence, m_y);
+
+		VC_Precondition << <pDims, BLOCK_SIZE >> > (
+			m_u,
+			m_r,
+			mInvDiagonal);
+
+		this->computeAx(m_w, m_u);
+
+		CArray<Real> dots(3);
+		auto fusedDots = [&]() {
+			mDots.reset();
+			VC_FusedDots << <pDims, BLOCK_SIZE >> > (
+				mDots,
+				m_r,
+				m_u,
+				m_w);
+			dots.assign(mDots);
+		};
+
+		fusedDots();
+
+		Real gamma = dots[0];
+		Real delta = dots[1];
+		Real rr = dots[2];
+
+		Real bb = m_arithmetic->Dot(mDivergence, mDivergence);
+		Real threshold = tol * tol * bb;
+
+		m_p.reset();
+		m_s.reset();
+
+		Real alpha = delta > EPSILON ? gamma / delta : Real(0);
+		Real beta = Real(0);
+
+		uint itor = 0;
+		while (itor < maxIter && rr > threshold && alpha > Real(0))
+		{
+			VC_PipelinedUpdate << <pDims, BLOCK_SIZE >> > (
+				mPressure,
+				m_r,
+				m_p,
+				m_s,
+				m_u,
+				m_w,
+				mInvDiagonal,
+				alpha,
+				beta);
+
+			this->computeAx(m_w, m_u);
+
+			fusedDots();
+
+			Real gamma_new = dots[0];
+			delta = dots[1];
+			rr = dots[2];
+
+			if (gamma <= Real(0))
+				break;
+
+			beta = gamma_new / gamma;
+
+			Real denom = delta - beta * gamma_new / alpha;
+			alpha = std::abs(denom) > EPSILON ? gamma_new / denom : Real(0);
+
+			gamma = gamma_new;
+
+			itor++;
+		}
+
+		mIterations = itor;
+
+		dots.clear();
+	}
+
 	template<typename TDataType>
 	void VariationalApproximateProjection<TDataType>::constrain()
 	{
@@ -770,6 +1015,12 @@ namespace dyno
 			m_r.resize(num);
 			m_p.resize(num);
 
+			mInvDiagonal.resize(num);
+			m_u.resize(num);
+			m_w.resize(num);
+			m_s.resize(num);
+			mDots.resize(3);
+
 			mPressure.resize(num);
 
 //			m_normal.resize(num);
@@ -858,8 +1109,6 @@ namespace dyno
 			this->inSmoothingLength()->getData(),
 			mAMax);
 
-		int itor = 0;
-
 		//compute the source term
 		mDensityCalculator->compute();
 		mDivergence.reset();
@@ -888,52 +1137,10 @@ namespace dyno
 			dt);
 		
 		//solve the linear system of equations with a conjugate gradient method.
-		m_y.reset();
-		VC_ComputeAx << <pDims, BLOCK_SIZE >> > (
-			m_y, 
-			mPressure, 
-			mAii, 
-			mAlpha, 
-			this->inPosition()->getData(),
-			this->inAttribute()->getData(),
-			this->inNeighborIds()->getData(),
-			this->inSmoothingLength()->getData());
-
-		m_r.reset();
-		Function2Pt::subtract(m_r, mDivergence, m_y);
-		m_p.assign(m_r);
-		Real rr = m_arithmetic->Dot(m_r, m_r);
-		Real err = sqrt(rr / m_r.size());
-
-		while (itor < 1000 && err > 1.0f)
-		{
-			m_y.reset();
-			//VC_ComputeAx << <pDims, BLOCK_SIZE >> > (*yArr, *pArr, *aiiArr, *alphaArr, *posArr, *attArr, *neighborArr);
-			VC_ComputeAx << <pDims, BLOCK_SIZE >> > (
-				m_y, 
-				m_p, 
-				mAii, 
-				mAlpha, 
-				this->inPosition()->getData(),
-				this->inAttribute()->getData(),
-				this->inNeighborIds()->getData(),
-				this->inSmoothingLength()->getData());
-
-			float alpha = rr / m_arithmetic->Dot(m_p, m_y);
-			Function2Pt::saxpy(mPressure, m_p, mPressure, alpha);
-			Function2Pt::saxpy(m_r, m_y, m_r, -alpha);
-
-			Real rr_old = rr;
-
-			rr = m_arithmetic->Dot(m_r, m_r);
-
-			Real beta = rr / rr_old;
-			Function2Pt::saxpy(m_p, m_p, m_r, beta);
-
-			err = sqrt(rr / m_r.size());
-
-			itor++;
-		}
+		if (this->varPreconditioned()->getValue())
+			this->solvePipelinedPCG();
+		else
+			this->solveCG();
 
 		//update the each particle's velocity
 // 		VC_UpdateVelocityBoundaryCorrected << <pDims, BLOCK_SIZE >> > (
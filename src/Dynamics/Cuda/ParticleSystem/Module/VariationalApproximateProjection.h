@@ -46,9 +46,20 @@ namespace dyno
 		
 		void constrain() override;
 
+		/**
+		 * @brief Number of CG iterations taken by the last pressure solve
+		 */
+		uint getIterationNumber() const { return mIterations; }
+
 	public:
 		DEF_VAR(Real, RestDensity, Real(1000), "");
 
+		DEF_VAR(bool, Preconditioned, false, "Solve the pressure with a Jacobi preconditioned, pipelined CG instead of the plain CG");
+
+		DEF_VAR(Real, RelativeTolerance, Real(0.001), "The preconditioned solve stops once |r| < RelativeTolerance * |b|");
+
+		DEF_VAR(uint, MaxIterations, 1000, "Maximum number of CG iterations");
+
 		DEF_VAR_IN(Real, TimeStep, "Time step size");
 
 		DEF_VAR_IN(Real, SamplingDistance, "");
@@ -70,6 +81,19 @@ namespace dyno
 // 		bool initializeImpl() override;
 
 	private:
+		//Plain CG, iterates until the root mean square of the residual drops below 1
+		void solveCG();
+
+		/**
+		 * @brief Jacobi preconditioned CG in the Chronopoulos/Gear form, the three inner products of one iteration
+		 *		are computed in a single fused pass so that each iteration only requires one device-to-host copy.
+		 */
+		void solvePipelinedPCG();
+
+		void computeAx(DArray<Real>& Ax, DArray<Real>& x);
+
+		uint mIterations = 0;
+
 		Real mAlphaMax;
 		Real mAMax;
 		Real mAirPressure = 0.0f;
@@ -95,6 +119,13 @@ namespace dyno
 		DArray<Real> m_r;
 		DArray<Real> m_p;
 
+		//Additional variables used by the preconditioned solver
+		DArray<Real> mInvDiagonal;
+		DArray<Real> m_u;
+		DArray<Real> m_w;
+		DArray<Real> m_s;
+		DArray<Real> mDots;
+
 		Reduction<Real>* m_reduce;
 		Arithmetic<Real>* m_arithmetic;
 
@@ -26,6 +26,10 @@ namespace dyno
 		trueContact.clear();
 		trueContactCnt.clear();
 		Weight.clear();
+		mPairOffset.clear();
+		mTrianglePairs.clear();
+		mPrimitives.clear();
+		mPairCollided.clear();
 	}
 
 	template<typename Real, typename Coord, typename Triangle>
@@ -72,7 +76,7 @@ namespace dyno
 
 		Real len = (box.v0 - box.v1).norm();
 		//expend epsilon
-		box.v0 += corner1 * len;
+		box.v0 -= corner1 * len;
 		box.v1 += corner1 * len;
 
 		boundingBox[tId] = box;
@@ -94,65 +98,435 @@ namespace dyno
 	}
 
 
-	template<typename Coord, typename Triangle, typename Real>
-	__global__ void CR_Calculate_Timestep(
-		DArray<Real> timestep,
+	//Only valid for non-negative values, whose bit patterns preserve the ordering as signed integers
+	__device__ inline void CR_AtomicMin(float* address, float val)
+	{
+		atomicMin((int*)address, __float_as_int(val));
+	}
+
+	__device__ inline void CR_AtomicMin(double* address, double val)
+	{
+		atomicMin((long long*)address, __double_as_longlong(val));
+	}
+
+	template<typename Triangle>
+	__device__ bool CR_HasVertex(const Triangle& t, int v)
+	{
+		return t[0] == v || t[1] == v || t[2] == v;
+	}
+
+	template<typename Triangle>
+	__global__ void CR_CountTrianglePairs(
+		DArray<int> counter,
+		DArrayList<int> contactList,
+		DArray<Triangle> triangles)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= counter.size()) return;
+
+		List<int>& list_i = contactList[tId];
+		Triangle t_i = triangles[tId];
+
+		//Neighboring triangles are never tested
+		int num = 0;
+		for (int n = 0; n < list_i.size(); n++)
+		{
+			int j = list_i[n];
+			num += j > tId && !isTwoTriangleNeighoring(t_i, triangles[j]) ? 1 : 0;
+		}
+
+		counter[tId] = num;
+	}
+
+	template<typename Triangle>
+	__global__ void CR_SetupTrianglePairs(
+		DArray<Vec2u> pairs,
+		DArray<int> offset,
+		DArrayList<int> contactList,
+		DArray<Triangle> triangles)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= offset.size()) return;
+
+		List<int>& list_i = contactList[tId];
+		Triangle t_i = triangles[tId];
+
+		int start = offset[tId];
+		int shift = start;
+		for (int n = 0; n < list_i.size(); n++)
+		{
+			int j = list_i[n];
+			if (j > tId && !isTwoTriangleNeighoring(t_i, triangles[j]))
+			{
+				//Keep the pairs of each triangle sorted by the second triangle for CR_FindTrianglePair
+				int k = shift;
+				while (k > start && pairs[k - 1][1] > (uint)j)
+				{
+					pairs[k] = pairs[k - 1];
+					k--;
+				}
+
+				pairs[k] = Vec2u(tId, j);
+				shift++;
+			}
+		}
+	}
+
+	/**
+	 * Return the index of the triangle pair (a, b) in the list built by CR_SetupTrianglePairs,
+	 * or -1 if the broad phase did not report it or the two triangles are neighbors.
+	 * The pairs of each triangle are sorted by the second triangle, so a binary search is sufficient.
+	 */
+	__device__ int CR_FindTrianglePair(
+		DArray<Vec2u>& pairs,
+		DArray<int>& pairOffset,
+		int a,
+		int b)
+	{
+		if (a == b) return -1;
+		if (a > b) { int tmp = a; a = b; b = tmp; }
+
+		int lo = pairOffset[a];
+		int hi = uint(a + 1) < pairOffset.size() ? pairOffset[a + 1] : int(pairs.size());
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			uint j = pairs[mid][1];
+			if (j == (uint)b)
+				return mid;
+
+			if (j < (uint)b)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		return -1;
+	}
+
+	/**
+	 * Return true if the triangle contains the first (side = 0) or the second (side = 1) feature of the primitive.
+	 */
+	template<typename Triangle>
+	__device__ bool CR_ContainsFeature(const Triangle& t, const CCDPrimitive& prim, int side)
+	{
+		if (prim.type == CCD_VertexFace)
+		{
+			return side == 0 ?
+				CR_HasVertex(t, prim.v[0]) && CR_HasVertex(t, prim.v[1]) && CR_HasVertex(t, prim.v[2]) :
+				CR_HasVertex(t, prim.v[3]);
+		}
+
+		return side == 0 ?
+			CR_HasVertex(t, prim.v[0]) && CR_HasVertex(t, prim.v[1]) :
+			CR_HasVertex(t, prim.v[2]) && CR_HasVertex(t, prim.v[3]);
+	}
+
+	/**
+	 * Visit all triangle pairs of the broad phase that contain the primitive, i.e. one triangle
+	 * contains the first feature and the other one contains the second feature.
+	 * These are the pairs for which the per-triangle CCD would have tested the primitive.
+	 */
+	template<typename Triangle, typename Func>
+	__device__ void CR_ForEachPairOfPrimitive(
+		const CCDPrimitive& prim,
+		DArray<Triangle>& triangles,
+		DArrayList<int>& ver2tri,
+		DArray<Vec2u>& pairs,
+		DArray<int>& pairOffset,
+		Func func)
+	{
+		List<int>& list_a = ver2tri[prim.v[0]];
+		List<int>& list_b = ver2tri[prim.type == CCD_VertexFace ? prim.v[3] : prim.v[2]];
+
+		for (int n = 0; n < list_a.size(); n++)
+		{
+			int a = list_a[n];
+			if (!CR_ContainsFeature(triangles[a], prim, 0))
+				continue;
+
+			for (int m = 0; m < list_b.size(); m++)
+			{
+				int b = list_b[m];
+				if (!CR_ContainsFeature(triangles[b], prim, 1))
+					continue;
+
+				int pId = CR_FindTrianglePair(pairs, pairOffset, a, b);
+				if (pId >= 0)
+					func(pId, a, b);
+			}
+		}
+	}
+
+	/**
+	 * Conservative filter: AdditiveCCD only reports a collision once the gap d - xi has shrunk to s times
+	 * its initial value within the time step (or if the primitive starts closer than xi). The swept bounding boxes
+	 * give a lower bound of the distance during the whole time step, the distance between the first vertices
+	 * at the beginning of the time step an upper bound of the initial distance.
+	 * Returns true only if the primitive can not be reported by AdditiveCCD.
+	 */
+	template<typename Real, typename Coord>
+	__device__ bool CR_CanSkipPrimitive(
+		DArray<Coord>& vertexOld,
+		DArray<Coord>& vertexNew,
+		const int* a, int aNum,
+		const int* b, int bNum,
+		Real xi,
+		Real s)
+	{
+		Coord aMin = vertexOld[a[0]];
+		Coord aMax = aMin;
+		for (int n = 0; n < aNum; n++)
+		{
+			aMin = minimum(aMin, minimum(vertexOld[a[n]], vertexNew[a[n]]));
+			aMax = maximum(aMax, maximum(vertexOld[a[n]], vertexNew[a[n]]));
+		}
+
+		Coord bMin = vertexOld[b[0]];
+		Coord bMax = bMin;
+		for (int n = 0; n < bNum; n++)
+		{
+			bMin = minimum(bMin, minimum(vertexOld[b[n]], vertexNew[b[n]]));
+			bMax = maximum(bMax, maximum(vertexOld[b[n]], vertexNew[b[n]]));
+		}
+
+		Real dMin = Real(0);
+		for (int d = 0; d < 3; d++)
+		{
+			dMin = maximum(dMin, maximum(aMin[d] - bMax[d], bMin[d] - aMax[d]));
+		}
+
+		Real dInit = (vertexOld[a[0]] - vertexOld[b[0]]).norm();
+
+		return dMin > xi && dMin - xi > s * (dInit - xi);
+	}
+
+	/**
+	 * Enumerate the vertex-face and edge-edge primitives of a triangle pair. A primitive shared by several
+	 * triangle pairs is only generated by the pair with the smallest index.
+	 */
+	template<typename Real, typename Coord, typename Triangle, typename Func>
+	__device__ void CR_ForEachPrimitive(
+		int pId,
+		DArray<Vec2u>& pairs,
+		DArray<Triangle>& triangles,
+		DArrayList<int>& ver2tri,
+		DArray<int>& pairOffset,
+		DArray<Coord>& vertexOld,
+		DArray<Coord>& vertexNew,
+		Real xi,
+		Real s,
+		Func func)
+	{
+		Vec2u pair = pairs[pId];
+		Triangle t_i = triangles[pair[0]];
+		Triangle t_j = triangles[pair[1]];
+
+		auto isUnique = [&](const CCDPrimitive& prim) -> bool {
+			bool unique = true;
+			CR_ForEachPairOfPrimitive(prim, triangles, ver2tri, pairs, pairOffset,
+				[&](int id, int a, int b) {
+					unique = unique && id >= pId;
+				});
+			return unique;
+		};
+
+		int face_i[3] = { t_i[0], t_i[1], t_i[2] };
+		int face_j[3] = { t_j[0], t_j[1], t_j[2] };
+
+		//VF
+		for (int side = 0; side < 2; side++)
+		{
+			Triangle t_v = side == 0 ? t_i : t_j;
+			Triangle t_f = side == 0 ? t_j : t_i;
+			int* face = side == 0 ? face_j : face_i;
+
+			for (int k = 0; k < 3; k++)
+			{
+				int v = t_v[k];
+				if (CR_HasVertex(t_f, v) || CR_CanSkipPrimitive(vertexOld, vertexNew, face, 3, &v, 1, xi, s))
+					continue;
+
+				CCDPrimitive prim;
+				prim.type = CCD_VertexFace;
+				prim.v[0] = t_f[0];
+				prim.v[1] = t_f[1];
+				prim.v[2] = t_f[2];
+				prim.v[3] = v;
+				prim.pairId = pId;
+
+				if (isUnique(prim))
+					func(prim);
+			}
+		}
+
+		//EE
+		for (int k = 0; k < 3; k++)
+		{
+			int e_i[2] = { t_i[k], t_i[(k + 1) % 3] };
+			for (int m = 0; m < 3; m++)
+			{
+				int e_j[2] = { t_j[m], t_j[(m + 1) % 3] };
+				if (e_i[0] == e_j[0] || e_i[0] == e_j[1] || e_i[1] == e_j[0] || e_i[1] == e_j[1])
+					continue;
+
+				if (CR_CanSkipPrimitive(vertexOld, vertexNew, e_i, 2, e_j, 2, xi, s))
+					continue;
+
+				CCDPrimitive prim;
+				prim.type = CCD_EdgeEdge;
+				prim.v[0] = e_i[0];
+				prim.v[1] = e_i[1];
+				prim.v[2] = e_j[0];
+				prim.v[3] = e_j[1];
+				prim.pairId = pId;
+
+				if (isUnique(prim))
+					func(prim);
+			}
+		}
+	}
+
+	template<typename Real, typename Coord, typename Triangle>
+	__global__ void CR_CountPrimitives(
+		DArray<int> counter,
+		DArray<Vec2u> pairs,
+		DArray<Triangle> triangles,
+		DArrayList<int> ver2tri,
+		DArray<int> pairOffset,
 		DArray<Coord> vertexOld,
 		DArray<Coord> vertexNew,
+		Real xi,
+		Real s)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= pairs.size()) return;
+
+		int num = 0;
+		CR_ForEachPrimitive(pId, pairs, triangles, ver2tri, pairOffset, vertexOld, vertexNew, xi, s,
+			[&](const CCDPrimitive& prim) {
+				num++;
+			});
+
+		counter[pId] = num;
+	}
+
+	template<typename Real, typename Coord, typename Triangle>
+	__global__ void CR_SetupPrimitives(
+		DArray<CCDPrimitive> primitives,
+		DArray<int> offset,
+		DArray<Vec2u> pairs,
 		DArray<Triangle> triangles,
-		DArrayList<int> contactList,
-		Real thickness,
-		Real collisionRefactor,
-		DArrayList<int> trueContact,
-		DArray<uint> trueContactCnt)
+		DArrayList<int> ver2tri,
+		DArray<int> pairOffset,
+		DArray<Coord> vertexOld,
+		DArray<Coord> vertexNew,
+		Real xi,
+		Real s)
 	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= pairs.size()) return;
+
+		int shift = offset[pId];
+		CR_ForEachPrimitive(pId, pairs, triangles, ver2tri, pairOffset, vertexOld, vertexNew, xi, s,
+			[&](const CCDPrimitive& prim) {
+				primitives[shift] = prim;
+				shift++;
+			});
+	}
 
+	template<typename Real>
+	__global__ void CR_Init_Timestep(
+		DArray<Real> timestep)
+	{
 		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
 		if (tId >= timestep.size()) return;
 
-		Triangle t_i = triangles[tId];
-		List<int>& list_i = contactList[tId]; // vertex's in triangle list
-		int nbSize = list_i.size();
-		Real time = Real(1.0);
+		timestep[tId] = Real(1);
+	}
 
-		trueContactCnt[tId] = 0;
+	template<typename Real, typename Coord, typename Triangle>
+	__global__ void CR_Primitive_CCD(
+		DArray<Real> timestepOfTriangle,
+		DArray<int> pairCollided,
+		DArray<CCDPrimitive> primitives,
+		DArray<Vec2u> pairs,
+		DArray<Triangle> triangles,
+		DArrayList<int> ver2tri,
+		DArray<int> pairOffset,
+		DArray<Coord> vertexOld,
+		DArray<Coord> vertexNew,
+		Real thickness,
+		Real collisionRefactor)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= primitives.size()) return;
 
+		CCDPrimitive prim = primitives[pId];
+		Vec2u pair = pairs[prim.pairId];
 
+		Triangle t_i = triangles[pair[0]];
+		Triangle t_j = triangles[pair[1]];
+
+		//Use the same normalization as AdditiveCCD::TriangleCCD for the triangle pair
 		TTriangle3D<Real> tri_old_i(vertexOld[t_i[0]], vertexOld[t_i[1]], vertexOld[t_i[2]]);
 		TTriangle3D<Real> tri_new_i(vertexNew[t_i[0]], vertexNew[t_i[1]], vertexNew[t_i[2]]);
+		TTriangle3D<Real> tri_old_j(vertexOld[t_j[0]], vertexOld[t_j[1]], vertexOld[t_j[2]]);
+		TTriangle3D<Real> tri_new_j(vertexNew[t_j[0]], vertexNew[t_j[1]], vertexNew[t_j[2]]);
+
+		Real lmax = maximum(
+			maximum(tri_old_i.maximumEdgeLength(), tri_new_i.maximumEdgeLength()),
+			maximum(tri_old_j.maximumEdgeLength(), tri_new_j.maximumEdgeLength()));
+		if (lmax < REAL_EPSILON)
+			return;
 
-		List<int>& tContact = trueContact[tId];
+		Real invL = 1 / lmax;
 
-		for (int n = 0; n < nbSize; n++)
+		Coord x[4];
+		Coord y[4];
+		for (int k = 0; k < 4; k++)
 		{
-			int j = list_i[n];
-			Triangle t_j = triangles[j];
-
-			if (!isTwoTriangleNeighoring(t_i, t_j))
-			{
-				TTriangle3D<Real> tri_old_j(vertexOld[t_j[0]], vertexOld[t_j[1]], vertexOld[t_j[2]]);
-				TTriangle3D<Real> tri_new_j(vertexNew[t_j[0]], vertexNew[t_j[1]], vertexNew[t_j[2]]);
-
-				Real toi = Real(1.0);
-
-				auto ccdPhase = AdditiveCCD<Real>(thickness, collisionRefactor, 0.95);
-				bool collided = ccdPhase.TriangleCCD(tri_old_i, tri_new_i, tri_old_j, tri_new_j, toi);
-				
-				time = collided ? minimum(time, toi) : time;
-				if (collided) {
-					for (int index = 0; index < 3; ++index) {
-						tContact.insert(j);
-						trueContactCnt[tId] += 1;
-					}
-				}
-			}
+			x[k] = invL * vertexOld[prim.v[k]];
+			y[k] = invL * vertexNew[prim.v[k]];
 		}
 
-		timestep[tId] = time;
-		//if(time<1.0 && time>EPSILON)printf("contact %f\n",time);
-		
+		auto ccdPhase = AdditiveCCD<Real>(thickness, collisionRefactor, 0.95);
+
+		Real toi = Real(1);
+		bool collided = prim.type == CCD_VertexFace ?
+			ccdPhase.VertexFaceCCD(x[0], x[1], x[2], x[3], y[0], y[1], y[2], y[3], toi, invL) :
+			ccdPhase.EdgeEdgeCCD(x[0], x[1], x[2], x[3], y[0], y[1], y[2], y[3], toi, invL);
+
+		if (collided)
+		{
+			toi = minimum(maximum(toi, Real(0)), Real(1));
+
+			//The time of impact applies to all triangle pairs sharing the primitive
+			CR_ForEachPairOfPrimitive(prim, triangles, ver2tri, pairs, pairOffset,
+				[&](int id, int a, int b) {
+					CR_AtomicMin(&timestepOfTriangle[a], toi);
+					CR_AtomicMin(&timestepOfTriangle[b], toi);
+
+					pairCollided[id] = 1;
+				});
+		}
 	}
 
+	__global__ void CR_SetupTrueContact(
+		DArrayList<int> trueContact,
+		DArray<int> pairCollided,
+		DArray<Vec2u> pairs)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= pairs.size()) return;
+
+		if (pairCollided[pId] == 0) return;
+
+		Vec2u pair = pairs[pId];
+
+		trueContact[pair[0]].atomicInsert(pair[1]);
+		trueContact[pair[1]].atomicInsert(pair[0]);
+	}
 
 	template<typename Real>
 	__global__ void CR_Calculate_Timestep(
@@ -449,6 +823,104 @@ __global__ void CR_UpDate_Contact_Force(
 
 	
 
+	template<typename TDataType>
+	void ContactRule<TDataType>::computeTimeOfImpact(DArray<Real>& timestepOfTriangle, DArrayList<int>& cList, DArrayList<int>& ver2tri)
+	{
+		auto topo = this->inTriangularMesh()->getDataPtr();
+		auto& indices = topo->getTriangles();
+		int tNum = indices.size();
+
+		cuExecute(tNum,
+			CR_Init_Timestep,
+			timestepOfTriangle);
+
+		//Collect unique pairs of non-neighboring triangles from the broad phase
+		mPairOffset.resize(tNum);
+		cuExecute(tNum,
+			CR_CountTrianglePairs,
+			mPairOffset,
+			cList,
+			indices);
+
+		int pairNum = mReduce.accumulate(mPairOffset.begin(), mPairOffset.size());
+		mTrianglePairs.resize(pairNum);
+
+		if (pairNum > 0)
+		{
+			mScan.exclusive(mPairOffset);
+			cuExecute(tNum,
+				CR_SetupTrianglePairs,
+				mTrianglePairs,
+				mPairOffset,
+				cList,
+				indices);
+
+			Real thickness = this->inXi()->getData() * this->inUnit()->getData();
+			Real s = this->inS()->getData();
+			auto& vertexOld = this->inOldPosition()->getData();
+			auto& vertexNew = this->inNewPosition()->getData();
+
+			//Generate unique vertex-face and edge-edge primitives that survive the swept-AABB filter
+			DArray<int> counter(pairNum);
+			cuExecute(pairNum,
+				CR_CountPrimitives,
+				counter,
+				mTrianglePairs,
+				indices,
+				ver2tri,
+				mPairOffset,
+				vertexOld,
+				vertexNew,
+				thickness,
+				s);
+
+			int primNum = mReduce.accumulate(counter.begin(), counter.size());
+			mPrimitives.resize(primNum);
+
+			mPairCollided.resize(pairNum);
+			mPairCollided.reset();
+
+			if (primNum > 0)
+			{
+				mScan.exclusive(counter);
+				cuExecute(pairNum,
+					CR_SetupPrimitives,
+					mPrimitives,
+					counter,
+					mTrianglePairs,
+					indices,
+					ver2tri,
+					mPairOffset,
+					vertexOld,
+					vertexNew,
+					thickness,
+					s);
+
+				cuExecute(primNum,
+					CR_Primitive_CCD,
+					timestepOfTriangle,
+					mPairCollided,
+					mPrimitives,
+					mTrianglePairs,
+					indices,
+					ver2tri,
+					mPairOffset,
+					vertexOld,
+					vertexNew,
+					thickness,
+					s);
+			}
+
+			cuExecute(pairNum,
+				CR_SetupTrueContact,
+				this->trueContact,
+				mPairCollided,
+				mTrianglePairs);
+
+			counter.clear();
+		}
+	}
+
 	template<typename TDataType>
 	void ContactRule<TDataType>::constrain()
 	{
@@ -485,18 +957,12 @@ __global__ void CR_UpDate_Contact_Force(
 		DArray<Real> steplengthOfTriangle(tNum);
 		Real d_hat = Real((1.0+15*eps) * this->inXi()->getData() * this->inUnit()->getData());
 
+		this->computeTimeOfImpact(steplengthOfTriangle, cList, ver2tri);
+
 		cuExecute(tNum,
-			CR_Calculate_Timestep,
-			steplengthOfTriangle,
-			this->inOldPosition()->getData(),
-			this->inNewPosition()->getData(),
-			indices,
-			cList,
-			Real(this->inXi()->getData() * this->inUnit()->getData()),
-			this->inS()->getData(),
+			CR_Cnt,
 			this->trueContact,
-			this->trueContactCnt
-			);
+			this->trueContactCnt);
 		
 		cuExecute(vNum,
 			CR_Calculate_Timestep,
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "Collision/CollisionDetectionBroadPhase.h"
+#include "Algorithm/Scan.h"
 #include "Topology/TriangleSet.h"
 #include "Primitive/Primitive3D.h"
 #include "Module.h"
@@ -24,6 +25,25 @@ namespace dyno
 {
 	template<typename TDataType> class CollisionDetectionBroadPhase;
 
+	enum CCDPrimitiveType
+	{
+		CCD_VertexFace = 0,
+		CCD_EdgeEdge
+	};
+
+	/**
+	 * @brief A vertex-face or an edge-edge pair fed into the CCD narrow phase.
+	 *	For CCD_VertexFace, v[0..2] is the face and v[3] is the vertex;
+	 *	for CCD_EdgeEdge, [v[0], v[1]] and [v[2], v[3]] are the two edges.
+	 *	pairId indexes the triangle pair with the smallest index that contains the primitive.
+	 */
+	struct CCDPrimitive
+	{
+		int type;
+		int v[4];
+		int pairId;
+	};
+
 	template<typename TDataType>
 	class ContactRule : public  ConstraintModule
 	{
@@ -31,6 +51,7 @@ namespace dyno
 	public:
 		typedef typename TDataType::Real Real;
 		typedef typename TDataType::Coord Coord;
+		typedef typename TopologyModule::Triangle Triangle;
 
 		ContactRule();
 
@@ -64,7 +85,23 @@ namespace dyno
 		DEF_ARRAY_OUT(Real, Weight, DeviceType::GPU, "Weight");
 		Real weight;
 	private:
+		/**
+		 * @brief Run the CCD narrow phase on unique vertex-face and edge-edge primitives.
+		 *	A primitive shared by several non-neighboring triangle pairs is tested once,
+		 *	its time of impact is applied to all triangles of these pairs.
+		 */
+		void computeTimeOfImpact(DArray<Real>& timestepOfTriangle, DArrayList<int>& cList, DArrayList<int>& ver2tri);
+
 		std::shared_ptr<CollisionDetectionBroadPhase<TDataType>> mBroadPhaseCD;
+
+		DArray<int> mPairOffset;
+		DArray<Vec2u> mTrianglePairs;
+		DArray<CCDPrimitive> mPrimitives;
+		DArray<int> mPairCollided;
+
+		Scan<int> mScan;
+		Reduction<int> mReduce;
+
 		DArrayList<Coord> firstTri;
 		DArrayList<Coord> secondTri;
 		DArrayList<int> trueContact;
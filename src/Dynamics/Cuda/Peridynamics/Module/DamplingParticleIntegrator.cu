@@ -165,8 +165,9 @@ namespace dyno
 	{
 		Real dt = this->inTimeStep()->getData();
 
-		auto scn = dyno::SceneGraphFactory::instance()->active();
-		Coord gravity = scn->getGravity();
+		//Gravity of the scene graph the node belongs to, scene graphs stepped concurrently may differ
+		SceneGraph* scn = this->getSceneGraph();
+		Coord gravity = scn != nullptr ? scn->getGravity() : dyno::SceneGraphFactory::instance()->active()->getGravity();
 
 		int total_num = this->inPosition()->size();
 
@@ -0,0 +1,479 @@
+#include "SparseBrickSDF.h"
+
+#include "Algorithm/Reduction.h"
+#include "Algorithm/Scan.h"
+
+namespace dyno
+{
+	template<typename TDataType>
+	SparseBrickSDF<TDataType>::SparseBrickSDF()
+	{
+	}
+
+	template<typename TDataType>
+	SparseBrickSDF<TDataType>::~SparseBrickSDF()
+	{
+	}
+
+	template<typename TDataType>
+	void SparseBrickSDF<TDataType>::release()
+	{
+		m_brickIndex.clear();
+		m_bricks.clear();
+		m_values.clear();
+	}
+
+	/**
+	 * Ray parity test along the three positive axes, the majority vote makes the test robust to rays
+	 * passing exactly through edges or vertices of the mesh.
+	 */
+	template<typename TDataType, typename Coord, typename Triangle>
+	GPU_FUNC bool SBS_IsInside(
+		Coord p,
+		Coord upper,
+		LinearBVH<TDataType>& bvh,
+		DArray<Coord>& points,
+		DArray<Triangle>& triangles)
+	{
+		typedef typename TDataType::Real Real;
+
+		int oddNum = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			Coord dir(0);
+			dir[axis] = Real(1);
+
+			Coord end = p;
+			end[axis] = maximum(p[axis], upper[axis]);
+
+			TRay3D<Real> ray(p, dir);
+			TAlignedBox3D<Real> box(p, end);
+
+			int num = 0;
+			bvh.traverse(box, [&](int triId) {
+				Triangle t = triangles[triId];
+				TTriangle3D<Real> tri(points[t[0]], points[t[1]], points[t[2]]);
+
+				TPoint3D<Real> q;
+				num += ray.intersect(tri, q);
+			});
+
+			oddNum += num % 2;
+		}
+
+		return oddNum >= 2;
+	}
+
+	template<typename Real, typename Coord, typename Triangle, typename AABB>
+	__global__ void SBS_SetupAABB(
+		DArray<AABB> aabbs,
+		DArray<Coord> points,
+		DArray<Triangle> triangles,
+		Real bandWidth)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= triangles.size()) return;
+
+		Triangle t = triangles[tId];
+		Coord v0 = points[t[0]];
+		Coord v1 = points[t[1]];
+		Coord v2 = points[t[2]];
+
+		AABB box;
+		box.v0 = minimum(v0, minimum(v1, v2)) - bandWidth;
+		box.v1 = maximum(v0, maximum(v1, v2)) + bandWidth;
+
+		aabbs[tId] = box;
+	}
+
+	template<typename Real, typename Coord, typename AABB>
+	__global__ void SBS_MarkBricks(
+		DArray<int> mask,
+		DArray<AABB> aabbs,
+		Coord origin,
+		Real h,
+		Vec3i nodeNum,
+		Vec3i brickNum,
+		int B)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= aabbs.size()) return;
+
+		AABB box = aabbs[tId];
+		Coord lo = (box.v0 - origin) / h;
+		Coord hi = (box.v1 - origin) / h;
+
+		Vec3i bLo, bHi;
+		for (int d = 0; d < 3; d++)
+		{
+			bLo[d] = clamp(int(floor(lo[d])), 0, nodeNum[d] - 1) / B;
+			bHi[d] = clamp(int(ceil(hi[d])), 0, nodeNum[d] - 1) / B;
+		}
+
+		for (int k = bLo[2]; k <= bHi[2]; k++) {
+			for (int j = bLo[1]; j <= bHi[1]; j++) {
+				for (int i = bLo[0]; i <= bHi[0]; i++) {
+					mask[k * brickNum[0] * brickNum[1] + j * brickNum[0] + i] = 1;
+				}
+			}
+		}
+	}
+
+	template<typename TDataType, typename Real, typename Coord, typename Triangle>
+	__global__ void SBS_SetupBricks(
+		DArray<int> brickIndex,
+		DArray<Vec3i> bricks,
+		DArray<int> mask,
+		DArray<int> offset,
+		LinearBVH<TDataType> bvh,
+		DArray<Coord> points,
+		DArray<Triangle> triangles,
+		Coord origin,
+		Coord upper,
+		Real h,
+		Vec3i brickNum)
+	{
+		int bId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (bId >= brickIndex.size()) return;
+
+		const int B = SparseBrickSDF<TDataType>::BRICK_WIDTH;
+
+		int i = bId % brickNum[0];
+		int j = (bId / brickNum[0]) % brickNum[1];
+		int k = bId / (brickNum[0] * brickNum[1]);
+
+		if (mask[bId] == 1)
+		{
+			brickIndex[bId] = offset[bId];
+			bricks[offset[bId]] = Vec3i(i, j, k);
+		}
+		else
+		{
+			//The whole brick lies on one side of the surface, test its center only
+			Coord center = origin + h * Coord((i + Real(0.5)) * B, (j + Real(0.5)) * B, (k + Real(0.5)) * B);
+			brickIndex[bId] = SBS_IsInside(center, upper, bvh, points, triangles) ?
+				SparseBrickSDF<TDataType>::BRICK_INSIDE : SparseBrickSDF<TDataType>::BRICK_OUTSIDE;
+		}
+	}
+
+	template<typename TDataType, typename Real, typename Coord, typename Triangle>
+	__global__ void SBS_ComputeValues(
+		DArray<Real> values,
+		DArray<Vec3i> bricks,
+		LinearBVH<TDataType> bvh,
+		DArray<Coord> points,
+		DArray<Triangle> triangles,
+		Coord origin,
+		Coord upper,
+		Real h,
+		Real bandWidth)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= values.size()) return;
+
+		const int B = SparseBrickSDF<TDataType>::BRICK_WIDTH;
+		const int B3 = SparseBrickSDF<TDataType>::BRICK_VOLUME;
+
+		Vec3i brick = bricks[tId / B3];
+		int local = tId % B3;
+
+		int i = brick[0] * B + local % B;
+		int j = brick[1] * B + (local / B) % B;
+		int k = brick[2] * B + local / (B * B);
+
+		Coord p = origin + h * Coord(i, j, k);
+		TPoint3D<Real> pt(p);
+
+		//Exact unsigned distance to the triangles inside the band
+		Real dist = bandWidth;
+		TAlignedBox3D<Real> box(p - bandWidth, p + bandWidth);
+		bvh.traverse(box, [&](int triId) {
+			Triangle t = triangles[triId];
+			TTriangle3D<Real> tri(points[t[0]], points[t[1]], points[t[2]]);
+
+			dist = minimum(dist, abs(pt.distance(tri)));
+		});
+
+		values[tId] = SBS_IsInside(p, upper, bvh, points, triangles) ? -dist : dist;
+	}
+
+	template<typename TDataType>
+	void SparseBrickSDF<TDataType>::construct(
+		DArray<Coord>& points,
+		DArray<Triangle>& triangles,
+		Coord origin,
+		Real h,
+		int nx,
+		int ny,
+		int nz,
+		Real bandWidth)
+	{
+		m_origin = origin;
+		m_h = h;
+		m_nx = nx;
+		m_ny = ny;
+		m_nz = nz;
+
+		//Zero crossings must stay inside active bricks
+		m_bandWidth = maximum(bandWidth, 2 * h);
+
+		m_bnx = (nx + BRICK_WIDTH - 1) / BRICK_WIDTH;
+		m_bny = (ny + BRICK_WIDTH - 1) / BRICK_WIDTH;
+		m_bnz = (nz + BRICK_WIDTH - 1) / BRICK_WIDTH;
+
+		uint triNum = triangles.size();
+		if (triNum == 0)
+		{
+			//Treat the whole domain as empty
+			m_nx = m_ny = m_nz = 0;
+			this->release();
+			return;
+		}
+
+		int brickTotal = m_bnx * m_bny * m_bnz;
+		m_brickIndex.resize(brickTotal);
+
+		Coord upper = origin + h * Coord(nx - 1, ny - 1, nz - 1);
+
+		DArray<TAlignedBox3D<Real>> aabbs(triNum);
+		cuExecute(triNum,
+			SBS_SetupAABB,
+			aabbs,
+			points,
+			triangles,
+			m_bandWidth);
+
+		LinearBVH<TDataType> bvh;
+		bvh.construct(aabbs);
+
+		DArray<int> mask(brickTotal);
+		mask.reset();
+		cuExecute(triNum,
+			SBS_MarkBricks,
+			mask,
+			aabbs,
+			origin,
+			h,
+			Vec3i(nx, ny, nz),
+			Vec3i(m_bnx, m_bny, m_bnz),
+			BRICK_WIDTH);
+
+		Reduction<int> reduce;
+		int activeNum = reduce.accumulate(mask.begin(), mask.size());
+
+		DArray<int> offset;
+		offset.assign(mask);
+
+		Scan<int> scan;
+		scan.exclusive(offset);
+
+		m_bricks.resize(activeNum);
+		cuExecute(brickTotal,
+			SBS_SetupBricks,
+			m_brickIndex,
+			m_bricks,
+			mask,
+			offset,
+			bvh,
+			points,
+			triangles,
+			origin,
+			upper,
+			h,
+			Vec3i(m_bnx, m_bny, m_bnz));
+
+		m_values.resize(activeNum * BRICK_VOLUME);
+		cuExecute(m_values.size(),
+			SBS_ComputeValues,
+			m_values,
+			m_bricks,
+			bvh,
+			points,
+			triangles,
+			origin,
+			upper,
+			h,
+			m_bandWidth);
+
+		aabbs.clear();
+		mask.clear();
+		offset.clear();
+		bvh.release();
+	}
+
+	template<typename Real, typename Coord>
+	DYN_FUNC void SBS_CellVertices(Coord* v, Coord p, Real h)
+	{
+		v[0] = p;
+		v[1] = p + Coord(h, 0, 0);
+		v[2] = p + Coord(h, h, 0);
+		v[3] = p + Coord(0, h, 0);
+		v[4] = p + Coord(0, 0, h);
+		v[5] = p + Coord(h, 0, h);
+		v[6] = p + Coord(h, h, h);
+		v[7] = p + Coord(0, h, h);
+	}
+
+	template<typename TDataType, typename Real>
+	GPU_FUNC bool SBS_CellValues(Real* val, SparseBrickSDF<TDataType>& sdf, DArray<Vec3i>& bricks, int tId)
+	{
+		const int B = SparseBrickSDF<TDataType>::BRICK_WIDTH;
+		const int B3 = SparseBrickSDF<TDataType>::BRICK_VOLUME;
+
+		Vec3i brick = bricks[tId / B3];
+		int local = tId % B3;
+
+		int i = brick[0] * B + local % B;
+		int j = brick[1] * B + (local / B) % B;
+		int k = brick[2] * B + local / (B * B);
+
+		int nx, ny, nz;
+		sdf.getGrid(nx, ny, nz);
+		if (i >= nx - 1 || j >= ny - 1 || k >= nz - 1)
+			return false;
+
+		val[0] = sdf.getNodeValue(i, j, k);
+		val[1] = sdf.getNodeValue(i + 1, j, k);
+		val[2] = sdf.getNodeValue(i + 1, j + 1, k);
+		val[3] = sdf.getNodeValue(i, j + 1, k);
+		val[4] = sdf.getNodeValue(i, j, k + 1);
+		val[5] = sdf.getNodeValue(i + 1, j, k + 1);
+		val[6] = sdf.getNodeValue(i + 1, j + 1, k + 1);
+		val[7] = sdf.getNodeValue(i, j + 1, k + 1);
+
+		return true;
+	}
+
+	template<typename TDataType, typename Real>
+	__global__ void SBS_CountCutCells(
+		DArray<int> counter,
+		DArray<Vec3i> bricks,
+		SparseBrickSDF<TDataType> sdf,
+		Real isoValue)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= counter.size()) return;
+
+		Real val[8];
+		if (!SBS_CellValues(val, sdf, bricks, tId))
+		{
+			counter[tId] = 0;
+			return;
+		}
+
+		int below = 0;
+		for (int n = 0; n < 8; n++)
+			below += val[n] < isoValue ? 1 : 0;
+
+		counter[tId] = (below > 0 && below < 8) ? 1 : 0;
+	}
+
+	template<typename TDataType, typename Real, typename Coord>
+	__global__ void SBS_SetupCutCells(
+		DArray<Coord> vertices,
+		DArray<Real> sdfs,
+		DArray<int> counter,
+		DArray<int> offset,
+		DArray<Vec3i> bricks,
+		SparseBrickSDF<TDataType> sdf)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= counter.size()) return;
+
+		if (counter[tId] == 0) return;
+
+		const int B = SparseBrickSDF<TDataType>::BRICK_WIDTH;
+		const int B3 = SparseBrickSDF<TDataType>::BRICK_VOLUME;
+
+		Vec3i brick = bricks[tId / B3];
+		int local = tId % B3;
+
+		int i = brick[0] * B + local % B;
+		int j = brick[1] * B + (local / B) % B;
+		int k = brick[2] * B + local / (B * B);
+
+		Real h = sdf.getDx();
+		int vIdx = 8 * offset[tId];
+
+		SBS_CellVertices(&vertices[vIdx], sdf.getOrigin() + h * Coord(i, j, k), h);
+		SBS_CellValues(&sdfs[vIdx], sdf, bricks, tId);
+	}
+
+	template<typename TDataType>
+	void SparseBrickSDF<TDataType>::getCellVertices(DArray<Coord>& vertices, DArray<Real>& sdfs, Real isoValue)
+	{
+		uint cellNum = m_values.size();
+		if (cellNum == 0)
+		{
+			vertices.clear();
+			sdfs.clear();
+			return;
+		}
+
+		DArray<int> counter(cellNum);
+		cuExecute(cellNum,
+			SBS_CountCutCells,
+			counter,
+			m_bricks,
+			*this,
+			isoValue);
+
+		Reduction<int> reduce;
+		int cutNum = reduce.accumulate(counter.begin(), counter.size());
+
+		DArray<int> offset;
+		offset.assign(counter);
+
+		Scan<int> scan;
+		scan.exclusive(offset);
+
+		vertices.resize(8 * cutNum);
+		sdfs.resize(8 * cutNum);
+
+		cuExecute(cellNum,
+			SBS_SetupCutCells,
+			vertices,
+			sdfs,
+			counter,
+			offset,
+			m_bricks,
+			*this);
+
+		counter.clear();
+		offset.clear();
+	}
+
+	template<typename TDataType, typename Real, typename Coord>
+	__global__ void SBS_GetSignDistance(
+		DArray<Real> sdfs,
+		DArray<Coord> normals,
+		DArray<Coord> points,
+		SparseBrickSDF<TDataType> sdf)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= points.size()) return;
+
+		Real d;
+		Coord n;
+		sdf.getDistance(points[tId], d, n);
+
+		sdfs[tId] = d;
+		normals[tId] = n;
+	}
+
+	template<typename TDataType>
+	void SparseBrickSDF<TDataType>::getSignDistance(DArray<Coord>& points, DArray<Real>& sdfs, DArray<Coord>& normals)
+	{
+		sdfs.resize(points.size());
+		normals.resize(points.size());
+
+		cuExecute(points.size(),
+			SBS_GetSignDistance,
+			sdfs,
+			normals,
+			points,
+			*this);
+	}
+
+	DEFINE_CLASS(SparseBrickSDF);
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include "Module/TopologyModule.h"
+#include "Topology/TriangleSet.h"
+#include "Topology/LinearBVH.h"
+
+#include "Primitive/Primitive3D.h"
+#include "Vector.h"
+
+namespace dyno
+{
+	/**
+	 * @brief A narrow band signed distance field stored in sparse bricks.
+	 *
+	 *	The virtual node grid is split into bricks of BRICK_WIDTH^3 nodes, only bricks touching the band
+	 *	around the surface allocate node values. Distances inside the band are exact, beyond the band they are
+	 *	clamped to +/- the band width. Inactive bricks only store whether they lie inside or outside the surface.
+	 */
+	template<typename TDataType>
+	class SparseBrickSDF
+	{
+	public:
+		typedef typename TDataType::Real Real;
+		typedef typename TDataType::Coord Coord;
+		typedef typename TopologyModule::Triangle Triangle;
+
+		static const int BRICK_WIDTH = 8;
+		static const int BRICK_VOLUME = BRICK_WIDTH * BRICK_WIDTH * BRICK_WIDTH;
+
+		//Values stored in the brick index for inactive bricks
+		static const int BRICK_OUTSIDE = -1;
+		static const int BRICK_INSIDE = -2;
+
+		SparseBrickSDF();
+
+		/**
+		 * @brief Should not release data here, call release() explicitly.
+		 *		The field is passed by value to kernels.
+		 */
+		~SparseBrickSDF();
+
+		void release();
+
+		/**
+		 * @brief Build the narrow band from a closed triangle mesh
+		 *
+		 * @param origin position of node (0, 0, 0)
+		 * @param h grid spacing
+		 * @param nx, ny, nz number of nodes along each axis
+		 * @param bandWidth half width of the narrow band, at least two grid spacings are used
+		 */
+		void construct(
+			DArray<Coord>& points,
+			DArray<Triangle>& triangles,
+			Coord origin,
+			Real h,
+			int nx,
+			int ny,
+			int nz,
+			Real bandWidth);
+
+		/**
+		 * @brief Export all cells in active bricks that are cut by the iso surface,
+		 *		eight vertices and values per cell in the layout used by MarchingCubesHelper::constructTrianglesForOctree
+		 */
+		void getCellVertices(DArray<Coord>& vertices, DArray<Real>& sdfs, Real isoValue);
+
+		void getSignDistance(DArray<Coord>& points, DArray<Real>& sdfs, DArray<Coord>& normals);
+
+		GPU_FUNC Real getNodeValue(int i, int j, int k) const
+		{
+			i = clamp(i, 0, m_nx - 1);
+			j = clamp(j, 0, m_ny - 1);
+			k = clamp(k, 0, m_nz - 1);
+
+			int bId = m_brickIndex[(k / BRICK_WIDTH) * m_bnx * m_bny + (j / BRICK_WIDTH) * m_bnx + i / BRICK_WIDTH];
+			if (bId == BRICK_INSIDE) return -m_bandWidth;
+			if (bId == BRICK_OUTSIDE) return m_bandWidth;
+
+			int local = ((k % BRICK_WIDTH) * BRICK_WIDTH + j % BRICK_WIDTH) * BRICK_WIDTH + i % BRICK_WIDTH;
+			return m_values[bId * BRICK_VOLUME + local];
+		}
+
+		GPU_FUNC void getDistance(const Coord& p, Real& d, Coord& normal) const;
+
+		DYN_FUNC inline Coord getOrigin() const { return m_origin; }
+		DYN_FUNC inline Real getDx() const { return m_h; }
+		DYN_FUNC inline Real getBandWidth() const { return m_bandWidth; }
+		DYN_FUNC inline void getGrid(int& nx, int& ny, int& nz) const { nx = m_nx; ny = m_ny; nz = m_nz; }
+
+		uint getBrickNumber() { return m_bricks.size(); }
+
+		DArray<int>& getBrickIndex() { return m_brickIndex; }
+		DArray<Vec3i>& getBricks() { return m_bricks; }
+		DArray<Real>& getValues() { return m_values; }
+
+	private:
+		GPU_FUNC inline Real lerp(Real a, Real b, Real alpha) const {
+			return (1.0f - alpha) * a + alpha * b;
+		}
+
+		Coord m_origin;
+		Real m_h = Real(1);
+		Real m_bandWidth = Real(0);
+
+		int m_nx = 0;
+		int m_ny = 0;
+		int m_nz = 0;
+
+		int m_bnx = 0;
+		int m_bny = 0;
+		int m_bnz = 0;
+
+		//Dense index over bricks, either the location of an active brick in m_bricks or BRICK_INSIDE/BRICK_OUTSIDE
+		DArray<int> m_brickIndex;
+
+		//Brick coordinates of active bricks
+		DArray<Vec3i> m_bricks;
+
+		//Node values of active bricks, BRICK_VOLUME values per brick
+		DArray<Real> m_values;
+	};
+
+	template<typename TDataType>
+	GPU_FUNC void SparseBrickSDF<TDataType>::getDistance(const Coord& p, Real& d, Coord& normal) const
+	{
+		Coord fp = (p - m_origin) / m_h;
+		const int i = (int)floor(fp[0]);
+		const int j = (int)floor(fp[1]);
+		const int k = (int)floor(fp[2]);
+		if (i < 0 || i >= m_nx - 1 || j < 0 || j >= m_ny - 1 || k < 0 || k >= m_nz - 1) {
+			d = m_bandWidth;
+			normal = Coord(0);
+			return;
+		}
+
+		Coord alphav = fp - Coord(i, j, k);
+		Real alpha = alphav[0];
+		Real beta = alphav[1];
+		Real gamma = alphav[2];
+
+		Real d000 = getNodeValue(i, j, k);
+		Real d100 = getNodeValue(i + 1, j, k);
+		Real d010 = getNodeValue(i, j + 1, k);
+		Real d110 = getNodeValue(i + 1, j + 1, k);
+		Real d001 = getNodeValue(i, j, k + 1);
+		Real d101 = getNodeValue(i + 1, j, k + 1);
+		Real d011 = getNodeValue(i, j + 1, k + 1);
+		Real d111 = getNodeValue(i + 1, j + 1, k + 1);
+
+		Real dx00 = lerp(d000, d100, alpha);
+		Real dx10 = lerp(d010, d110, alpha);
+		Real dxy0 = lerp(dx00, dx10, beta);
+
+		Real dx01 = lerp(d001, d101, alpha);
+		Real dx11 = lerp(d011, d111, alpha);
+		Real dxy1 = lerp(dx01, dx11, beta);
+
+		Real d0y0 = lerp(d000, d010, beta);
+		Real d0y1 = lerp(d001, d011, beta);
+		Real d0yz = lerp(d0y0, d0y1, gamma);
+
+		Real d1y0 = lerp(d100, d110, beta);
+		Real d1y1 = lerp(d101, d111, beta);
+		Real d1yz = lerp(d1y0, d1y1, gamma);
+
+		Real dx0z = lerp(dx00, dx01, gamma);
+		Real dx1z = lerp(dx10, dx11, gamma);
+
+		normal[0] = d1yz - d0yz;
+		normal[1] = dx1z - dx0z;
+		normal[2] = dxy1 - dxy0;
+
+		Real l = normal.norm();
+		if (l < 0.0001f) normal = Coord(0);
+		else normal = normal.normalize();
+
+		d = (1.0f - gamma) * dxy0 + gamma * dxy1;
+	}
+}
@@ -48,6 +48,7 @@ namespace dyno
 	template<typename TDataType>
 	VolumeUniformGenerator<TDataType>::~VolumeUniformGenerator()
 	{
+		m_sparseSDF.release();
 	}
 
 	template<typename TDataType>
@@ -128,6 +129,14 @@ namespace dyno
 		point_sdf.resize(point_pos.size());
 		//std::printf("getSignDistance : the number of leafs is: %d \n", point_sdf.size());
 
+		if (this->varNarrowBand()->getValue())
+		{
+			DArray<Coord> normals;
+			m_sparseSDF.getSignDistance(point_pos, point_sdf, normals);
+			normals.clear();
+			return;
+		}
+
 		cuExecute(point_pos.size(),
 			SO_GetSignDistance,
 			point_sdf,
@@ -449,6 +458,40 @@ namespace dyno
 		}
 	}
 
+	template <typename Real, typename TDataType>
+	__global__ void SO_DensifyNarrowBand(
+		DArray<Real> grids_value,
+		SparseBrickSDF<TDataType> sdf,
+		int nx_,
+		int ny_,
+		int nz_)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= grids_value.size()) return;
+
+		int i = tId % nx_;
+		int j = (tId / nx_) % ny_;
+		int k = tId / (nx_ * ny_);
+
+		//Nodes of the sparse field coincide with the cell centers, cells outside the band are clamped to +/- band width
+		grids_value[tId] = sdf.getNodeValue(i, j, k);
+	}
+
+	template<typename TDataType>
+	void VolumeUniformGenerator<TDataType>::densifyNarrowBand()
+	{
+		auto& sdf_val = this->stateSDFTopology()->getDataPtr()->getSdfValues();
+		sdf_val.resize(m_nx * m_ny * m_nz);
+
+		cuExecute(sdf_val.size(),
+			SO_DensifyNarrowBand,
+			sdf_val,
+			m_sparseSDF,
+			m_nx,
+			m_ny,
+			m_nz);
+	}
+
 	template<typename TDataType>
 	void VolumeUniformGenerator<TDataType>::resetStates()
 	{
@@ -461,6 +504,28 @@ namespace dyno
 		auto& triangles = triSet->getTriangles();
 		auto& points = triSet->getPoints();
 
+		if (this->varNarrowBand()->getValue())
+		{
+			//Values are sampled at cell centers to stay consistent with the dense grid
+			m_sparseSDF.construct(
+				points,
+				triangles,
+				m_origin + Real(0.5) * m_dx * Coord(1, 1, 1),
+				m_dx,
+				m_nx,
+				m_ny,
+				m_nz,
+				this->varBandWidth()->getValue() * m_dx);
+
+			//The dense grid scales with the volume, it is only built on request
+			if (this->varDenseOutput()->getValue())
+				densifyNarrowBand();
+			else
+				this->stateSDFTopology()->getDataPtr()->getSdfValues().clear();
+
+			return;
+		}
+
 		int nxyz = m_nx * m_ny*m_nz;
 		DArray<Real> grids_value;
 		DArray<int> grids_surface;
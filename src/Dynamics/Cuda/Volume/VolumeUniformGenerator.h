@@ -16,6 +16,7 @@
 #pragma once
 
 #include "VolumeOctree.h"
+#include "SparseBrickSDF.h"
 
 #include "Module/TopologyModule.h"
 #include "Topology/TriangleSet.h"
@@ -80,6 +81,17 @@ namespace dyno
 
 		void getSignDistance(DArray<Coord> point_pos, DArray<Real>& point_sdf);
 
+		/**
+		 * @brief Sparse field built when NarrowBand is enabled, nodes are located at the cell centers of the uniform grid.
+		 *		stateSDFTopology() is left empty unless DenseOutput is set or densifyNarrowBand() is called
+		 */
+		SparseBrickSDF<TDataType>& getSparseSDF() { return m_sparseSDF; }
+
+		/**
+		 * @brief Fill stateSDFTopology() with the values of the narrow band, cells outside the band hold +/- band width
+		 */
+		void densifyNarrowBand();
+
 	private:
 
 		DEF_INSTANCE_IN(TriangleSet<TDataType>, TriangleSet, "The triangles of closed surface");
@@ -92,6 +104,12 @@ namespace dyno
 
 		DEF_VAR(Coord, ForwardVector, 0, "The distance and direction of topology move");
 
+		DEF_VAR(bool, NarrowBand, false, "Only compute exact distances inside a band around the surface instead of running FIM over the full grid");
+
+		DEF_VAR(uint, BandWidth, 3, "Half width of the narrow band in grid cells");
+
+		DEF_VAR(bool, DenseOutput, false, "Also fill the dense SDFTopology from the narrow band for nodes reading the dense grid");
+
 		DEF_VAR_OUT(Coord, UniformOrigin, "Uniform grids origin");
 		DEF_VAR_OUT(uint, Unx, "");
 		DEF_VAR_OUT(uint, Uny, "");
@@ -104,5 +122,7 @@ namespace dyno
 		int m_nx;
 		int m_ny;
 		int m_nz;
+
+		SparseBrickSDF<TDataType> m_sparseSDF;
 	};
 }
@@ -0,0 +1,57 @@
+#include "AssetCache.h"
+
+#include <ghc/fs_std.hpp>
+
+namespace dyno
+{
+	AssetCache* AssetCache::instance()
+	{
+		static AssetCache cache;
+		return &cache;
+	}
+
+	void AssetCache::setEnabled(bool enabled)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEnabled = enabled;
+	}
+
+	bool AssetCache::isEnabled()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mEnabled;
+	}
+
+	void AssetCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEntries.clear();
+	}
+
+	size_t AssetCache::size()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mEntries.size();
+	}
+
+	std::shared_ptr<AssetCache::Entry> AssetCache::acquire(const std::string& key)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto& entry = mEntries[key];
+		if (entry == nullptr)
+			entry = std::make_shared<Entry>();
+
+		return entry;
+	}
+
+	std::string AssetCache::fileKey(const std::string& filename)
+	{
+		std::error_code ec;
+		auto time = fs::last_write_time(filename, ec);
+		if (ec)
+			return filename;
+
+		return filename + "@" + std::to_string(time.time_since_epoch().count());
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+
+namespace dyno
+{
+	/*!
+	*	\class	AssetCache
+	*	\brief	A process wide cache of host side assets, e.g., parsed mesh or SDF files, shared by all scene graphs.
+	*
+	*	The cache is disabled by default, in which case every request simply invokes its loader. Once enabled,
+	*	each asset is loaded only once even if it is requested by many threads at the same time, and all requests
+	*	share the same read-only copy.
+	*/
+	class AssetCache
+	{
+	public:
+		static AssetCache* instance();
+
+		void setEnabled(bool enabled);
+		bool isEnabled();
+
+		/**
+		 * @brief Return the asset cached under key, it is loaded by loader on the first request
+		 *
+		 * @return nullptr if the loader failed, failures are not cached
+		 */
+		template<typename T>
+		std::shared_ptr<const T> load(const std::string& key, std::function<std::shared_ptr<T>()> loader)
+		{
+			if (!isEnabled())
+				return loader();
+
+			std::shared_ptr<Entry> entry = acquire(key);
+
+			std::lock_guard<std::mutex> lock(entry->mutex);
+			if (entry->data == nullptr)
+			{
+				std::shared_ptr<T> data = loader();
+				if (data == nullptr)
+					return nullptr;
+
+				entry->data = data;
+				entry->type = std::type_index(typeid(T));
+			}
+
+			if (entry->type != std::type_index(typeid(T)))
+				return nullptr;
+
+			return std::static_pointer_cast<const T>(entry->data);
+		}
+
+		/**
+		 * @brief The same as load(), the key is composed of the file name and its last modification time
+		 */
+		template<typename T>
+		std::shared_ptr<const T> loadFile(const std::string& filename, std::function<std::shared_ptr<T>()> loader)
+		{
+			return load<T>(fileKey(filename), loader);
+		}
+
+		void clear();
+
+		size_t size();
+
+	private:
+		struct Entry
+		{
+			std::mutex mutex;
+			std::type_index type = std::type_index(typeid(void));
+			std::shared_ptr<const void> data;
+		};
+
+		AssetCache() = default;
+		AssetCache(const AssetCache&) = delete;
+		AssetCache& operator=(const AssetCache&) = delete;
+
+		std::shared_ptr<Entry> acquire(const std::string& key);
+
+		std::string fileKey(const std::string& filename);
+
+		bool mEnabled = false;
+
+		std::map<std::string, std::shared_ptr<Entry>> mEntries;
+
+		std::mutex mMutex;
+	};
+}
@@ -193,9 +193,40 @@ namespace dyno
 		return this->disconnectField(dst);
 	}
 
+	static thread_local const std::unordered_map<FBase*, FBase*>* tSnapshots = nullptr;
+
 	FBase* FBase::getTopField()
 	{
-		return mSource == nullptr ? this : mSource->getTopField();
+		FBase* top = this;
+		while (top->mSource != nullptr)
+			top = top->mSource;
+
+		if (tSnapshots != nullptr)
+		{
+			auto it = tSnapshots->find(top);
+			if (it != tSnapshots->end())
+				return it->second;
+		}
+
+		return top;
+	}
+
+	bool FBase::takeSnapshot(std::shared_ptr<FBase>& buffer, bool& modified)
+	{
+		FBase* top = this->getTopField();
+		if (!top->copySnapshot(buffer))
+			return false;
+
+		//The tack time of a snapshot records when its source was last copied
+		modified = buffer->mTackTime < top->mTickTime;
+		buffer->tack();
+
+		return true;
+	}
+
+	void FBase::setSnapshots(const std::unordered_map<FBase*, FBase*>* snapshots)
+	{
+		tSnapshots = snapshots;
 	}
 
 	void FBase::update()
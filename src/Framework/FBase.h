@@ -21,6 +21,8 @@
 #include <string>
 #include <functional>
 #include <cfloat>
+#include <memory>
+#include <unordered_map>
 
 namespace dyno {
 	class OBase;
@@ -97,6 +99,20 @@ public:
 	FBase* getTopField();
 	FBase* getSource();
 
+	/**
+	 * @brief Copies the data of the top field into buffer, a field of the same type created on the first call
+	 *
+	 * @param modified 	Set to whether the top field was ticked since the last snapshot taken into buffer
+	 * @return false if the field type does not support snapshots
+	 */
+	bool takeSnapshot(std::shared_ptr<FBase>& buffer, bool& modified);
+
+	/**
+	 * @brief Redirects the top fields in snapshots to their copies for all fields accessed from the calling thread,
+	 * 	nullptr stops the redirection. Used to run graphics and output modules on a frame while the next one is simulated.
+	 */
+	static void setSnapshots(const std::unordered_map<FBase*, FBase*>* snapshots);
+
 	/**
 	 * @brief Display a state field as an ouput field
 	 * 
@@ -135,6 +151,11 @@ public:
 protected:
 	void setSource(FBase* source);
 
+	/**
+	 * @brief Deep copy of the data into buffer, see takeSnapshot()
+	 */
+	virtual bool copySnapshot(std::shared_ptr<FBase>& buffer) { return false; }
+
 	void addSink(FBase* f);
 	bool removeSink(FBase* f);
 
@@ -15,12 +15,22 @@
  */
 #pragma once
 #include <iostream>
+#include <type_traits>
 #include "FBase.h"
 
 namespace dyno {
 
 	class Object;
 
+	template<typename... Ts>
+	struct void_type { typedef void type; };
+
+	template<typename T, typename = void>
+	struct HasCopyFrom : std::false_type {};
+
+	template<typename T>
+	struct HasCopyFrom<T, typename void_type<decltype(std::declval<T&>().copyFrom(std::declval<T&>()))>::type> : std::true_type {};
+
 	class InstanceBase : public FBase
 	{
 	public:
@@ -144,6 +154,39 @@ namespace dyno {
 			return dPtr == nullptr ? false : true;
 		}
 
+	protected:
+		//Objects are copied with T::copyFrom() if available, e.g., topologies
+		bool copySnapshot(std::shared_ptr<FBase>& buffer) override
+		{
+			return copyObject(buffer, HasCopyFrom<T>());
+		}
+
+	private:
+		bool copyObject(std::shared_ptr<FBase>& buffer, std::true_type)
+		{
+			//An object of a derived class would be sliced
+			if (mData != nullptr && typeid(*mData) != typeid(T))
+				return false;
+
+			if (buffer == nullptr)
+				buffer = std::make_shared<FieldType>();
+
+			FieldType* dst = static_cast<FieldType*>(buffer.get());
+			if (mData == nullptr)
+				dst->mData = nullptr;
+			else
+			{
+				if (dst->mData == nullptr)
+					dst->mData = std::make_shared<T>();
+
+				dst->mData->copyFrom(*mData);
+			}
+
+			return true;
+		}
+
+		bool copyObject(std::shared_ptr<FBase>& buffer, std::false_type) { return false; }
+
 	private:
 		std::shared_ptr<T> mData = nullptr;
 	};
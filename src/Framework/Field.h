@@ -84,7 +84,14 @@ namespace dyno {
 			return derived->m_data;
 		}
 
+	protected:
+		bool copySnapshot(std::shared_ptr<FBase>& buffer) override;
+
 	private:
+		//Values that cannot be copied are not snapshotted
+		bool copyValue(std::shared_ptr<FBase>& buffer, std::true_type);
+		bool copyValue(std::shared_ptr<FBase>& buffer, std::false_type) { return false; }
+
 		std::shared_ptr<DataType>& getDataPtr()
 		{
 			FBase* topField = this->getTopField();
@@ -134,6 +141,30 @@ namespace dyno {
 		return *data;
 	}
 
+	template<typename T>
+	bool FVar<T>::copySnapshot(std::shared_ptr<FBase>& buffer)
+	{
+		return copyValue(buffer, std::integral_constant<bool, std::is_copy_constructible<T>::value && std::is_copy_assignable<T>::value>());
+	}
+
+	template<typename T>
+	bool FVar<T>::copyValue(std::shared_ptr<FBase>& buffer, std::true_type)
+	{
+		if (buffer == nullptr)
+			buffer = std::make_shared<FieldType>();
+
+		std::shared_ptr<T>& src = this->constDataPtr();
+		std::shared_ptr<T>& dst = static_cast<FieldType*>(buffer.get())->m_data;
+		if (src == nullptr)
+			dst = nullptr;
+		else if (dst == nullptr)
+			dst = std::make_shared<T>(*src);
+		else
+			*dst = *src;
+
+		return true;
+	}
+
 
 	template<typename T>
 	using HostVarField = FVar<T>;
@@ -176,6 +207,9 @@ namespace dyno {
 		bool isEmpty() override {
 			return this->size() == 0;
 		}
+
+	protected:
+		bool copySnapshot(std::shared_ptr<FBase>& buffer) override;
 	};
 
 	template<typename T, DeviceType deviceType>
@@ -286,6 +320,26 @@ namespace dyno {
 		//this->tick();
 	}
 
+	template<typename T, DeviceType deviceType>
+	bool FArray<T, deviceType>::copySnapshot(std::shared_ptr<FBase>& buffer)
+	{
+		if (buffer == nullptr)
+			buffer = std::make_shared<FieldType>();
+
+		std::shared_ptr<DataType>& src = this->constDataPtr();
+		std::shared_ptr<DataType>& dst = static_cast<FieldType*>(buffer.get())->m_data;
+		if (dst == nullptr)
+			dst = std::make_shared<DataType>();
+
+		//An empty array can not be told apart from a missing one, see isEmpty()
+		if (src == nullptr)
+			dst->clear();
+		else
+			dst->assign(*src);
+
+		return true;
+	}
+
 	template<typename T>
 	using HostArrayField = FArray<T, DeviceType::CPU>;
 
@@ -1,4 +1,7 @@
 #include "GraphicsPipeline.h"
+#include "VisualModule.h"
+
+#include <set>
 
 namespace dyno
 {
@@ -10,5 +13,101 @@ namespace dyno
 	GraphicsPipeline::~GraphicsPipeline()
 	{
 	}
-}
 
+	static bool isModuleModified(Module* m)
+	{
+		//Modules forcing updates, e.g., renderers that redraw every frame, are always treated as modified
+		if (m->varForceUpdate()->getValue())
+			return true;
+
+		for (auto f : m->getInputFields())
+		{
+			if (f->isModified())
+				return true;
+		}
+
+		for (auto f : m->getParameters())
+		{
+			if (f->isModified())
+				return true;
+		}
+
+		return false;
+	}
+
+	void GraphicsPipeline::updateImpl()
+	{
+		if (!this->isEnabled())
+			return;
+
+		uint count = mUpdateCount++;
+
+		auto& modules = this->activeModules();
+
+		std::set<Module*> members;
+		for (auto& m : modules)
+			members.insert(m.get());
+
+		//Modules are sorted topologically, so all consumers of a module are visited before it
+		std::set<Module*> required;
+		std::list<std::shared_ptr<Module>> queue;
+		std::vector<VisualModule*> visuals;
+		bool modified = false;
+		for (auto it = modules.rbegin(); it != modules.rend(); it++)
+		{
+			Module* m = it->get();
+
+			bool isRequired = false;
+
+			VisualModule* vm = dynamic_cast<VisualModule*>(m);
+			if (vm != nullptr)
+			{
+				uint interval = vm->varUpdateInterval()->getValue();
+
+				auto last = mLastUpdates.find(vm->objectId());
+				bool due = interval <= 1 || last == mLastUpdates.end() || count - last->second >= interval;
+
+				isRequired = vm->isVisible() && due;
+			}
+			else
+			{
+				//Modules without consumers in the pipeline are kept
+				bool consumed = false;
+				for (auto f : m->getOutputFields())
+				{
+					for (auto sink : f->getSinks())
+					{
+						Module* consumer = dynamic_cast<Module*>(sink->parent());
+						if (consumer == nullptr || members.find(consumer) == members.end())
+							continue;
+
+						consumed = true;
+						isRequired |= required.find(consumer) != required.end();
+					}
+				}
+
+				isRequired |= !consumed;
+			}
+
+			if (!isRequired)
+				continue;
+
+			required.insert(m);
+			queue.push_front(*it);
+
+			bool changed = isModuleModified(m);
+			modified |= changed;
+
+			if (vm != nullptr && changed)
+				visuals.push_back(vm);
+		}
+
+		if (!modified)
+			return;
+
+		this->updateModules(queue);
+
+		for (auto vm : visuals)
+			mLastUpdates[vm->objectId()] = count;
+	}
+}
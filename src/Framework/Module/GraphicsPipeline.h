@@ -18,10 +18,29 @@
 
 namespace dyno
 {
+	/**
+	 * Graphics pipelines are updated lazily, only the modules feeding a visible visual module are updated, see
+	 * VisualModule::varUpdateInterval() to throttle them. Nothing is updated if none of their input fields and
+	 * parameters changed since the last update, unless one of them forces updates.
+	 */
 	class GraphicsPipeline : public Pipeline
 	{
 	public:
 		GraphicsPipeline(Node* node);
 		virtual ~GraphicsPipeline();
+
+		/**
+		 * @brief Number of updates of the enabled pipeline, including those that skipped all modules
+		 */
+		uint updateCount() { return mUpdateCount; }
+
+	protected:
+		void updateImpl() override;
+
+	private:
+		uint mUpdateCount = 0;
+
+		//Update counts at which visual modules were last updated, used to throttle them
+		std::map<ObjectId, uint> mLastUpdates;
 	};
 }
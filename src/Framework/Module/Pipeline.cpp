@@ -120,31 +120,42 @@ namespace dyno
 	{
 		if (mUpdateEnabled)
 		{
+			this->updateModules(mModuleList);
+		}
+	}
+
+	void Pipeline::updateModules(std::list<std::shared_ptr<Module>>& modules)
+	{
 #ifdef CUDA_BACKEND
-			GTimer timer;
+		GTimer timer;
 #else
-			CTimer timer;
+		CTimer timer;
 #endif // CUDA_BACKEND
-			for(auto m : mModuleList)
-			{
-				if (mNode->getSceneGraph()->isModuleInfoPrintable()) {
-					timer.start();
-				}
 
-				//update the module
-				m->update();
+#ifdef VK_BACKEND
+		// Timing each module requires its dispatches to be submitted separately, the batch is ended when leaving this function
+		VkCommandBatchScope batchScope(mCommandBatch, !mNode->getSceneGraph()->isModuleInfoPrintable());
+#endif // VK_BACKEND
 
-				if (mNode->getSceneGraph()->isModuleInfoPrintable()) {
-					timer.stop();
+		for(auto m : modules)
+		{
+			if (mNode->getSceneGraph()->isModuleInfoPrintable()) {
+				timer.start();
+			}
 
-					std::stringstream name;
-					std::stringstream ss;
-					name << std::setw(40) << m->getClassInfo()->getClassName();
-					ss << std::setprecision(10) << timer.getElapsedTime();
+			//update the module
+			m->update();
 
-					std::string info = "\t Module: " + name.str() + ": \t " + ss.str() + "ms";
-					Log::sendMessage(Log::Info, info);
-				}
+			if (mNode->getSceneGraph()->isModuleInfoPrintable()) {
+				timer.stop();
+
+				std::stringstream name;
+				std::stringstream ss;
+				name << std::setw(40) << m->getClassInfo()->getClassName();
+				ss << std::setprecision(10) << timer.getElapsedTime();
+
+				std::string info = "\t Module: " + name.str() + ": \t " + ss.str() + "ms";
+				Log::sendMessage(Log::Info, info);
 			}
 		}
 	}
@@ -276,5 +287,6 @@ namespace dyno
 		moduleSet.clear();
 
 		mModuleUpdated = false;
+		mModuleVersion++;
 	}
 }
\ No newline at end of file
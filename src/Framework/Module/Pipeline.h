@@ -76,8 +76,20 @@ namespace dyno
 			return mModuleMap;
 		}
 
+		/**
+		 * @brief Increased each time the list of active modules is reconstructed, used to invalidate caches built on activeModules()
+		 */
+		uint moduleVersion() {
+			if (mModuleUpdated) {
+				reconstructPipeline();
+			}
+
+			return mModuleVersion;
+		}
+
 		void enable();
 		void disable();
+		bool isEnabled() { return mUpdateEnabled; }
 
 		void updateExecutionQueue();
 
@@ -99,6 +111,11 @@ namespace dyno
 		void preprocess() final;
 		void updateImpl() override;
 
+		/**
+		 * @brief Update the given modules in order, with timing if module info is printed
+		 */
+		void updateModules(std::list<std::shared_ptr<Module>>& modules);
+
 		bool requireUpdate() final;
 
 	private:
@@ -108,6 +125,8 @@ namespace dyno
 		bool mModuleUpdated = false;
 		bool mUpdateEnabled = true;
 
+		uint mModuleVersion = 0;
+
 		std::map<ObjectId, std::shared_ptr<Module>> mModuleMap;
 		std::list<std::shared_ptr<Module>>  mModuleList;
 
@@ -116,6 +135,11 @@ namespace dyno
 		Node* mNode;
 
 		bool mTiming = false;
+
+#ifdef VK_BACKEND
+		// Records the dispatches of all modules in one step so that they are submitted at once
+		VkCommandBatch mCommandBatch;
+#endif // VK_BACKEND
 	};
 }
 
@@ -29,6 +29,12 @@ namespace dyno
 
 		std::string getModuleType() override { return "VisualModule"; }
 
+		/**
+		 * @brief The module, and the modules it depends on in the graphics pipeline, are updated at most once
+		 * 	every UpdateInterval updates of the graphics pipeline. Changes skipped meanwhile are picked up by the next update.
+		 */
+		DEF_VAR(uint, UpdateInterval, 1, "Number of graphics pipeline updates between two updates of the module");
+
 	private:
 		DEF_VAR(bool, Visible, true, "A toggle to control the viability");
 	};
@@ -1,4 +1,5 @@
 #include "NodeFactory.h"
+#include "Plugin/PluginManager.h"
 
 namespace dyno
 {
@@ -46,6 +47,13 @@ namespace dyno
 		return mGroups[name];
 	}
 
+	std::map<std::string, std::shared_ptr<NodePage>>& NodeFactory::nodePages()
+	{
+		PluginManager::instance()->loadDeferredPlugins();
+
+		return mPages;
+	}
+
 	bool NodeFactory::hasPage(std::string name)
 	{
 		return mPages.find(name) != mPages.end();
@@ -103,9 +103,10 @@ namespace dyno
 
 		bool hasPage(std::string name);
 
-		std::map<std::string, std::shared_ptr<NodePage>>& nodePages() {
-			return mPages;
-		}
+		/**
+		 * @brief All node pages, plugins with deferred loading are loaded first
+		 */
+		std::map<std::string, std::shared_ptr<NodePage>>& nodePages();
 
 	private:
 		NodeFactory() = default;
@@ -1,5 +1,6 @@
 #include <map>
 #include "Object.h"
+#include "Plugin/PluginManager.h"
 
 namespace dyno
 {
@@ -31,15 +32,26 @@ bool Object::registerClass(ClassInfo* ci)
 }
 Object* Object::createObject(std::string name)
 {
-	std::map< std::string, ClassInfo*>::const_iterator iter = classInfoMap->find(name);
-	if (classInfoMap->end() != iter) {
-		return iter->second->createObject();
+	if (classInfoMap) {
+		std::map< std::string, ClassInfo*>::const_iterator iter = classInfoMap->find(name);
+		if (classInfoMap->end() != iter) {
+			return iter->second->createObject();
+		}
+	}
+
+	//The class may be provided by a plugin whose loading is deferred
+	if (PluginManager::instance()->loadPluginOfClass(name)) {
+		return createObject(name);
 	}
+
 	return NULL;
 }
 
 std::map< std::string, ClassInfo*>* Object::getClassMap()
 {
+	//Callers iterate all classes, e.g., the node editors, so deferred plugins have to be loaded first
+	PluginManager::instance()->loadDeferredPlugins();
+
 	return classInfoMap;
 }
 
@@ -1,8 +1,11 @@
 #include "PluginManager.h"
+#include "Object.h"
 
 #include <ghc/fs_std.hpp>
 
 #include <iostream>
+#include <fstream>
+#include <set>
 
 namespace dyno
 {
@@ -148,11 +151,122 @@ namespace dyno
 		{
 			if (entry.path().extension() == getExtension())
 			{
-				loadPlugin(entry.path().string());
+				if (!readManifest(entry.path().string()))
+					loadPlugin(entry.path().string());
 			}
 		}
 	}
 
+	std::string PluginManager::getManifest(const std::string& pluginName) const
+	{
+		fs::path file_path(pluginName);
+		file_path.replace_extension(".manifest");
+
+		return file_path.string();
+	}
+
+	bool PluginManager::readManifest(const std::string& pluginName)
+	{
+		std::ifstream input(getManifest(pluginName));
+		if (!input.is_open())
+			return false;
+
+		std::vector<std::string> classes;
+
+		std::string line;
+		while (std::getline(input, line))
+		{
+			size_t first = line.find_first_not_of(" \t\r");
+			if (first == std::string::npos || line[first] == '#')
+				continue;
+
+			size_t last = line.find_last_not_of(" \t\r");
+			classes.push_back(line.substr(first, last - first + 1));
+		}
+
+		std::lock_guard<std::recursive_mutex> lock(mDeferredMutex);
+		for (auto& name : classes)
+		{
+			mDeferredClasses.insert(std::make_pair(name, pluginName));
+		}
+
+		return true;
+	}
+
+	bool PluginManager::loadPluginOfClass(const std::string& className)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mDeferredMutex);
+
+		auto it = mDeferredClasses.find(className);
+		if (it == mDeferredClasses.end())
+			return false;
+
+		std::string pluginName = it->second;
+
+		//Remove all classes of the plugin first, a failed plugin is not retried
+		removeDeferredPlugin(pluginName);
+
+		return loadPlugin(pluginName);
+	}
+
+	void PluginManager::removeDeferredPlugin(const std::string& pluginName)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mDeferredMutex);
+
+		for (auto iter = mDeferredClasses.begin(); iter != mDeferredClasses.end(); )
+		{
+			if (iter->second == pluginName)
+				iter = mDeferredClasses.erase(iter);
+			else
+				iter++;
+		}
+	}
+
+	void PluginManager::loadDeferredPlugins()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mDeferredMutex);
+
+		while (!mDeferredClasses.empty())
+		{
+			loadPluginOfClass(mDeferredClasses.begin()->first);
+		}
+	}
+
+	bool PluginManager::writeManifest(const std::string& pluginName)
+	{
+		//Querying the class map loads all deferred plugins, the plugin itself must not be loaded before the snapshot
+		removeDeferredPlugin(pluginName);
+
+		std::set<std::string> registered;
+		auto classMap = Object::getClassMap();
+		if (classMap != nullptr)
+		{
+			for (auto& ci : *classMap)
+				registered.insert(ci.first);
+		}
+
+		if (!loadPlugin(pluginName))
+			return false;
+
+		std::ofstream output(getManifest(pluginName));
+		if (!output.is_open())
+			return false;
+
+		output << "# Classes registered by " << fs::path(pluginName).filename().string() << std::endl;
+
+		classMap = Object::getClassMap();
+		if (classMap != nullptr)
+		{
+			for (auto& ci : *classMap)
+			{
+				if (registered.find(ci.first) == registered.end())
+					output << ci.first << std::endl;
+			}
+		}
+
+		return true;
+	}
+
 	std::shared_ptr<Plugin> PluginManager::getPlugin(const char* pluginName)
 	{
 		auto it = mPlugins.find(pluginName);
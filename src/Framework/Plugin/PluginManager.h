@@ -66,6 +66,11 @@ namespace dyno
 	/** 
 	 * @brief Repository of plugins.
 	 * It can instantiate any class from any loaded plugin by its name.
+	 *
+	 * A plugin may ship a manifest, a text file next to the shared library with the same name and the extension
+	 * .manifest, that lists the names of the classes it registers, one per line. Lines starting with # are ignored.
+	 * Such a plugin is not loaded by loadPluginByPath(), but on the first call to Object::createObject() for one of
+	 * its classes, or when all classes are queried through Object::getClassMap() or the node pages of NodeFactory.
 	 **/
 	class PluginManager
 	{
@@ -80,14 +85,50 @@ namespace dyno
 
 		std::shared_ptr<Plugin> getPlugin(const char* pluginName);
 
+		/**
+		 * @brief Load the deferred plugin whose manifest lists the class
+		 *
+		 * @return false if no deferred plugin provides the class or loading failed
+		 */
+		bool loadPluginOfClass(const std::string& className);
+
+		/**
+		 * @brief Load all plugins whose loading was deferred by their manifests
+		 */
+		void loadDeferredPlugins();
+
+		/**
+		 * @brief Load a plugin and write the classes it registers into its manifest. Classes registered before,
+		 * 	e.g., by plugins loaded earlier in the same process, are not listed.
+		 */
+		bool writeManifest(const std::string& pluginName);
+
+		/**
+		 * @brief Path of the manifest of a plugin
+		 */
+		std::string getManifest(const std::string& pluginName) const;
+
 	private:
 		PluginManager() {};
 
+		bool readManifest(const std::string& pluginName);
+
+		/**
+		 * @brief Forget the classes listed by the manifest of a plugin, the plugin is no longer loaded on demand
+		 */
+		void removeDeferredPlugin(const std::string& pluginName);
+
 		using PluginMap = std::map<std::string, std::shared_ptr<Plugin>>;
 
 		static std::atomic<PluginManager*> pInstance;
 		static std::mutex mMutex;
 
 		PluginMap mPlugins;
+
+		/** @brief Libraries of the deferred plugins indexed by the classes they provide */
+		std::map<std::string, std::string> mDeferredClasses;
+
+		/** @brief Held while deferred plugins are loaded, loading may recursively request other classes */
+		std::recursive_mutex mDeferredMutex;
 	};
 }
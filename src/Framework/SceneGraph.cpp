@@ -13,6 +13,11 @@
 
 #include "Timer.h"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <set>
+
 #include <sstream>
 #include <iomanip>
 
@@ -51,6 +56,53 @@ namespace dyno
 		mAdvativeInterval = adaptive;
 	}
 
+	bool SceneGraph::isMultiRate()
+	{
+		return mMultiRate;
+	}
+
+	void SceneGraph::setMultiRate(bool multiRate)
+	{
+		mMultiRate = multiRate;
+	}
+
+	bool SceneGraph::isPipelined()
+	{
+		return mPipelined;
+	}
+
+	void SceneGraph::setPipelined(bool pipelined)
+	{
+		std::lock_guard<std::mutex> lock(mSync);
+
+		this->waitForPresentation();
+
+		mPipelined = pipelined;
+
+		if (!pipelined)
+		{
+			for (int i = 0; i < 2; i++)
+			{
+				mSnapshots[i].clear();
+				mSnapshotBuffers[i].clear();
+			}
+		}
+	}
+
+	void SceneGraph::finishPresentation()
+	{
+		std::lock_guard<std::mutex> lock(mSync);
+
+		this->waitForPresentation();
+	}
+
+	void SceneGraph::waitForPresentation()
+	{
+		//get() rethrows exceptions raised by the modules
+		if (mPresentation.valid())
+			mPresentation.get();
+	}
+
 	void SceneGraph::setGravity(Vec3f g)
 	{
 		mGravity = g;
@@ -63,12 +115,17 @@ namespace dyno
 
 	SceneGraph::~SceneGraph()
 	{
+		if (mPresentation.valid())
+			mPresentation.wait();
+
 		mNodeMap.clear();
 		mNodeQueue.clear();
 	}
 
 	bool SceneGraph::initialize()
 	{
+		std::lock_guard<std::mutex> lock(mSync);
+
 		if (mInitialized)
 		{
 			return true;
@@ -107,6 +164,43 @@ namespace dyno
 		mInitialized = false;
 	}
 
+	//Update a single node and log its time cost if timing is enabled
+	static void updateNode(Node* node, bool timing)
+	{
+		if (node == NULL)
+		{
+			Log::sendMessage(Log::Error, "Node is invalid!");
+			return;
+		}
+
+#ifdef CUDA_BACKEND
+		GTimer timer;
+#else
+		CTimer timer;
+#endif // CUDA_BACKEND
+
+		if (timing) {
+			timer.start();
+		}
+
+		if (node->isActive())
+		{
+			node->update();
+		}
+
+		if (timing) {
+			timer.stop();
+
+			std::stringstream name;
+			std::stringstream ss;
+			name << std::setw(40) << node->getClassInfo()->getClassName();
+			ss << std::setprecision(10) << timer.getElapsedTime();
+
+			std::string info = "Node: \t" + name.str() + ": \t " + ss.str() + "ms \n";
+			Log::sendMessage(Log::Info, info);
+		}
+	}
+
 	void SceneGraph::advance(float dt)
 	{
 		class AdvanceAct : public Action
@@ -127,57 +221,350 @@ namespace dyno
 			}
 
 			void process(Node* node) override {
-				if (node == NULL)
+				updateNode(node, mTiming);
+			}
+
+			float mDt;
+			float mElapsedTime;
+
+			bool mTiming = false;
+		};	
+
+		this->traverseForward<AdvanceAct>(dt, mElapsedTime, mNodeTiming);
+
+		mElapsedTime += dt;
+	}
+
+	/**
+	 * A field read by a group of nodes from a group that advances before it, see SceneGraph::setMultiRate()
+	 */
+	class ExportedField
+	{
+	public:
+		virtual ~ExportedField() {}
+
+		//Record the value at the start of the frame
+		virtual void captureStart() = 0;
+
+		//Record the value at the end of the frame, after the producing group has advanced
+		virtual void captureEnd() = 0;
+
+		//Overwrite the value with the interpolation at alpha in [0, 1] without triggering callbacks
+		virtual void interpolate(float alpha) = 0;
+
+		//Restore the value at the end of the frame
+		virtual void restore() = 0;
+	};
+
+	template<typename T>
+	class ExportedVar : public ExportedField
+	{
+	public:
+		ExportedVar(FVar<T>* field) : mField(field) {}
+
+		void captureStart() override { mStart = *mField->constDataPtr(); }
+		void captureEnd() override { mEnd = *mField->constDataPtr(); }
+
+		void interpolate(float alpha) override {
+			*mField->constDataPtr() = mStart + (mEnd - mStart) * alpha;
+			mField->tick();
+		}
+
+		void restore() override {
+			*mField->constDataPtr() = mEnd;
+			mField->tick();
+		}
+
+	private:
+		FVar<T>* mField;
+
+		T mStart;
+		T mEnd;
+	};
+
+	template<typename T>
+	static bool createExportedVar(FBase* field, std::shared_ptr<ExportedField>& exported)
+	{
+		FVar<T>* var = dynamic_cast<FVar<T>*>(field);
+		if (var == nullptr || var->constDataPtr() == nullptr)
+			return false;
+
+		exported = std::make_shared<ExportedVar<T>>(var);
+		return true;
+	}
+
+	//Only fields of types that can be linearly interpolated are supported
+	static std::shared_ptr<ExportedField> createExportedField(FBase* field)
+	{
+		std::shared_ptr<ExportedField> exported;
+		createExportedVar<float>(field, exported) ||
+			createExportedVar<double>(field, exported) ||
+			createExportedVar<Vec2f>(field, exported) ||
+			createExportedVar<Vec3f>(field, exported) ||
+			createExportedVar<Vec3d>(field, exported);
+
+		return exported;
+	}
+
+	static uint findGroup(std::vector<uint>& parents, uint i)
+	{
+		while (parents[i] != i)
+		{
+			parents[i] = parents[parents[i]];
+			i = parents[i];
+		}
+
+		return i;
+	}
+
+	void SceneGraph::advanceMultiRate(float interval)
+	{
+		updateExecutionQueue();
+
+		std::vector<Node*> nodes(mNodeQueue.begin(), mNodeQueue.end());
+		uint num = (uint)nodes.size();
+
+		std::map<Node*, uint> indices;
+		for (uint i = 0; i < num; i++)
+			indices[nodes[i]] = i;
+
+		//Nodes coupled through node ports advance in lockstep
+		std::vector<uint> parents(num);
+		for (uint i = 0; i < num; i++)
+			parents[i] = i;
+
+		for (uint i = 0; i < num; i++)
+		{
+			for (auto port : nodes[i]->getImportNodes())
+			{
+				for (auto inNode : port->getNodes())
 				{
-					Log::sendMessage(Log::Error, "Node is invalid!");
-					return;
+					auto it = indices.find(inNode);
+					if (it != indices.end())
+					{
+						uint a = findGroup(parents, it->second);
+						uint b = findGroup(parents, i);
+						parents[std::max(a, b)] = std::min(a, b);
+					}
 				}
+			}
+		}
 
-#ifdef CUDA_BACKEND
-				GTimer timer;
-#else
-				CTimer timer;
-#endif // CUDA_BACKEND
+		//Collect field connections between nodes as (producer, consumer, field read by the consumer)
+		struct Connection
+		{
+			uint producer;
+			uint consumer;
+			FBase* field;
+		};
 
-				
-				if (mTiming) {
-					timer.start();
+		std::vector<Connection> connections;
+		for (uint i = 0; i < num; i++)
+		{
+			for (auto f : nodes[i]->getInputFields())
+			{
+				FBase* src = f->getSource();
+				if (src == nullptr)
+					continue;
+
+				auto it = indices.find(dynamic_cast<Node*>(src->parent()));
+				if (it != indices.end() && it->second != i)
+					connections.push_back(Connection{ it->second, i, f->getTopField() });
+			}
+		}
+
+		//Groups advance in the order of their first node in the execution queue, a group that reads from a group
+		//behind it is merged with it, which also resolves cycles
+		bool merged = true;
+		while (merged)
+		{
+			merged = false;
+			for (auto& c : connections)
+			{
+				uint gp = findGroup(parents, c.producer);
+				uint gc = findGroup(parents, c.consumer);
+				if (gp != gc && gp > gc)
+				{
+					parents[gp] = gc;
+					merged = true;
 				}
+			}
+		}
+
+		//Roots are the smallest index of their groups, so groups are sorted by their roots
+		std::map<uint, std::vector<Node*>> groups;
+		for (uint i = 0; i < num; i++)
+			groups[findGroup(parents, i)].push_back(nodes[i]);
+
+		std::map<FBase*, std::shared_ptr<ExportedField>> exported;
+		std::map<uint, std::vector<ExportedField*>> imports;
+		for (auto& c : connections)
+		{
+			uint gc = findGroup(parents, c.consumer);
+			if (findGroup(parents, c.producer) == gc)
+				continue;
+
+			auto it = exported.find(c.field);
+			if (it == exported.end())
+			{
+				auto ef = createExportedField(c.field);
+				it = exported.insert(std::make_pair(c.field, ef)).first;
+				if (ef != nullptr)
+					ef->captureStart();
+			}
+
+			if (it->second != nullptr)
+				imports[gc].push_back(it->second.get());
+		}
+
+		for (auto& g : groups)
+		{
+			float dt = interval;
+			for (auto node : g.second)
+				dt = node->getDt() < dt ? node->getDt() : dt;
+
+			int steps = dt > 0.0f ? (int)std::ceil(interval / dt - 1e-4f) : 1;
+			steps = steps < 1 ? 1 : steps;
+			dt = interval / steps;
 
-				if (node->isActive())
+			auto& inputs = imports[g.first];
+			for (auto ef : inputs)
+				ef->captureEnd();
+
+			for (int k = 0; k < steps; k++)
+			{
+				for (auto ef : inputs)
+					ef->interpolate(float(k + 1) / steps);
+
+				for (auto node : g.second)
 				{
-					node->update();
+					node->stateTimeStep()->setValue(dt);
+					node->stateElapsedTime()->setValue(mElapsedTime + k * dt);
+
+					updateNode(node, mNodeTiming);
 				}
+			}
+
+			for (auto ef : inputs)
+				ef->restore();
+		}
+
+		mElapsedTime += interval;
+	}
+
+	bool SceneGraph::presentInBackground()
+	{
+		int next = 1 - mSnapshotIndex;
+
+		std::unordered_map<FBase*, std::shared_ptr<FBase>> buffers;
+		std::unordered_map<FBase*, FBase*> snapshots;
+		std::vector<FBase*> modified;
+
+		auto takeSnapshot = [&](FBase* field, const std::set<OBase*>& owners) -> bool {
+			FBase* top = field->getTopField();
+
+			//Fields written by graphics or output modules themselves are not touched by the simulation
+			if (owners.find(top->parent()) != owners.end() || snapshots.find(top) != snapshots.end())
+				return true;
 
-				if (mTiming) {
-					timer.stop();
+			std::shared_ptr<FBase>& buffer = buffers[top];
+
+			auto it = mSnapshotBuffers[next].find(top);
+			if (it != mSnapshotBuffers[next].end())
+				buffer = it->second;
+
+			bool changed = false;
+			if (!top->takeSnapshot(buffer, changed))
+				return false;
+
+			snapshots[top] = buffer.get();
+			if (changed)
+				modified.push_back(buffer.get());
+
+			return true;
+		};
+
+		//The queue also holds nodes reached through ports and fields that were never added to the scene graph,
+		//those found in the node map are kept alive until the frame has been presented
+		std::vector<Node*> nodes;
+		std::vector<std::shared_ptr<Node>> owned;
+		for (auto node : mNodeQueue)
+		{
+			//Graphics pipelines of hidden nodes are skipped, see GraphicsPipeline
+			std::vector<std::shared_ptr<Module>> modules;
+			if (node->graphicsPipeline()->isEnabled())
+			{
+				for (auto m : node->graphicsPipeline()->activeModules())
+					modules.push_back(m);
+			}
+
+			for (auto m : node->getModuleList())
+			{
+				if (std::string("OutputModule").compare(m->getModuleType()) == 0)
+					modules.push_back(m);
+			}
 
-					std::stringstream name;
-					std::stringstream ss;
-					name << std::setw(40) << node->getClassInfo()->getClassName();
-					ss << std::setprecision(10) << timer.getElapsedTime();
-					
-					std::string info = "Node: \t" + name.str() + ": \t " + ss.str() + "ms \n";
-					Log::sendMessage(Log::Info, info);
+			std::set<OBase*> owners;
+			for (auto m : modules)
+				owners.insert(m.get());
+
+			for (auto m : modules)
+			{
+				for (auto f : m->getInputFields())
+				{
+					if (!takeSnapshot(f, owners))
+						return false;
+				}
+
+				for (auto f : m->getParameters())
+				{
+					if (!takeSnapshot(f, owners))
+						return false;
 				}
 			}
 
-			float mDt;
-			float mElapsedTime;
+			nodes.push_back(node);
 
-			bool mTiming = false;
-		};	
+			auto it = mNodeMap.find(node->objectId());
+			if (it != mNodeMap.end())
+				owned.push_back(it->second);
+		}
 
-		this->traverseForward<AdvanceAct>(dt, mElapsedTime, mNodeTiming);
+		//The other set of snapshots is free once the previous frame has been presented
+		this->waitForPresentation();
 
-		mElapsedTime += dt;
+		for (auto f : modified)
+			f->tick();
+
+		mSnapshotBuffers[next] = std::move(buffers);
+		mSnapshots[next] = std::move(snapshots);
+		mSnapshotIndex = next;
+
+		const std::unordered_map<FBase*, FBase*>* redirect = &mSnapshots[next];
+		mPresentation = std::async(std::launch::async, [redirect, nodes, owned]() {
+			FBase::setSnapshots(redirect);
+
+			PostProcessing output;
+			Action* act = &output;
+			for (auto node : nodes)
+				act->process(node);
+
+			for (auto node : nodes)
+				node->graphicsPipeline()->update();
+
+			FBase::setSnapshots(nullptr);
+		});
+
+		return true;
 	}
 
 	void SceneGraph::takeOneFrame()
 	{
-		mSync.lock();
+		std::lock_guard<std::mutex> lock(mSync);
 
-		std::cout << "****************    Frame " << mFrameNumber << " Started    ****************" << std::endl;
+		if (mFrameInfo) {
+			std::cout << "****************    Frame " << mFrameNumber << " Started    ****************" << std::endl;
+		}
 
 // 		if (mRoot == nullptr)
 // 		{
@@ -197,29 +584,36 @@ namespace dyno
 			float dt;
 		} timeStep;
 
-		timeStep.dt = 1.0f / mFrameRate;
-
-		this->traverseForward(&timeStep);
-		dt = timeStep.dt;
-
-		if (mAdvativeInterval)
+		if (mMultiRate)
 		{
-			this->advance(dt);
+			this->advanceMultiRate(1.0f / mFrameRate);
 		}
 		else
 		{
-			float interval = 1.0f / mFrameRate;
-			while (t + dt < interval)
+			timeStep.dt = 1.0f / mFrameRate;
+
+			this->traverseForward(&timeStep);
+			dt = timeStep.dt;
+
+			if (mAdvativeInterval)
 			{
 				this->advance(dt);
-
-				t += dt;
-				timeStep.dt = 1.0f / mFrameRate;
-				this->traverseForward(&timeStep);
-				dt = timeStep.dt;
 			}
+			else
+			{
+				float interval = 1.0f / mFrameRate;
+				while (t + dt < interval)
+				{
+					this->advance(dt);
+
+					t += dt;
+					timeStep.dt = 1.0f / mFrameRate;
+					this->traverseForward(&timeStep);
+					dt = timeStep.dt;
+				}
 
-			this->advance(interval - t);
+				this->advance(interval - t);
+			}
 		}
 
 // 		class UpdateGrpahicsContextAct : public Action
@@ -232,15 +626,21 @@ namespace dyno
 // 
 // 		m_root->traverseTopDown<UpdateGrpahicsContextAct>();
 
-		this->traverseForward<PostProcessing>();
+		if (!mPipelined || !this->presentInBackground())
+		{
+			//Output modules must not run concurrently with a frame still presented in the background
+			this->waitForPresentation();
+
+			this->traverseForward<PostProcessing>();
+		}
 
 		this->traverseForward<AssignFrameNumberAct>(mFrameNumber);
 
-		std::cout << "----------------    Frame " << mFrameNumber << " Ended      ----------------" << std::endl << std::endl;
+		if (mFrameInfo) {
+			std::cout << "----------------    Frame " << mFrameNumber << " Ended      ----------------" << std::endl << std::endl;
+		}
 
 		mFrameNumber++;
-
-		mSync.unlock();
 	}
 
 	void SceneGraph::updateGraphicsContext()
@@ -254,7 +654,12 @@ namespace dyno
 		};
 
 		if (mSync.try_lock()) {
-			this->traverseForward<UpdateGrpahicsContextAct>();
+			bool presenting = mPresentation.valid() &&
+				mPresentation.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+
+			if (!presenting)
+				this->traverseForward<UpdateGrpahicsContextAct>();
+
 			mSync.unlock();
 		}
 	}
@@ -262,7 +667,24 @@ namespace dyno
 
 	void SceneGraph::run()
 	{
+		if (mMaxTime <= 0.0f)
+			return;
+
+		if (!mInitialized)
+			this->initialize();
 
+		while (mElapsedTime < mMaxTime)
+		{
+			float t = mElapsedTime;
+
+			this->takeOneFrame();
+
+			//Stop if no node is able to advance in time
+			if (mElapsedTime <= t)
+				break;
+		}
+
+		this->finishPresentation();
 	}
 
 	NBoundingBox SceneGraph::boundingBox()
@@ -278,7 +700,9 @@ namespace dyno
 
 	void SceneGraph::reset()
 	{
-		mSync.lock();
+		std::lock_guard<std::mutex> lock(mSync);
+
+		this->waitForPresentation();
 
 		class ResetNodeAct : public Action
 		{
@@ -300,17 +724,15 @@ namespace dyno
 
 		mElapsedTime = 0.0f;
 		mFrameNumber = 0;
-
-		mSync.unlock();
 	}
 
 	void SceneGraph::reset(std::shared_ptr<Node> node)
 	{
-		mSync.lock();
+		std::lock_guard<std::mutex> lock(mSync);
 
-		this->traverseForward<ResetAct>(node);
+		this->waitForPresentation();
 
-		mSync.unlock();
+		this->traverseForward<ResetAct>(node);
 	}
 
 	void SceneGraph::printNodeInfo(bool enabled)
@@ -323,6 +745,11 @@ namespace dyno
 		mModuleTiming = enabled;
 	}
 
+	void SceneGraph::printFrameInfo(bool enabled)
+	{
+		mFrameInfo = enabled;
+	}
+
 	bool SceneGraph::load(std::string name)
 	{
 		SceneLoader* loader = SceneLoaderFactory::getInstance().getEntryByFileName(name);
@@ -574,7 +1001,15 @@ namespace dyno
 
 		visited.clear();
 
+		//Nodes only reached through ports or fields are executed as part of this scene graph as well
+		for (auto node : mNodeQueue)
+			node->setSceneGraph(this);
+
 		mQueueUpdateRequired = false;
+
+		// unique across all scene graphs, so that a cache never mistakes a new scene for an old one at the same address
+		static std::atomic<uint> globalQueueVersion(0);
+		mQueueVersion = ++globalQueueVersion;
 	}
 
 	void SceneGraph::traverseBackward(Action* act)
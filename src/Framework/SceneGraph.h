@@ -21,6 +21,8 @@
 #include "Module/InputModule.h"
 
 #include <mutex>
+#include <future>
+#include <unordered_map>
 
 namespace dyno 
 {
@@ -28,6 +30,12 @@ namespace dyno
 
 	typedef std::map<ObjectId, std::shared_ptr<Node>> NodeMap;
 
+	/**
+	 * Thread safety: initialize(), takeOneFrame(), run() and reset() lock the scene, calls on the same scene from
+	 * different threads are serialized and calls on different scenes may run concurrently. All scenes share the
+	 * default CUDA stream, so their kernels still execute one after another on the device.
+	 * Adding or removing nodes while the scene is being stepped is not supported.
+	 */
 	class SceneGraph : public OBase
 	{
 	public:
@@ -49,6 +57,10 @@ namespace dyno
 		virtual void advance(float dt);
 		virtual void takeOneFrame();
 		virtual void updateGraphicsContext();
+
+		/**
+		 * @brief Take frames until the total time set by setTotalTime() is reached, nothing is done if the total time is not positive
+		 */
 		virtual void run();
 
 		NBoundingBox boundingBox();
@@ -59,9 +71,11 @@ namespace dyno
 
 		void printNodeInfo(bool enabled);
 		void printModuleInfo(bool enabled);
+		void printFrameInfo(bool enabled);
 
 		bool isNodeInfoPrintable() { return mNodeTiming; }
 		bool isModuleInfoPrintable() { return mModuleTiming; }
+		bool isFrameInfoPrintable() { return mFrameInfo; }
 
 		virtual bool load(std::string name);
 
@@ -116,12 +130,51 @@ namespace dyno
 		inline float getTimeCostPerFrame() { return mFrameCost; }
 		inline float getFrameInterval() { return 1.0f / mFrameRate; }
 
+		inline float getElapsedTime() { return mElapsedTime; }
+
 		inline int getFrameNumber() { return mFrameNumber; }
 		inline void setFrameNumber(int n) { mFrameNumber = n; }
 		
 		bool isIntervalAdaptive();
 		void setAdaptiveInterval(bool adaptive);
 
+		/**
+		 * @brief Multi-rate stepping, disabled by default.
+		 *
+		 * If enabled, takeOneFrame() no longer advances the whole scene with the smallest time step of all nodes.
+		 * Nodes coupled through node ports form a group that advances in lockstep with the smallest time step of
+		 * its members, rounded down to an integer subdivision of the frame interval. Groups only connected through
+		 * fields advance one after another, each over the whole frame with its own subdivision, and synchronize at
+		 * the end of the frame. While a group takes its substeps, the FVar fields it reads from other groups are
+		 * linearly interpolated between their values at the start and the end of the frame, other fields are read
+		 * at the end of the frame.
+		 */
+		bool isMultiRate();
+		void setMultiRate(bool multiRate);
+
+		/**
+		 * @brief Pipelined frames, disabled by default.
+		 *
+		 * If enabled, takeOneFrame() copies the fields read by the graphics pipelines and the output modules into
+		 * snapshots once the simulation of a frame is done, and returns while these modules run on the snapshots in
+		 * a background thread. The next frame is simulated in the meantime, so that a frame costs the longer of both
+		 * phases instead of their sum. Two sets of snapshots are kept, the copies of a frame are taken while the
+		 * previous frame is still being presented. Modules see the same data as in serial order, except that graphics
+		 * modules see the frame number from before it is advanced, as output modules do. Results are identical as long
+		 * as the simulation does not read fields written by graphics or output modules, and these modules only access
+		 * node data through their input fields and parameters.
+		 *
+		 * A frame is presented serially if any of the fields can not be copied, see FBase::takeSnapshot().
+		 * updateGraphicsContext() does nothing while a frame is presented in the background.
+		 */
+		bool isPipelined();
+		void setPipelined(bool pipelined);
+
+		/**
+		 * @brief Wait until the graphics pipelines and the output modules of the last pipelined frame have finished
+		 */
+		void finishPresentation();
+
 		void setGravity(Vec3f g);
 		Vec3f getGravity();
 
@@ -145,6 +198,16 @@ namespace dyno
 		 */
 		void markQueueUpdateRequired();
 
+		/**
+		 * @brief Changed each time the execution queue is rebuilt, e.g., after nodes are added or deleted.
+		 * 	The version is unique across all scene graphs.
+		 */
+		inline uint queueVersion() {
+			updateExecutionQueue();
+
+			return mQueueVersion;
+		}
+
 	public:
 		void onMouseEvent(PMouseEvent event);
 
@@ -209,6 +272,16 @@ namespace dyno
 
 		void updateExecutionQueue();
 
+		void advanceMultiRate(float interval);
+
+		/**
+		 * @brief Snapshot the fields read by graphics and output modules and present them in the background,
+		 * 	returns false if a field does not support snapshots
+		 */
+		bool presentInBackground();
+
+		void waitForPresentation();
+
 	public:
 		SceneGraph()
 			: mElapsedTime(0)
@@ -233,6 +306,8 @@ namespace dyno
 	private:
 		bool mInitialized;
 		bool mAdvativeInterval = true;
+		bool mMultiRate = false;
+		bool mPipelined = false;
 
 		float mElapsedTime;
 		float mMaxTime;
@@ -250,6 +325,7 @@ namespace dyno
 		//std::shared_ptr<Node> mRoot = nullptr;
 
 		bool mQueueUpdateRequired = false;
+		uint mQueueVersion = 0;
 
 		NodeMap mNodeMap;
 
@@ -257,12 +333,22 @@ namespace dyno
 
 		bool mNodeTiming = false;
 		bool mModuleTiming = false;
+		bool mFrameInfo = true;
 
 		/**
-		 * A  lock to guarantee consistency across threads
+		 * A  lock to guarantee consistency across threads, held by initialize(), takeOneFrame() and reset()
 		 */
 		std::mutex mSync;
 
+		std::future<void> mPresentation;
+
+		/**
+		 * Snapshots of the top fields read by graphics and output modules, the set in use alternates between frames
+		 */
+		std::unordered_map<FBase*, std::shared_ptr<FBase>> mSnapshotBuffers[2];
+		std::unordered_map<FBase*, FBase*> mSnapshots[2];
+		int mSnapshotIndex = 0;
+
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "SceneGraphEnsemble.h"
+#include "SceneLoaderXML.h"
+#include "AssetCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include <ghc/fs_std.hpp>
+
+namespace dyno
+{
+	static std::vector<std::string> splitPath(const std::string& path)
+	{
+		std::vector<std::string> tokens;
+		std::stringstream ss(path);
+		std::string token;
+		while (std::getline(ss, token, '.'))
+			tokens.push_back(token);
+
+		return tokens;
+	}
+
+	static FBase* findField(OBase* obj, const std::string& name)
+	{
+		FBase* field = obj->getField(name);
+		if (field != nullptr)
+			return field;
+
+		for (auto f : obj->getAllFields())
+		{
+			if (f->getObjectName() == name)
+				return f;
+		}
+
+		return nullptr;
+	}
+
+	SceneGraphEnsemble::SceneGraphEnsemble(SceneCreator creator)
+	{
+		mCreator = creator;
+	}
+
+	SceneGraphEnsemble::SceneGraphEnsemble(std::shared_ptr<SceneGraph> templateScene)
+	{
+		std::stringstream name;
+		name << "peridyno_ensemble_" << templateScene.get() << ".xml";
+		mTemplateFile = (fs::temp_directory_path() / name.str()).string();
+
+		SceneLoaderXML loader;
+		if (!loader.save(templateScene, mTemplateFile))
+		{
+			Log::sendMessage(Log::Error, "Failed to save the template scene to " + mTemplateFile);
+			mTemplateFile.clear();
+		}
+	}
+
+	SceneGraphEnsemble::~SceneGraphEnsemble()
+	{
+		mMembers.clear();
+
+		if (!mTemplateFile.empty())
+		{
+			std::error_code ec;
+			fs::remove(mTemplateFile, ec);
+		}
+	}
+
+	uint SceneGraphEnsemble::addMember(const std::map<std::string, std::string>& overrides)
+	{
+		EnsembleMember member;
+		member.index = (uint)mMembers.size();
+		member.overrides = overrides;
+
+		mMembers.push_back(member);
+
+		return member.index;
+	}
+
+	void SceneGraphEnsemble::addSweep(const std::string& path, const std::vector<std::string>& values)
+	{
+		for (auto& value : values)
+		{
+			std::map<std::string, std::string> overrides;
+			overrides[path] = value;
+
+			this->addMember(overrides);
+		}
+	}
+
+	bool SceneGraphEnsemble::applyOverride(std::shared_ptr<SceneGraph> scn, const std::string& path, const std::string& value, std::string& error)
+	{
+		auto tokens = splitPath(path);
+		if (tokens.size() != 2 && tokens.size() != 3)
+		{
+			error = "Invalid field path " + path;
+			return false;
+		}
+
+		for (auto it = scn->begin(); it != scn->end(); it++)
+		{
+			auto node = it.get();
+			if (node->getName() != tokens[0] && node->getClassInfo()->getClassName() != tokens[0])
+				continue;
+
+			OBase* owner = node.get();
+			if (tokens.size() == 3)
+			{
+				owner = nullptr;
+				for (auto& m : node->getModuleList())
+				{
+					if (m->getName() == tokens[1] || m->getClassInfo()->getClassName() == tokens[1])
+					{
+						owner = m.get();
+						break;
+					}
+				}
+
+				if (owner == nullptr)
+					continue;
+			}
+
+			FBase* field = findField(owner, tokens.back());
+			if (field == nullptr)
+				continue;
+
+			if (!field->deserialize(value))
+			{
+				error = "Failed to set " + path + " to " + value;
+				return false;
+			}
+
+			return true;
+		}
+
+		error = "Field " + path + " is not found";
+		return false;
+	}
+
+	std::shared_ptr<SceneGraph> SceneGraphEnsemble::createMember(EnsembleMember& member)
+	{
+		std::shared_ptr<SceneGraph> scn;
+		if (mCreator != nullptr)
+		{
+			scn = mCreator();
+		}
+		else if (!mTemplateFile.empty())
+		{
+			SceneLoaderXML loader;
+			scn = loader.load(mTemplateFile);
+		}
+
+		if (scn == nullptr)
+		{
+			member.error = "Failed to create the scene";
+			return nullptr;
+		}
+
+		for (auto& o : member.overrides)
+		{
+			if (!applyOverride(scn, o.first, o.second, member.error))
+				return nullptr;
+		}
+
+		return scn;
+	}
+
+	void SceneGraphEnsemble::runMember(EnsembleMember& member)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		try {
+			auto scn = member.scene;
+			if (!scn->initialize())
+			{
+				member.error = "Failed to initialize the scene";
+				return;
+			}
+
+			for (uint i = 0; i < mFrameNumber; i++)
+			{
+				scn->takeOneFrame();
+				member.frames++;
+
+				if (mFrameCallback != nullptr)
+					mFrameCallback(member);
+			}
+
+			member.succeeded = true;
+		}
+		catch (const std::exception& e) {
+			member.error = e.what();
+		}
+
+		member.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (mFinishCallback != nullptr)
+			mFinishCallback(member);
+	}
+
+	bool SceneGraphEnsemble::run()
+	{
+		//Scene creation is not thread-safe, e.g., the XML loader and node registration, create all members up front
+		for (auto& member : mMembers)
+		{
+			member.succeeded = false;
+			member.error.clear();
+			member.frames = 0;
+			member.wallTime = 0.0;
+
+			member.scene = createMember(member);
+			if (member.scene != nullptr)
+			{
+				member.scene->printFrameInfo(false);
+				member.scene->setTotalTime(mFrameNumber * member.scene->getFrameInterval());
+			}
+		}
+
+		bool cacheEnabled = AssetCache::instance()->isEnabled();
+		AssetCache::instance()->setEnabled(true);
+
+		uint threadNum = mThreadNumber > 0 ? mThreadNumber : std::max(1u, std::thread::hardware_concurrency());
+		threadNum = std::min(threadNum, (uint)mMembers.size());
+
+		std::atomic<size_t> next(0);
+		auto worker = [&]() {
+			size_t i;
+			while ((i = next++) < mMembers.size())
+			{
+				if (mMembers[i].scene != nullptr)
+					runMember(mMembers[i]);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (uint t = 1; t < threadNum; t++)
+			threads.emplace_back(worker);
+
+		worker();
+
+		for (auto& t : threads)
+			t.join();
+
+		AssetCache::instance()->setEnabled(cacheEnabled);
+
+		bool succeeded = true;
+		for (auto& member : mMembers)
+		{
+			succeeded &= member.succeeded;
+			if (!member.succeeded)
+				Log::sendMessage(Log::Warning, "Ensemble member " + std::to_string(member.index) + " failed: " + member.error);
+		}
+
+		return succeeded;
+	}
+}
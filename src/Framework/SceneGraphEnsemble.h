@@ -0,0 +1,116 @@
+#pragma once
+#include "SceneGraph.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace dyno
+{
+	/**
+	 * @brief One variant of an ensemble, overrides map a field path to the serialized value of the field
+	 */
+	struct EnsembleMember
+	{
+		uint index = 0;
+
+		std::map<std::string, std::string> overrides;
+
+		std::shared_ptr<SceneGraph> scene;
+
+		bool succeeded = false;
+		std::string error;
+
+		uint frames = 0;
+		double wallTime = 0.0;	// in seconds
+	};
+
+	/*!
+	*	\class	SceneGraphEnsemble
+	*	\brief	Run many variants of the same scene graph concurrently in one process.
+	*
+	*	Each member is created from a template, either a creator function or a scene graph that is cloned through
+	*	its XML serialization, and then differs from the template in a few fields. A field is addressed by
+	*	"Node.Field" or "Node.Module.Field", where nodes and modules are matched by their names or class names,
+	*	and its value is set through FBase::deserialize().
+	*
+	*	Members are run on a pool of worker threads, the AssetCache is enabled during run() so that assets
+	*	loaded by several members are only read once. Modules must therefore query scene wide settings such as
+	*	the gravity through Module::getSceneGraph() instead of SceneGraphFactory::active(). For CUDA, kernels of
+	*	different members only overlap when compiled with per-thread default streams.
+	*/
+	class SceneGraphEnsemble
+	{
+	public:
+		typedef std::function<std::shared_ptr<SceneGraph>()> SceneCreator;
+		typedef std::function<void(EnsembleMember&)> MemberCallback;
+
+		explicit SceneGraphEnsemble(SceneCreator creator);
+
+		/**
+		 * @brief Members are cloned from the current state of the template scene via SceneLoaderXML
+		 */
+		explicit SceneGraphEnsemble(std::shared_ptr<SceneGraph> templateScene);
+
+		~SceneGraphEnsemble();
+
+		/**
+		 * @brief Add a member that differs from the template by the given field values
+		 *
+		 * @return index of the member
+		 */
+		uint addMember(const std::map<std::string, std::string>& overrides = {});
+
+		/**
+		 * @brief Add one member for each value of a field
+		 */
+		void addSweep(const std::string& path, const std::vector<std::string>& values);
+
+		void setFrameNumber(uint frames) { mFrameNumber = frames; }
+		uint getFrameNumber() { return mFrameNumber; }
+
+		/**
+		 * @brief Number of worker threads, 0 to use all hardware threads
+		 */
+		void setThreadNumber(uint num) { mThreadNumber = num; }
+
+		/**
+		 * @brief Called on the worker thread after each frame of a member, e.g., to collect results
+		 */
+		void setFrameCallback(MemberCallback callback) { mFrameCallback = callback; }
+
+		/**
+		 * @brief Called on the worker thread once a member has finished all frames
+		 */
+		void setFinishCallback(MemberCallback callback) { mFinishCallback = callback; }
+
+		/**
+		 * @brief Create, initialize and run all members
+		 *
+		 * @return true if all members succeeded
+		 */
+		bool run();
+
+		std::vector<EnsembleMember>& members() { return mMembers; }
+
+		/**
+		 * @brief Set the value of a field addressed by "Node.Field" or "Node.Module.Field"
+		 */
+		static bool applyOverride(std::shared_ptr<SceneGraph> scn, const std::string& path, const std::string& value, std::string& error);
+
+	private:
+		std::shared_ptr<SceneGraph> createMember(EnsembleMember& member);
+		void runMember(EnsembleMember& member);
+
+		SceneCreator mCreator;
+		std::string mTemplateFile;
+
+		uint mFrameNumber = 100;
+		uint mThreadNumber = 0;
+
+		MemberCallback mFrameCallback;
+		MemberCallback mFinishCallback;
+
+		std::vector<EnsembleMember> mMembers;
+	};
+}
@@ -23,15 +23,19 @@ namespace dyno
 
 	std::shared_ptr<SceneGraph> SceneGraphFactory::active()
 	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
 		//If no SceneGraph is created, return an empty one.
 		if (mSceneGraphs.empty())
-			this->createNewScene();
+			mSceneGraphs.push(std::make_shared<SceneGraph>());
 
 		return mSceneGraphs.top();
 	}
 
 	std::shared_ptr<SceneGraph> SceneGraphFactory::createNewScene()
 	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
 		mSceneGraphs.push(std::make_shared<SceneGraph>());
 
 		return mSceneGraphs.top();
@@ -39,20 +43,64 @@ namespace dyno
 
 	void SceneGraphFactory::pushScene(std::shared_ptr<SceneGraph> scn)
 	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
 		mSceneGraphs.push(scn);
 	}
 
 	void SceneGraphFactory::popScene()
 	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
 		mSceneGraphs.pop();
 	}
 
 	void SceneGraphFactory::popAllScenes()
 	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
 		while (!mSceneGraphs.empty())
 		{
 			mSceneGraphs.pop();
 		}
 	}
 
-}
\ No newline at end of file
+	bool SceneGraphFactory::registerScene(const std::string& name, SceneCreator creator)
+	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
+		if (creator == nullptr || mSceneCreators.find(name) != mSceneCreators.end())
+			return false;
+
+		mSceneCreators[name] = creator;
+
+		return true;
+	}
+
+	std::shared_ptr<SceneGraph> SceneGraphFactory::createRegisteredScene(const std::string& name)
+	{
+		SceneCreator creator;
+		{
+			std::lock_guard<std::mutex> tLock(mMutex);
+
+			auto iter = mSceneCreators.find(name);
+			if (iter == mSceneCreators.end())
+				return nullptr;
+
+			creator = iter->second;
+		}
+
+		return creator();
+	}
+
+	std::vector<std::string> SceneGraphFactory::registeredScenes()
+	{
+		std::lock_guard<std::mutex> tLock(mMutex);
+
+		std::vector<std::string> names;
+		for (auto& it : mSceneCreators)
+			names.push_back(it.first);
+
+		return names;
+	}
+}
@@ -15,6 +15,8 @@
  */
 #pragma once
 #include <atomic>
+#include <functional>
+#include <map>
 #include <mutex>
 
 #include "SceneGraph.h"
@@ -24,6 +26,8 @@ namespace dyno
 	class SceneGraphFactory
 	{
 	public:
+		typedef std::function<std::shared_ptr<SceneGraph>()> SceneCreator;
+
 		static SceneGraphFactory* instance();
 
 		std::shared_ptr<SceneGraph> active();
@@ -40,6 +44,22 @@ namespace dyno
 		void popScene();
 		void popAllScenes();
 
+		/**
+		 * @brief Register a function that creates a scene, e.g., within a plugin, so that the scene can be created by its name
+		 *
+		 * @return false if a scene with the same name has already been registered
+		 */
+		bool registerScene(const std::string& name, SceneCreator creator);
+
+		/**
+		 * @brief Create a scene registered by registerScene()
+		 *
+		 * @return nullptr if no scene is registered with the name
+		 */
+		std::shared_ptr<SceneGraph> createRegisteredScene(const std::string& name);
+
+		std::vector<std::string> registeredScenes();
+
 	private:
 		SceneGraphFactory() = default;
 		~SceneGraphFactory() = default;
@@ -48,6 +68,8 @@ namespace dyno
 
 		std::stack<std::shared_ptr<SceneGraph>> mSceneGraphs;
 
+		std::map<std::string, SceneCreator> mSceneCreators;
+
 	private:
 		static std::atomic<SceneGraphFactory*> pInstance;
 		static std::mutex mMutex;
@@ -0,0 +1,173 @@
+#include "text_file_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dyno{
+
+namespace FileUtilities{
+
+bool MappedTextFile::open(const std::string &filename)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr)
+		{
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (view != nullptr)
+			{
+				mFile = file;
+				mMapping = mapping;
+				mData = static_cast<const char*>(view);
+				mSize = static_cast<size_t>(size.QuadPart);
+				mOpen = true;
+				return true;
+			}
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+	{
+		void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view != MAP_FAILED)
+		{
+			madvise(view, st.st_size, MADV_SEQUENTIAL);
+			::close(fd);
+
+			mMapping = view;
+			mData = static_cast<const char*>(view);
+			mSize = static_cast<size_t>(st.st_size);
+			mOpen = true;
+			return true;
+		}
+	}
+	::close(fd);
+#endif
+
+	//fall back to reading the whole file
+	std::ifstream infile(filename, std::ios::binary);
+	if (!infile)
+		return false;
+
+	mBuffer.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+	mData = mBuffer.data();
+	mSize = mBuffer.size();
+	mOpen = true;
+
+	return true;
+}
+
+void MappedTextFile::close()
+{
+#ifdef _WIN32
+	if (mMapping != nullptr)
+	{
+		UnmapViewOfFile(mData);
+		CloseHandle(mMapping);
+		CloseHandle(mFile);
+	}
+#else
+	if (mMapping != nullptr)
+		munmap(mMapping, mSize);
+#endif
+
+	mMapping = nullptr;
+	mFile = nullptr;
+
+	mBuffer.clear();
+	mBuffer.shrink_to_fit();
+
+	mData = nullptr;
+	mSize = 0;
+	mOpen = false;
+}
+
+size_t parallelChunkNumber()
+{
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void parallelFor(size_t num, const std::function<void(size_t)> &func)
+{
+	size_t threadNum = std::min(num, parallelChunkNumber());
+	if (threadNum <= 1)
+	{
+		for (size_t i = 0; i < num; i++)
+			func(i);
+		return;
+	}
+
+	std::atomic<size_t> next(0);
+	auto worker = [&]() {
+		size_t i;
+		while ((i = next++) < num)
+			func(i);
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t t = 1; t < threadNum; t++)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (auto &t : threads)
+		t.join();
+}
+
+std::vector<const char*> splitLines(const char* p, const char* e, size_t maxChunks)
+{
+	std::vector<const char*> starts;
+	starts.push_back(p);
+
+	size_t stride = (e - p) / std::max<size_t>(maxChunks, 1) + 1;
+	while (true)
+	{
+		const char* q = starts.back() + stride;
+		if (q >= e)
+			break;
+
+		skipLine(q, e);
+		if (q >= e)
+			break;
+
+		starts.push_back(q);
+	}
+
+	starts.push_back(e);
+
+	return starts;
+}
+
+} //end of namespace FileUtilities
+
+} //end of namespace dyno
@@ -0,0 +1,227 @@
+/*
+ * @file text_file_parser.h
+ * @brief Memory mapped, multi-threaded parsing of line based text files, e.g., mesh files.
+ *
+ * The file is mapped into memory instead of being streamed. A sequence of records, one per line,
+ * is located with a single memchr pass and then split into chunks that are parsed in parallel.
+ * Numbers are parsed with std::from_chars, which neither allocates nor depends on the locale. Standard libraries
+ * without floating point std::from_chars, e.g., libstdc++ before GCC 11, fall back to strtod for floats.
+ */
+
+#ifndef PHYSIKA_CORE_UTILITIES_FILE_UTILITIES_TEXT_FILE_PARSER_H_
+#define PHYSIKA_CORE_UTILITIES_FILE_UTILITIES_TEXT_FILE_PARSER_H_
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dyno{
+
+namespace FileUtilities{
+
+//read-only view of a whole file, memory mapped if possible, otherwise read into a buffer
+class MappedTextFile
+{
+public:
+	MappedTextFile() {}
+	explicit MappedTextFile(const std::string &filename) { open(filename); }
+	~MappedTextFile() { close(); }
+
+	MappedTextFile(const MappedTextFile&) = delete;
+	MappedTextFile& operator=(const MappedTextFile&) = delete;
+
+	bool open(const std::string &filename);
+	void close();
+
+	bool isOpen() const { return mOpen; }
+
+	const char* begin() const { return mData; }
+	const char* end() const { return mData + mSize; }
+	size_t size() const { return mSize; }
+
+private:
+	bool mOpen = false;
+
+	const char* mData = nullptr;
+	size_t mSize = 0;
+
+	//platform handles of the mapping
+	void* mMapping = nullptr;
+	void* mFile = nullptr;
+
+	//used when the file can not be mapped, e.g., it is empty
+	std::vector<char> mBuffer;
+};
+
+inline bool isBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+//skip spaces and tabs, but stop at the end of the line
+inline void skipBlanks(const char* &p, const char* e)
+{
+	while (p < e && isBlank(*p)) ++p;
+}
+
+//skip all whitespaces including line breaks, the same as operator>> does
+inline void skipWhitespaces(const char* &p, const char* e)
+{
+	while (p < e && (isBlank(*p) || *p == '\n')) ++p;
+}
+
+//move p to the first character after the current line
+inline void skipLine(const char* &p, const char* e)
+{
+	const char* n = static_cast<const char*>(memchr(p, '\n', e - p));
+	p = n == nullptr ? e : n + 1;
+}
+
+//end of the line p is in, excluding the line break
+inline const char* lineEnd(const char* p, const char* e)
+{
+	const char* n = static_cast<const char*>(memchr(p, '\n', e - p));
+	return n == nullptr ? e : n;
+}
+
+//read the next whitespace separated token, line breaks are skipped
+inline std::string_view readToken(const char* &p, const char* e)
+{
+	skipWhitespaces(p, e);
+	const char* s = p;
+	while (p < e && !isBlank(*p) && *p != '\n') ++p;
+	return std::string_view(s, p - s);
+}
+
+template<typename T>
+inline std::from_chars_result fromChars(const char* p, const char* e, T &value)
+{
+	return std::from_chars(p, e, value);
+}
+
+#if !defined(__cpp_lib_to_chars)
+//the token is copied since the mapped file is not null terminated, strtod follows the C locale of the process
+template<typename T>
+inline std::from_chars_result fromCharsFloat(const char* p, const char* e, T &value)
+{
+	char buf[64];
+	size_t n = 0;
+	while (p + n < e && n + 1 < sizeof(buf) && !isBlank(p[n]) && p[n] != '\n')
+	{
+		buf[n] = p[n];
+		++n;
+	}
+	buf[n] = '\0';
+
+	char* end = nullptr;
+	double v = std::strtod(buf, &end);
+	if (end == buf)
+		return { p, std::errc::invalid_argument };
+
+	value = T(v);
+	return { p + (end - buf), std::errc() };
+}
+
+inline std::from_chars_result fromChars(const char* p, const char* e, float &value)
+{
+	return fromCharsFloat(p, e, value);
+}
+
+inline std::from_chars_result fromChars(const char* p, const char* e, double &value)
+{
+	return fromCharsFloat(p, e, value);
+}
+#endif
+
+//parse a number in [p, e) after skipping blanks, p is moved behind the number on success
+template<typename T>
+inline bool parseValue(const char* &p, const char* e, T &value)
+{
+	skipBlanks(p, e);
+	if (p < e && *p == '+') ++p;
+
+	auto ret = fromChars(p, e, value);
+	if (ret.ec != std::errc())
+		return false;
+
+	p = ret.ptr;
+	return true;
+}
+
+//the same as parseValue(), but line breaks are skipped as well
+template<typename T>
+inline bool readValue(const char* &p, const char* e, T &value)
+{
+	skipWhitespaces(p, e);
+	return parseValue(p, e, value);
+}
+
+//a record line is any line that is neither empty nor a '#' comment
+inline bool isRecordLine(const char* p, const char* e)
+{
+	skipBlanks(p, e);
+	return p < e && *p != '\n' && *p != '#';
+}
+
+//run func(chunk) for chunk in [0, num) on all hardware threads
+void parallelFor(size_t num, const std::function<void(size_t)> &func);
+
+//split [p, e) into at most maxChunks pieces that start at the beginning of a line
+std::vector<const char*> splitLines(const char* p, const char* e, size_t maxChunks);
+
+//number of chunks worth to parse in parallel
+size_t parallelChunkNumber();
+
+/**
+ * @brief Locate the next num record lines starting at p and call func(i, line, lineEnd) for each of them in parallel.
+ *	Records are independent from each other, so func may write record i into a preallocated array directly.
+ *
+ * @return number of records found, p is moved behind the last of them
+ */
+template<typename Func>
+size_t parseRecords(const char* &p, const char* e, size_t num, Func func)
+{
+	const size_t RECORDS_PER_CHUNK = 16384;
+
+	//a sequential memchr pass to find where each chunk of records starts
+	std::vector<const char*> starts;
+	size_t found = 0;
+	while (found < num && p < e)
+	{
+		if (isRecordLine(p, e))
+		{
+			if (found % RECORDS_PER_CHUNK == 0)
+				starts.push_back(p);
+			++found;
+		}
+		skipLine(p, e);
+	}
+
+	starts.push_back(p);
+
+	parallelFor(starts.size() - 1, [&](size_t chunk) {
+		const char* q = starts[chunk];
+		const char* end = starts[chunk + 1];
+
+		size_t i = chunk * RECORDS_PER_CHUNK;
+		while (q < end)
+		{
+			const char* le = lineEnd(q, end);
+			if (isRecordLine(q, le))
+				func(i++, q, le);
+			q = le < end ? le + 1 : end;
+		}
+	});
+
+	return found;
+}
+
+} //end of namespace FileUtilities
+
+} //end of namespace dyno
+
+#endif //PHYSIKA_CORE_UTILITIES_FILE_UTILITIES_TEXT_FILE_PARSER_H_
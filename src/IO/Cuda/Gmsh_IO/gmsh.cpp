@@ -1,113 +1,100 @@
 #include "gmsh.h"
+#include "File_Utilities/text_file_parser.h"
 #include <string.h>
-#include <fstream>
 #include <iostream>
-#include <sstream>
 
 using namespace std;
 
 namespace dyno
 {
 
+using namespace FileUtilities;
+
 void Gmsh::loadFile(string filename)
 {
-    fstream filein(filename);
-    if (!filein.is_open())
-    {
-        cout << "can't open Gmsh file:" << filename << endl;
-        exit(0);
-    }
+	MappedTextFile file(filename);
+	if (!file.isOpen())
+	{
+		cout << "can't open Gmsh file:" << filename << endl;
+		exit(0);
+	}
+
+	const char* p = file.begin();
+	const char* e = file.end();
 
-	int ignored_lines = 0;
 	bool version = false;
 	bool node = false;
-	//printf("YES\n");
-	std::string line;
-	while (!filein.eof()) {
-		std::getline(filein, line);
-		//std::cout << line << std::endl;
-		//.obj files sometimes contain vertex normals indicated by "vn"
-		if (line.substr(0, 1) != std::string("$")) {
-			if (!version)
-			{
-				version = true;
-			}
-			else
-			{
-				std::stringstream data(line);
-				int sum;
-				data >> sum;
-				//printf("sum = %d\n", sum);
-				if (!node)
-				{
-					node = true;
-					Real a, b, c;
-					int idx;
-					for (int i = 0; i < sum; i++)
-					{
-						//fscanf("%d%f%f%f", &idx, &a, &b, &c);
-						
-						std::getline(filein, line);
-						std::stringstream data(line);
-						data >> idx >> a >> b >> c;
-						//std::cout << idx << ' ' << a << ' ' << b << ' ' << c << std::endl;
-						m_points.push_back(Vec3f(a,b,c));
-					}
-					//printf("outside 1\n");
-				}
-				else
+	while (p < e)
+	{
+		const char* le = lineEnd(p, e);
+
+		//section tags, e.g., $Nodes, are ignored
+		if (*p == '$' || !isRecordLine(p, le))
+		{
+			skipLine(p, e);
+			continue;
+		}
+
+		if (!version)
+		{
+			version = true;
+			skipLine(p, e);
+			continue;
+		}
+
+		int sum = 0;
+		parseValue(p, le, sum);
+		skipLine(p, e);
+
+		if (!node)
+		{
+			node = true;
+
+			m_points.resize(sum);
+			size_t found = parseRecords(p, e, sum, [&](size_t i, const char* q, const char* qe) {
+				int idx;
+				Vec3f point(0.0f);
+				parseValue(q, qe, idx);
+				parseValue(q, qe, point[0]);
+				parseValue(q, qe, point[1]);
+				parseValue(q, qe, point[2]);
+				m_points[i] = point;
+			});
+			m_points.resize(found);
+		}
+		else
+		{
+			//only tetrahedra (element type 4) are kept, they are compacted after being parsed in parallel
+			std::vector<TopologyModule::Tetrahedron> elements(sum);
+			std::vector<char> isTet(sum, 0);
+			size_t found = parseRecords(p, e, sum, [&](size_t i, const char* q, const char* qe) {
+				int idx, type, tagNum, tag;
+				parseValue(q, qe, idx);
+				parseValue(q, qe, type);
+				parseValue(q, qe, tagNum);
+				for (int t = 0; t < tagNum; t++)
+					parseValue(q, qe, tag);
+
+				if (type == 4)
 				{
-					int idx1, idx2, idx3, idx4, idx5;
 					int id1, id2, id3, id4;
-					//printf("sum2 = %d\n", sum);
-
-					for (int i = 0; i < sum; i++)
-					{
-						filein >> idx1 >> idx2 >> idx3 >> idx4 >> idx5;
-						if (idx2 == 4)
-						{
-							filein >> id1 >> id2 >> id3 >> id4;
-							//std::cout << id1 << ' ' << id2 << ' ' << id3 << ' ' << id4 << std::endl;
-							/*if(
-								(m_points[id1 - 1][0] < 0.85f || ((m_points[id1 - 1][2] > 0.7f * (m_points[id1 - 1][0] - 0.85f) || ((m_points[id1 - 1][2] < -0.7f * (m_points[id1 - 1][0] - 0.85f))))))
-								&&						  																													
-								(m_points[id2 - 1][0] < 0.85f || ((m_points[id2 - 1][2] > 0.7f * (m_points[id2 - 1][0] - 0.85f) || ((m_points[id2 - 1][2] < -0.7f * (m_points[id2 - 1][0] - 0.85f))))))
-								&&						  																													
-								(m_points[id3 - 1][0] < 0.85f || ((m_points[id3 - 1][2] > 0.7f * (m_points[id3 - 1][0] - 0.85f) || ((m_points[id3 - 1][2] < -0.7f * (m_points[id3 - 1][0] - 0.85f))))))
-								&&						  																													
-								(m_points[id4 - 1][0] < 0.85f || ((m_points[id4 - 1][2] > 0.7f * (m_points[id4 - 1][0] - 0.85f) || ((m_points[id4 - 1][2] < -0.7f * (m_points[id4 - 1][0] - 0.85f))))))
-								)*/
-							{ 
-								m_tets.push_back(TopologyModule::Tetrahedron(id1 - 1, id2 - 1, id3 - 1, id4 - 1));
-							}
-						}
-						else if (idx2 == 15)
-						{
-							filein >> id1;
-						}
-						else if (idx2 == 1)
-						{
-							filein >> id1 >> id2;
-						}
-						else 
-						{
-							filein >> id1 >> id2 >> id3;
-						}
-					}
-					break;
+					parseValue(q, qe, id1);
+					parseValue(q, qe, id2);
+					parseValue(q, qe, id3);
+					parseValue(q, qe, id4);
+					elements[i] = TopologyModule::Tetrahedron(id1 - 1, id2 - 1, id3 - 1, id4 - 1);
+					isTet[i] = 1;
 				}
-			}
-			//std::stringstream data(line);
-			
+			});
 
-			//data >> point[0] >> point[1] >> point[2];
-		}
-		else {
-			++ignored_lines;
+			for (size_t i = 0; i < found; i++)
+			{
+				if (isTet[i])
+					m_tets.push_back(elements[i]);
+			}
+			break;
 		}
 	}
-	//printf("outside\n");
-	filein.close();
 }
 
 } // namespace dyno
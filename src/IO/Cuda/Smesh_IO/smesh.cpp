@@ -1,239 +1,204 @@
 #include "smesh.h"
+#include "File_Utilities/text_file_parser.h"
 #include <string.h>
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
 namespace dyno
 {
 
-void Smesh::loadFile(string filename)
+using namespace FileUtilities;
+
+//parse num records of the form "index x y z" into points
+static void parsePoints(const char* &p, const char* e, int num_points, int point_dim, std::vector<Vec3f>& points)
 {
-    fstream filein(filename);
-    if (!filein.is_open())
-    {
-        cout << "can't open smesh file:" << filename << endl;
-        exit(0);
-    }
-
-    string part_str;
-    filein >> part_str;
-    if (part_str != "*VERTICES")
-    {
-        cout << "first non-empty line must be '*VERTICES'." << endl;
-        exit(0);
-    }
-    int num_points = 0, point_dim = 0;
-    filein >> num_points >> point_dim;
-	int dummy;
-	filein >> dummy >> dummy;
-    m_points.resize(num_points, Vec3f(0.0f));
-    for (int i = 0; i < num_points; ++i)
-    {
-        int vert_index;
-        filein >> vert_index;
-        for (int j = 0; j < point_dim; ++j)
-        {
-            filein >> m_points[i][j];
-        }
-    }
-
-    filein >> part_str;
-//     if (part_str != "*ELEMENTS")
-//     {
-//         cout << "after vertices, the first non-empty line must be '*ELEMENTS'." << endl;
-//         return;
-//     }
-
-    while (!filein.eof())
-    {
-        string ele_type = "";
-		int num_eles = 0, ele_dim = 0;
-		filein >> ele_type >> num_eles >> ele_dim;
-		int dummy;
-		filein >> dummy;
-        if (ele_type == "LINE")
-        {
-            m_edges.resize(num_eles);
-            for (int i = 0; i < num_eles; ++i)
-            {
-                int ele_index;
-                filein >> ele_index;
-                for (int j = 0; j < ele_dim; ++j)
-                {
-                    filein >> m_edges[i][j];
-					m_edges[i][j] = m_edges[i][j] - 1;
-                }
-            }
-        }
-        else if (ele_type == "TRIANGLE")
-        {
-            m_triangles.resize(num_eles);
-            for (int i = 0; i < num_eles; ++i)
-            {
-                int ele_index;
-                filein >> ele_index;
-                for (int j = 0; j < ele_dim; ++j)
-                {
-                    filein >> m_triangles[i][j];
-					m_triangles[i][j] = m_triangles[i][j] - 1;
-                }
-            }
-        }
-        else if (ele_type == "QUAD")
-        {
-            m_quads.resize(num_eles);
-            for (int i = 0; i < num_eles; ++i)
-            {
-                int ele_index;
-                filein >> ele_index;
-                for (int j = 0; j < ele_dim; ++j)
-                {
-                    filein >> m_quads[i][j];
-					m_quads[i][j] = m_quads[i][j] - 1;
-                }
-            }
-        }
-        else if (ele_type == "TET")
-        {
-            m_tets.resize(num_eles);
-            for (int i = 0; i < num_eles; ++i)
-            {
-                int ele_index;
-                filein >> ele_index;
-                for (int j = 0; j < ele_dim; ++j)
-                {
-                    filein >> m_tets[i][j];
-					m_tets[i][j] = m_tets[i][j] - 1;
-                }
-            }
-        }
-        else if (ele_type == "HEX")
-        {
-            m_hexs.resize(num_eles);
-            for (int i = 0; i < num_eles; ++i)
-            {
-                int ele_index;
-                filein >> ele_index;
-                for (int j = 0; j < ele_dim; ++j)
-                {
-                    filein >> m_hexs[i][j];
-					m_hexs[i][j] = m_hexs[i][j] - 1;
-                }
-            }
-        }
-        else
-        {
-            cout << "unrecognized element type:" << ele_type << endl;
-        }
-    }
-
-	filein.close();
+	points.resize(num_points, Vec3f(0.0f));
+	size_t found = parseRecords(p, e, num_points, [&](size_t i, const char* q, const char* le) {
+		int vert_index;
+		parseValue(q, le, vert_index);
+		for (int j = 0; j < point_dim && j < 3; ++j)
+		{
+			parseValue(q, le, points[i][j]);
+		}
+	});
+
+	if (found < (size_t)num_points)
+	{
+		cout << "expected " << num_points << " vertices, but only found " << found << endl;
+		points.resize(found);
+	}
 }
 
-void Smesh::loadNodeFile(std::string filename)
+//parse num records of the form "index id_0 ... id_(dim-1)" into elements, offset is added to each id
+template<typename Element>
+static void parseElements(const char* &p, const char* e, int num_eles, int ele_dim, int offset, std::vector<Element>& elements)
 {
-	fstream filein(filename);
-	if (!filein.is_open())
+	elements.resize(num_eles);
+	size_t found = parseRecords(p, e, num_eles, [&](size_t i, const char* q, const char* le) {
+		int ele_index;
+		parseValue(q, le, ele_index);
+		for (int j = 0; j < ele_dim; ++j)
+		{
+			parseValue(q, le, elements[i][j]);
+			elements[i][j] = elements[i][j] + offset;
+		}
+	});
+
+	if (found < (size_t)num_eles)
 	{
-		cout << "can't open node file:" << filename << endl;
+		cout << "expected " << num_eles << " elements, but only found " << found << endl;
+		elements.resize(found);
+	}
+}
+
+void Smesh::loadFile(string filename)
+{
+	MappedTextFile file(filename);
+	if (!file.isOpen())
+	{
+		cout << "can't open smesh file:" << filename << endl;
 		exit(0);
 	}
 
+	const char* p = file.begin();
+	const char* e = file.end();
+
+	if (readToken(p, e) != "*VERTICES")
+	{
+		cout << "first non-empty line must be '*VERTICES'." << endl;
+		exit(0);
+	}
 	int num_points = 0, point_dim = 0;
-	filein >> num_points >> point_dim;
+	readValue(p, e, num_points);
+	readValue(p, e, point_dim);
 	int dummy;
-	filein >> dummy >> dummy;
-	m_points.resize(num_points, Vec3f(0.0f));
-	for (int i = 0; i < num_points; ++i)
+	readValue(p, e, dummy);
+	readValue(p, e, dummy);
+	skipLine(p, e);
+	parsePoints(p, e, num_points, point_dim, m_points);
+
+	//skip '*ELEMENTS'
+	readToken(p, e);
+
+	while (true)
 	{
-		int vert_index;
-		filein >> vert_index;
-		for (int j = 0; j < point_dim; ++j)
+		std::string_view ele_type = readToken(p, e);
+		if (ele_type.empty())
+			break;
+
+		if (ele_type[0] == '#')
 		{
-			filein >> m_points[i][j];
+			skipLine(p, e);
+			continue;
 		}
-	}
 
-	filein.close();
+		int num_eles = 0, ele_dim = 0;
+		readValue(p, e, num_eles);
+		readValue(p, e, ele_dim);
+		readValue(p, e, dummy);
+		skipLine(p, e);
+
+		if (ele_type == "LINE")
+		{
+			parseElements(p, e, num_eles, std::min(ele_dim, 2), -1, m_edges);
+		}
+		else if (ele_type == "TRIANGLE")
+		{
+			parseElements(p, e, num_eles, std::min(ele_dim, 3), -1, m_triangles);
+		}
+		else if (ele_type == "QUAD")
+		{
+			parseElements(p, e, num_eles, std::min(ele_dim, 4), -1, m_quads);
+		}
+		else if (ele_type == "TET")
+		{
+			parseElements(p, e, num_eles, std::min(ele_dim, 4), -1, m_tets);
+		}
+		else if (ele_type == "HEX")
+		{
+			parseElements(p, e, num_eles, std::min(ele_dim, 8), -1, m_hexs);
+		}
+		else
+		{
+			cout << "unrecognized element type:" << ele_type << endl;
+			skipLine(p, e);
+		}
+	}
 }
 
-void Smesh::loadEdgeFile(std::string filename)
+void Smesh::loadNodeFile(std::string filename)
 {
-	fstream filein(filename);
-	if (!filein.is_open())
+	MappedTextFile file(filename);
+	if (!file.isOpen())
 	{
-		cout << "can't open ele file:" << filename << endl;
+		cout << "can't open node file:" << filename << endl;
 		exit(0);
 	}
 
-	int num_of_edges = 0, edge_dim = 0;
-	filein >> num_of_edges >> edge_dim;
-	m_edges.resize(num_of_edges);
+	const char* p = file.begin();
+	const char* e = file.end();
 
-	int dummy;
-	for (int i = 0; i < num_of_edges; ++i)
+	int num_points = 0, point_dim = 0;
+	readValue(p, e, num_points);
+	readValue(p, e, point_dim);
+	skipLine(p, e);
+	parsePoints(p, e, num_points, point_dim, m_points);
+}
+
+void Smesh::loadEdgeFile(std::string filename)
+{
+	MappedTextFile file(filename);
+	if (!file.isOpen())
 	{
-		int vert_index;
-		filein >> vert_index;
-		
-		filein >> m_edges[i][0] >> m_edges[i][1] >> dummy;
+		cout << "can't open ele file:" << filename << endl;
+		exit(0);
 	}
 
-	filein.close();
+	const char* p = file.begin();
+	const char* e = file.end();
+
+	int num_of_edges = 0;
+	readValue(p, e, num_of_edges);
+	skipLine(p, e);
+	parseElements(p, e, num_of_edges, 2, 0, m_edges);
 }
 
 void Smesh::loadTriangleFile(std::string filename)
 {
-	fstream filein(filename);
-	if (!filein.is_open())
+	MappedTextFile file(filename);
+	if (!file.isOpen())
 	{
 		cout << "can't open ele file:" << filename << endl;
 		exit(0);
 	}
 
-	int dummy;
+	const char* p = file.begin();
+	const char* e = file.end();
 
 	int num_of_triangles = 0;
-	filein >> num_of_triangles >> dummy;
-	m_triangles.resize(num_of_triangles);
-
-	for (int i = 0; i < num_of_triangles; ++i)
-	{
-		int vert_index;
-		filein >> vert_index;
-
-		filein >> m_triangles[i][0] >> m_triangles[i][1] >> m_triangles[i][2] >> dummy;
-	}
-
-	filein.close();
+	readValue(p, e, num_of_triangles);
+	skipLine(p, e);
+	parseElements(p, e, num_of_triangles, 3, 0, m_triangles);
 }
 
 void Smesh::loadTetFile(std::string filename)
 {
-	fstream filein(filename);
-	if (!filein.is_open())
+	MappedTextFile file(filename);
+	if (!file.isOpen())
 	{
 		cout << "can't open ele file:" << filename << endl;
 		exit(0);
 	}
 
-	int ele_num = 0, ele_dim = 0;
-	int dummy;
-	filein >> ele_num >> ele_dim >> dummy;
+	const char* p = file.begin();
+	const char* e = file.end();
 
-	m_tets.resize(ele_num);
-	for (int i = 0; i < ele_num; ++i)
-	{
-		int ele_index;
-		filein >> ele_index;
-		for (int j = 0; j < ele_dim; ++j)
-		{
-			filein >> m_tets[i][j];
-		}
-	}
-
-	filein.close();
+	int ele_num = 0, ele_dim = 0;
+	readValue(p, e, ele_num);
+	readValue(p, e, ele_dim);
+	skipLine(p, e);
+	parseElements(p, e, ele_num, std::min(ele_dim, 4), 0, m_tets);
 }
 
 } // namespace dyno
@@ -1,7 +1,8 @@
 ﻿#include "ObjFileLoader.h"
-#include <fstream>
+#include "File_Utilities/text_file_parser.h"
+
 #include <iostream>
-#include <sstream>
+#include <algorithm>
 
 namespace dyno{
     
@@ -10,6 +11,82 @@ namespace dyno{
 		load(filename);
 	}
 
+	//results of one line aligned chunk of an obj file
+	struct ObjChunk
+	{
+		std::vector<Vec3f> vertices;
+		std::vector<TexCoord> texCoords;
+		std::vector<Face> faces;
+		std::vector<TexIndex> texIndices;
+		bool hasNormals = false;
+	};
+
+	//atoi() like parsing, 0 is returned if there is no number
+	static int parseIndex(const char* &p, const char* e)
+	{
+		int value = 0;
+		if (!FileUtilities::parseValue(p, e, value))
+			value = 0;
+		return value;
+	}
+
+	static void parseObjChunk(const char* p, const char* e, ObjChunk& chunk)
+	{
+		using namespace FileUtilities;
+
+		while (p < e)
+		{
+			const char* le = lineEnd(p, e);
+			const char* q = p;
+
+			if (*q == 'v' && q + 1 < le && q[1] == 'n') {
+				//.obj files sometimes contain vertex normals indicated by "vn"
+				chunk.hasNormals = true;
+			}
+			else if (*q == 'v' && q + 1 < le && q[1] == 't') {
+				q += 2;
+				TexCoord tex;
+				parseValue(q, le, tex[0]);
+				parseValue(q, le, tex[1]);
+				chunk.texCoords.push_back(tex);
+			}
+			else if (*q == 'v') {
+				q += 1;
+				Vec3f point;
+				parseValue(q, le, point[0]);
+				parseValue(q, le, point[1]);
+				parseValue(q, le, point[2]);
+				chunk.vertices.push_back(point);
+			}
+			else if (*q == 'f') {
+				q += 1;
+
+				Face faceIndex;
+				TexIndex texIndex;
+				for (int i = 0; i < 3; i++)
+				{
+					skipBlanks(q, le);
+					faceIndex[i] = parseIndex(q, le) - 1;
+
+					texIndex[i] = -1;
+					if (q < le && *q == '/')
+					{
+						++q;
+						texIndex[i] = parseIndex(q, le) - 1;
+					}
+
+					//skip the remainder of the token, e.g., the normal index
+					while (q < le && !isBlank(*q)) ++q;
+				}
+
+				chunk.faces.push_back(faceIndex);
+				chunk.texIndices.push_back(texIndex);
+			}
+
+			p = le < e ? le + 1 : e;
+		}
+	}
+
 	bool ObjFileLoader::load(const std::string &filename)
 	{
 		if (filename.size() < 5 || filename.substr(filename.size() - 4) != std::string(".obj")) {
@@ -17,81 +94,68 @@ namespace dyno{
 			exit(-1);
 		}
 
-		std::ifstream infile(filename);
-		if (!infile) {
+		FileUtilities::MappedTextFile file(filename);
+		if (!file.isOpen()) {
 			std::cerr << "Failed to open. Terminating.\n";
 			exit(-1);
 		}
 
-		int ignored_lines = 0;
-		std::string line;
-		std::vector<std::string> facelets;
-		while (!infile.eof()) {
-			std::getline(infile, line);
+		//parse line aligned chunks in parallel, then stitch them together in order
+		auto starts = FileUtilities::splitLines(file.begin(), file.end(), 4 * FileUtilities::parallelChunkNumber());
 
-			//.obj files sometimes contain vertex normals indicated by "vn"
-			if (line.substr(0, 1) == std::string("v") && line.substr(0, 2) != std::string("vn") && line.substr(0, 2) != std::string("vt")) {
-				std::stringstream data(line);
-				char c;
-				Vec3f point;
-				data >> c >> point[0] >> point[1] >> point[2];
-				vertList.push_back(point);
-			}
-			else if (line.substr(0, 1) == std::string("f")) {
-				facelets.push_back(line);
-			}
-			else if (line.substr(0, 2) == std::string("vn")) {
+		std::vector<ObjChunk> chunks(starts.size() - 1);
+		FileUtilities::parallelFor(chunks.size(), [&](size_t i) {
+			parseObjChunk(starts[i], starts[i + 1], chunks[i]);
+		});
+
+		size_t vertNum = 0, texNum = 0, faceNum = 0;
+		for (auto& chunk : chunks)
+		{
+			if (chunk.hasNormals) {
 				std::cerr << "Obj-loader is not able to parse vertex normals, please strip them from the input file. \n";
 				exit(-2);
 			}
-			else if (line.substr(0, 2) == std::string("vt")) {
-				std::stringstream data(line);
-				char c;
-				TexCoord tex;
-				data >> c >> tex[0] >> tex[1];
-				texCoords.push_back(tex);
-			}
-			else {
-				++ignored_lines;
-			}
-		}
 
-		for(auto line : facelets)
-		{
-			std::stringstream data(line);
-
-			std::string item;
-			std::getline(data, item, ' ');
+			vertNum += chunk.vertices.size();
+			texNum += chunk.texCoords.size();
+			faceNum += chunk.faces.size();
+		}
 
-			Face faceIndex;
-			TexIndex texIndex;
+		size_t vertOffset = vertList.size();
+		size_t texOffset = texCoords.size();
+		size_t faceOffset = faceList.size();
 
-			for(int i = 0; i < 3; i++)
-			{
-				std::getline(data, item, ' ');
-				std::stringstream vertexData(item);
+		vertList.resize(vertOffset + vertNum);
+		texCoords.resize(texOffset + texNum);
+		faceList.resize(faceOffset + faceNum);
 
-				std::string triId;
-				std::getline(vertexData, triId, '/');
-				faceIndex[i] = atoi(triId.c_str()) - 1;
+		//texture indices are only kept if the file contains texture coordinates
+		bool withTex = texCoords.size() > 0;
+		if (withTex)
+			texList.resize(faceOffset + faceNum);
 
-				if (texCoords.size() > 0)
-				{
-					std::string texId;
-					std::getline(vertexData, texId, '/');
-					texIndex[i] = atoi(texId.c_str()) - 1;
-				}
-			}
+		std::vector<size_t> vertStart(chunks.size()), texStart(chunks.size()), faceStart(chunks.size());
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			vertStart[i] = vertOffset;
+			texStart[i] = texOffset;
+			faceStart[i] = faceOffset;
 
-			faceList.push_back(faceIndex);
-			if (texCoords.size() > 0)
-			{
-				texList.push_back(texIndex);
-			}
+			vertOffset += chunks[i].vertices.size();
+			texOffset += chunks[i].texCoords.size();
+			faceOffset += chunks[i].faces.size();
 		}
 
-		infile.close();
-		facelets.clear();
+		FileUtilities::parallelFor(chunks.size(), [&](size_t i) {
+			auto& chunk = chunks[i];
+			std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertList.begin() + vertStart[i]);
+			std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + texStart[i]);
+			std::copy(chunk.faces.begin(), chunk.faces.end(), faceList.begin() + faceStart[i]);
+			if (withTex)
+				std::copy(chunk.texIndices.begin(), chunk.texIndices.end(), texList.begin() + faceStart[i]);
+		});
+
+		return true;
 	}
 
 	bool ObjFileLoader::save(const std::string &filename)
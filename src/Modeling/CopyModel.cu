@@ -1,8 +1,6 @@
 #include "CopyModel.h"
 #include "Topology/PointSet.h"
-#include "GLSurfaceVisualModule.h"
-#include "GLWireframeVisualModule.h"
-#include "GLPointVisualModule.h"
+#include "GLInstanceVisualModule.h"
 
 
 
@@ -13,83 +11,47 @@ namespace dyno
 		: ParametricModel<TDataType>()
 	{
 		this->stateTriangleSet()->setDataPtr(std::make_shared<TriangleSet<TDataType>>());
+		this->stateInstancedTriangleSet()->setDataPtr(std::make_shared<InstancedTriangleSet<TDataType>>());
 
-		auto glModule = std::make_shared<GLSurfaceVisualModule>();
+		//Render the input mesh once per copy instead of expanding all copies
+		auto glModule = std::make_shared<GLInstanceVisualModule>();
 		glModule->setColor(Color(0.8f, 0.52f, 0.25f));
 		glModule->setVisible(true);
-		this->stateTriangleSet()->connect(glModule->inTriangleSet());
+		this->inTriangleSetIn()->connect(glModule->inTriangleSet());
+		this->stateInstanceTransform()->connect(glModule->inInstanceTransform());
 		this->graphicsPipeline()->pushModule(glModule);
-
-		auto glModule2 = std::make_shared<GLPointVisualModule>();
-		glModule2->setColor(Color(1.0f, 0.1f, 0.1f));
-		glModule2->setVisible(false);
-		glModule2->varPointSize()->setValue(0.01);
-		this->stateTriangleSet()->connect(glModule2->inPointSet());
-		this->graphicsPipeline()->pushModule(glModule2);
-
-		auto glModule3 = std::make_shared<GLWireframeVisualModule>();
-		glModule3->setColor(Color(0.0f, 0.0f, 0.0f));
-		glModule3->setVisible(false);
-		this->stateTriangleSet()->connect(glModule3->inEdgeSet());
-		this->graphicsPipeline()->pushModule(glModule3);
 	}
 
 	template<typename TDataType>
 	void CopyModel<TDataType>::resetStates()
 	{
+		typedef SquareMatrix<Real, 3> Matrix;
+
 		auto center = this->varCopyTransform()->getData();
-		auto rot = this->varCopyRotation()->getData();
 		auto scale = this->varCopyScale()->getData();
 
-		auto triangleSet = this->stateTriangleSet()->getDataPtr();
-
-		auto VertexIn = this->inTriangleSetIn()->getData().getPoints();
-		auto TriangleIn = this->inTriangleSetIn()->getData().getTriangles();
-
-		std::vector<Coord> vertices;
-		std::vector<TopologyModule::Triangle> triangle;
+		auto centert = this->varLocation()->getData();
+		auto scalet = this->varScale()->getData();
 
-		CArray<TopologyModule::Triangle> c_triangle;
-		CArray<Coord> c_point;
-		c_point.assign(VertexIn);
-		c_triangle.assign(TriangleIn);
-		
-		int lengthV = VertexIn.size();
-		int lengthT = TriangleIn.size();
-		unsigned CopyNumber = this->varTotalNumber()->getData() - 1 ;
+		Quat<Real> q = this->computeQuaternion();
 
-		Coord Location;
-		//verticestriangle
-		for (int i = 0; i < lengthV; i++)
-		{
-			Location = { c_point[i][0], c_point[i][1], c_point[i][2] };
-			vertices.push_back( Location );
-		}
-		for (int i = 0; i < lengthT; i++)
-		{
-			triangle.push_back(TopologyModule::Triangle(c_triangle[i][0], c_triangle[i][1], c_triangle[i][2]));
-		}
+		//Model transform, applied after the copy transform
+		Matrix Mt = q.toMatrix3x3() * Matrix(scalet[0], 0, 0, 0, scalet[1], 0, 0, 0, scalet[2]);
 
+		std::vector<InstanceTransform> transforms;
 
-		//Copy
-		//
-		if (this->varTotalNumber()->getValue() > 1) 
+		if (!this->inTriangleSetIn()->isEmpty())
 		{
+			//The original model
+			transforms.push_back(InstanceTransform(centert, Mt, Coord(1)));
 
-			for(int i = 0;i < CopyNumber; i++)
+			unsigned CopyNumber = this->varTotalNumber()->getData();
+			for (unsigned i = 0; i + 1 < CopyNumber; i++)
 			{
-				//ԪԽеݹ任
-				Quat<Real> q = computeQuaternion();
-				q.normalize();
-
-				auto RV = [&](const Coord& v)->Coord {
-					return q.rotate(v );//center + q.rotate(v - center)
-				};
-
-				Vec3f RealScale = scale;
-				if (this->varScaleMode()->getData() == 0) 
+				Coord RealScale = scale;
+				if (this->varScaleMode()->getData() == 0)
 				{
-					for (int k = 0; k < i; k++)
+					for (unsigned k = 0; k < i; k++)
 					{
 						RealScale *= scale;
 					}
@@ -99,58 +61,31 @@ namespace dyno
 					RealScale = scale * 1 / (i + 1);
 				}
 
-				for (int j = 0; j < lengthV; j++)
-				{
-					Location = { c_point[j][0], c_point[j][1], c_point[j][2] };
-
-					Location = RV(Location * RealScale) + center * (i+1);//ӱ任RV(Location * RealScale + RV(center * (i + 1)))
-					vertices.push_back(Location);
-				}
-			}
-			
-			//
-			for (int i = 0; i < CopyNumber; i++) 
-			{
-				for (int j = 0; j < lengthT; j++)
-				{
-					;
-					triangle.push_back(TopologyModule::Triangle(c_triangle[j][0] + (i + 1) * lengthV, c_triangle[j][1] + (i + 1) * lengthV, c_triangle[j][2] + (i + 1) * lengthV));
-
-				}
-		
+				transforms.push_back(InstanceTransform(centert + Mt * (center * (i + 1)), Mt * q.toMatrix3x3(), RealScale));
 			}
 		}
 
-		//任
-		
-		auto centert = this->varLocation()->getData();
-		auto rott = this->varRotation()->getData();
-		auto scalet= this->varScale()->getData();
-
-		Quat<Real> qt = computeQuaternion();
+		this->stateInstanceTransform()->assign(transforms);
+		auto& instTransforms = this->stateInstanceTransform()->getData();
 
-		qt.normalize();
+		auto instances = this->stateInstancedTriangleSet()->getDataPtr();
+		instances->setPrototype(this->inTriangleSetIn()->getDataPtr());
+		instances->setTransforms(instTransforms);
+		instances->update();
 
-		auto RVt = [&](const Coord& v)->Coord {
-			return centert + qt.rotate(v - centert);
-		};
-
-		int numptt = vertices.size();
-
-		for (int i = 0; i < numptt; i++)
+		//Only expand the copies when a downstream node requires an explicit mesh
+		if (this->varExpandInstances()->getValue() || this->stateTriangleSet()->sizeOfSinks() > 0)
 		{
-			vertices[i] = RVt(vertices[i] * scalet + RVt(centert));
+			this->stateTriangleSet()->getDataPtr()->copyFrom(*instances->flatten());
+		}
+		else
+		{
+			TriangleSet<TDataType> empty;
+			this->stateTriangleSet()->getDataPtr()->copyFrom(empty);
 		}
 
-		triangleSet->setPoints(vertices);
-		triangleSet->setTriangles(triangle);
-
-
-		triangleSet->update();
-
-		vertices.clear();
-		triangle.clear();
+		transforms.clear();
 	}
 
 	DEFINE_CLASS(CopyModel);
-}
\ No newline at end of file
+}
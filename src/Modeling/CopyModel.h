@@ -18,6 +18,7 @@
 #include "Node/ParametricModel.h"
 
 #include "Topology/TriangleSet.h"
+#include "Topology/InstancedTriangleSet.h"
 
 namespace dyno
 {
@@ -29,6 +30,7 @@ namespace dyno
 	public:
 		typedef typename TDataType::Real Real;
 		typedef typename TDataType::Coord Coord;
+		typedef typename InstancedTriangleSet<TDataType>::InstanceTransform InstanceTransform;
 
 		CopyModel();
 
@@ -47,8 +49,17 @@ namespace dyno
 
 		DEF_ENUM(ScaleMode, ScaleMode, ScaleMode::Power, "ScaleMode");
 
+		DEF_VAR(bool, ExpandInstances, false, "Always expand all copies into TriangleSet");
+
+		/**
+		 * @brief The expanded mesh of all instances, only built on reset if a downstream node is connected to it or ExpandInstances is set
+		 */
 		DEF_INSTANCE_STATE(TriangleSet<TDataType>, TriangleSet, "");
 
+		DEF_INSTANCE_STATE(InstancedTriangleSet<TDataType>, InstancedTriangleSet, "The input mesh shared by all copies");
+
+		DEF_ARRAY_STATE(InstanceTransform, InstanceTransform, DeviceType::GPU, "One transform per copy");
+
 		DEF_INSTANCE_IN(TriangleSet<TDataType>, TriangleSetIn,"")
 
 	protected:
@@ -16,8 +16,8 @@
 
 #pragma once
 #include "Node/ParametricModel.h"
-#include "GLSurfaceVisualModule.h"
-#include "GLWireframeVisualModule.h"
+#include "Topology/InstancedTriangleSet.h"
+#include "GLInstanceVisualModule.h"
 
 
 namespace dyno
@@ -32,6 +32,7 @@ namespace dyno
 	public:
 		typedef typename TDataType::Real Real;
 		typedef typename TDataType::Coord Coord;
+		typedef typename InstancedTriangleSet<TDataType>::InstanceTransform InstanceTransform;
 
 		CopyToPoint();
 
@@ -42,8 +43,17 @@ namespace dyno
 	public:
 
 
+		DEF_VAR(bool, ExpandInstances, false, "Always expand all copies into TriangleSet");
+
+		/**
+		 * @brief The expanded mesh of all instances, only built on reset if a downstream node is connected to it or ExpandInstances is set
+		 */
 		DEF_INSTANCE_STATE(TriangleSet<TDataType>, TriangleSet, "");
 
+		DEF_INSTANCE_STATE(InstancedTriangleSet<TDataType>, InstancedTriangleSet, "The input mesh shared by all target points");
+
+		DEF_ARRAY_STATE(InstanceTransform, InstanceTransform, DeviceType::GPU, "One transform per target point");
+
 		DEF_INSTANCE_IN(TriangleSet<TDataType>, TriangleSetIn,"")
 
 		DEF_INSTANCE_IN(PointSet<TDataType>, TargetPointSet, "");
@@ -54,7 +64,7 @@ namespace dyno
 	protected:
 		void resetStates() override;
 
-		std::shared_ptr <GLSurfaceVisualModule> glModule;
+		std::shared_ptr <GLInstanceVisualModule> glModule;
 	};
 
 
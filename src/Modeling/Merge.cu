@@ -25,6 +25,8 @@ namespace dyno
 		this->inTriangleSet02()->tagOptional(true);
 		this->inTriangleSet03()->tagOptional(true);
 		this->inTriangleSet04()->tagOptional(true);
+		this->inTriangleSets()->tagOptional(true);
+		this->inPointSets()->tagOptional(true);
 
 		auto ptModule = std::make_shared<GLPointVisualModule>();
 		ptModule->setVisible(false);
@@ -38,220 +40,211 @@ namespace dyno
 	template<typename TDataType>
 	void Merge<TDataType>::resetStates()
 	{
-		MergeCPU();
-
+		mergeInputs(false);
 	}
+
 	template<typename TDataType>
 	void Merge<TDataType>::preUpdateStates()
 	{
 		Node::preUpdateStates();
 		if (this->varUpdateMode()->getData() == UpdateMode::Tick) 
 		{
-			MergeCPU();
+			mergeInputs(true);
 		}
-
-	
 	}
+
 	template<typename TDataType>
-	void Merge<TDataType>::MergeCPU() 
+	void Merge<TDataType>::collectInputs(std::vector<std::shared_ptr<PointSet<TDataType>>>& inputs)
 	{
-		TriangleSet<TDataType> TriangleSet01;
-		TriangleSet<TDataType> TriangleSet02;
-		TriangleSet<TDataType> TriangleSet03;
-		TriangleSet<TDataType> TriangleSet04;
-
-		DArray<TopologyModule::Triangle> d_triangle01;
-		CArray<TopologyModule::Triangle> c_triangle01;
-		DArray<TopologyModule::Triangle> d_triangle02;
-		CArray<TopologyModule::Triangle> c_triangle02;
-		DArray<TopologyModule::Triangle> d_triangle03;
-		CArray<TopologyModule::Triangle> c_triangle03;
-		DArray<TopologyModule::Triangle> d_triangle04;
-		CArray<TopologyModule::Triangle> c_triangle04;
-
-		DArray<Coord> d_point01;
-		CArray<Coord> c_point01;
-		DArray<Coord> d_point02;
-		CArray<Coord> c_point02;
-		DArray<Coord> d_point03;
-		CArray<Coord> c_point03;
-		DArray<Coord> d_point04;
-		CArray<Coord> c_point04;
-		std::vector<TopologyModule::Triangle> triangle;
-		std::vector<Coord>point;
-		printf("Initial\n");
-
-		auto triangleSet = this->stateTriangleSet()->getDataPtr();
-		printf("auto triangleSet\n");
-
-		int addtri = 0;
-		int addpt = 0;
+		inputs.clear();
 
 		if (!this->inTriangleSet01()->isEmpty())
-		{
-			TriangleSet01.copyFrom(this->inTriangleSet01()->getData());
-		}
+			inputs.push_back(this->inTriangleSet01()->constDataPtr());
+
 		if (!this->inTriangleSet02()->isEmpty())
-		{
-			TriangleSet02.copyFrom(this->inTriangleSet02()->getData());
-		}
+			inputs.push_back(this->inTriangleSet02()->constDataPtr());
+
 		if (!this->inTriangleSet03()->isEmpty())
-		{
-			TriangleSet03.copyFrom(this->inTriangleSet03()->getData());
-		}
+			inputs.push_back(this->inTriangleSet03()->constDataPtr());
+
 		if (!this->inTriangleSet04()->isEmpty())
-		{
-			TriangleSet04.copyFrom(this->inTriangleSet04()->getData());
-		}
-		printf("TriangleSet.copyFrom\n");
+			inputs.push_back(this->inTriangleSet04()->constDataPtr());
 
-		if (!this->inTriangleSet01()->isEmpty())
+		if (!this->inTriangleSets()->isEmpty())
 		{
-			d_triangle01 = this->inTriangleSet01()->getData().getTriangles();
-			d_point01 = this->inTriangleSet01()->getData().getPoints();
-
-			c_point01.assign(d_point01);
-			c_triangle01.assign(d_triangle01);
-
-			d_triangle01 = TriangleSet01.getTriangles();
-			d_point01 = TriangleSet01.getPoints();
-
-
-			int ptsize01 = d_point01.size();
-			for (int i = 0; i < ptsize01; i++)
+			auto& sets = this->inTriangleSets()->getData();
+			for (uint i = 0; i < sets.size(); i++)
 			{
-				point.push_back(c_point01[i]);
+				if (sets[i] != nullptr)
+					inputs.push_back(sets[i]);
 			}
+		}
 
-
-
-			int trisize01 = d_triangle01.size();
-			for (int i = 0; i < trisize01; i++)
+		if (!this->inPointSets()->isEmpty())
+		{
+			auto& sets = this->inPointSets()->getData();
+			for (uint i = 0; i < sets.size(); i++)
 			{
-				triangle.push_back(c_triangle01[i]);
+				if (sets[i] != nullptr)
+					inputs.push_back(sets[i]);
 			}
-
-			addpt = addpt + ptsize01;
-			addtri = addtri + trisize01;
-
 		}
+	}
 
-		if (!this->inTriangleSet02()->isEmpty())
-		{
-			d_triangle02 = this->inTriangleSet02()->getData().getTriangles();
-			d_point02 = this->inTriangleSet02()->getData().getPoints();
-
-			c_point02.assign(d_point02);
-			c_triangle02.assign(d_triangle02);
+	template<typename Triangle>
+	__global__ void MG_ShiftIndices(
+		DArray<Triangle> triangles,
+		DArray<uint> triangleOffsets,
+		DArray<uint> vertexOffsets)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= triangles.size()) return;
 
-			d_triangle02 = TriangleSet02.getTriangles();
-			d_point02 = TriangleSet02.getPoints();
+		//Find the input the triangle comes from, i.e., the last offset not larger than tId
+		int lo = 0;
+		int hi = triangleOffsets.size() - 1;
+		while (hi - lo > 1)
+		{
+			int mid = (lo + hi) / 2;
+			if (triangleOffsets[mid] <= tId)
+				lo = mid;
+			else
+				hi = mid;
+		}
 
+		uint shift = vertexOffsets[lo];
 
-			int ptsize02 = d_point02.size();
-			for (int i = 0; i < ptsize02; i++)
-			{
-				point.push_back(c_point02[i]);
-			}
+		Triangle t = triangles[tId];
+		triangles[tId] = Triangle(t[0] + shift, t[1] + shift, t[2] + shift);
+	}
 
+	template<typename Triangle>
+	__global__ void MG_CompareIndices(
+		DArray<int> mismatch,
+		DArray<Triangle> merged,
+		DArray<Triangle> triangles,
+		uint triangleOffset,
+		uint shift)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= triangles.size()) return;
 
+		Triangle t = triangles[tId];
+		Triangle m = merged[triangleOffset + tId];
 
-			int trisize02 = d_triangle02.size();
-			for (int i = 0; i < trisize02; i++)
-			{
-				triangle.push_back(TopologyModule::Triangle(c_triangle02[i][0] + addpt, c_triangle02[i][1] + addpt, c_triangle02[i][2] + addpt));//c_triangle02[i][0] + addpt, c_triangle02[i][1] + addpt, c_triangle02[i][2] + addpt
-			}
+		if (m[0] != int(t[0] + shift) || m[1] != int(t[1] + shift) || m[2] != int(t[2] + shift))
+			mismatch[0] = 1;
+	}
 
-			addpt = addpt + ptsize02;
-			addtri = addtri + trisize02;
+	template<typename TDataType>
+	bool Merge<TDataType>::isTriangleIndexUnchanged(std::vector<std::shared_ptr<PointSet<TDataType>>>& inputs)
+	{
+		auto& merged = this->stateTriangleSet()->getDataPtr()->getTriangles();
+		if (merged.size() != mTriangleOffsets.back())
+			return false;
 
-		}
+		//Connectivity may be edited in place without changing any number, compare it against the last merge
+		DArray<int> mismatch(1);
+		mismatch.reset();
 
-		if (!this->inTriangleSet03()->isEmpty())
+		for (uint i = 0; i < inputs.size(); i++)
 		{
-			d_triangle03 = this->inTriangleSet03()->getData().getTriangles();
-			d_point03 = this->inTriangleSet03()->getData().getPoints();
-
-			c_point03.assign(d_point03);
-			c_triangle03.assign(d_triangle03);
-
-			d_triangle03 = TriangleSet03.getTriangles();
-			d_point03 = TriangleSet03.getPoints();
-
+			auto ts = std::dynamic_pointer_cast<TriangleSet<TDataType>>(inputs[i]);
+			if (ts == nullptr || ts->getTriangles().size() == 0)
+				continue;
+
+			cuExecute(ts->getTriangles().size(),
+				MG_CompareIndices,
+				mismatch,
+				merged,
+				ts->getTriangles(),
+				mTriangleOffsets[i],
+				mVertexOffsets[i]);
+		}
 
-			int ptsize03 = d_point03.size();
-			for (int i = 0; i < ptsize03; i++)
-			{
-				point.push_back(c_point03[i]);
-			}
+		CArray<int> hMismatch;
+		hMismatch.assign(mismatch);
 
+		bool unchanged = hMismatch[0] == 0;
 
+		mismatch.clear();
+		hMismatch.clear();
 
-			int trisize03 = d_triangle03.size();
-			for (int i = 0; i < trisize03; i++)
-			{
-				triangle.push_back(TopologyModule::Triangle(c_triangle03[i][0] + addpt, c_triangle03[i][1] + addpt, c_triangle03[i][2] + addpt));//c_triangle02[i][0] + addpt, c_triangle02[i][1] + addpt, c_triangle02[i][2] + addpt
-			}
+		return unchanged;
+	}
 
-			addpt = addpt + ptsize03;
-			addtri = addtri + trisize03;
+	template<typename TDataType>
+	void Merge<TDataType>::mergeInputs(bool inPlace)
+	{
+		std::vector<std::shared_ptr<PointSet<TDataType>>> inputs;
+		this->collectInputs(inputs);
 
-		}
+		uint num = inputs.size();
 
-		if (!this->inTriangleSet04()->isEmpty())
+		std::vector<PointSet<TDataType>*> identities(num);
+		std::vector<uint> vertexOffsets(num + 1, 0);
+		std::vector<uint> triangleOffsets(num + 1, 0);
+		for (uint i = 0; i < num; i++)
 		{
-			d_triangle04 = this->inTriangleSet04()->getData().getTriangles();
-			d_point04 = this->inTriangleSet04()->getData().getPoints();
+			auto ts = std::dynamic_pointer_cast<TriangleSet<TDataType>>(inputs[i]);
 
-			c_point04.assign(d_point04);
-			c_triangle04.assign(d_triangle04);
+			identities[i] = inputs[i].get();
+			vertexOffsets[i + 1] = vertexOffsets[i] + inputs[i]->getPoints().size();
+			triangleOffsets[i + 1] = triangleOffsets[i] + (ts != nullptr ? ts->getTriangles().size() : 0);
+		}
 
-			d_triangle04 = TriangleSet04.getTriangles();
-			d_point04 = TriangleSet04.getPoints();
+		auto triangleSet = this->stateTriangleSet()->getDataPtr();
 
+		bool sameLayout = identities == mInputs && vertexOffsets == mVertexOffsets && triangleOffsets == mTriangleOffsets;
 
-			int ptsize04 = d_point04.size();
-			for (int i = 0; i < ptsize04; i++)
+		if (inPlace && sameLayout && isTriangleIndexUnchanged(inputs))
+		{
+			auto& vertices = triangleSet->getPoints();
+			for (uint i = 0; i < num; i++)
 			{
-				point.push_back(c_point04[i]);
+				vertices.assign(inputs[i]->getPoints(), vertexOffsets[i + 1] - vertexOffsets[i], vertexOffsets[i], 0);
 			}
 
+			return;
+		}
 
+		DArray<Coord> vertices(vertexOffsets[num]);
+		DArray<Triangle> triangles(triangleOffsets[num]);
 
-			int trisize04 = d_triangle04.size();
-			for (int i = 0; i < trisize04; i++)
-			{
-				triangle.push_back(TopologyModule::Triangle(c_triangle04[i][0] + addpt, c_triangle04[i][1] + addpt, c_triangle04[i][2] + addpt));//c_triangle02[i][0] + addpt, c_triangle02[i][1] + addpt, c_triangle02[i][2] + addpt
-			}
-
-			addpt = addpt + ptsize04;
-			addtri = addtri + trisize04;
+		for (uint i = 0; i < num; i++)
+		{
+			vertices.assign(inputs[i]->getPoints(), vertexOffsets[i + 1] - vertexOffsets[i], vertexOffsets[i], 0);
 
+			auto ts = std::dynamic_pointer_cast<TriangleSet<TDataType>>(inputs[i]);
+			if (ts != nullptr)
+				triangles.assign(ts->getTriangles(), triangleOffsets[i + 1] - triangleOffsets[i], triangleOffsets[i], 0);
 		}
 
-		printf("update PT\n");
-		triangleSet->setPoints(point);
-		triangleSet->setTriangles(triangle);
-		printf("Set\n");
+		DArray<uint> dVertexOffsets;
+		DArray<uint> dTriangleOffsets;
+		dVertexOffsets.assign(vertexOffsets);
+		dTriangleOffsets.assign(triangleOffsets);
 
+		if (triangles.size() > 0)
+		{
+			cuExecute(triangles.size(),
+				MG_ShiftIndices,
+				triangles,
+				dTriangleOffsets,
+				dVertexOffsets);
+		}
 
-		//triangleSet->update();
-
-		printf("update\n");
-
+		triangleSet->setPoints(vertices);
+		triangleSet->setTriangles(triangles);
 
-		point.clear();
-		triangle.clear();
-		c_point01.clear();
-		c_point02.clear();
-		c_point03.clear();
-		c_point04.clear();
-		c_triangle01.clear();
-		c_triangle02.clear();
-		c_triangle03.clear();
-		c_triangle04.clear();
-		printf("clear\n");
+		mInputs = identities;
+		mVertexOffsets = vertexOffsets;
+		mTriangleOffsets = triangleOffsets;
 
+		vertices.clear();
+		triangles.clear();
+		dVertexOffsets.clear();
+		dTriangleOffsets.clear();
 	}
 
 	template<typename TDataType>
@@ -263,4 +256,4 @@ namespace dyno
 
 
 	DEFINE_CLASS(Merge);
-}
\ No newline at end of file
+}
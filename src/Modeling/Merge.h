@@ -32,6 +32,7 @@ namespace dyno
 	public:
 		typedef typename TDataType::Real Real;
 		typedef typename TDataType::Coord Coord;
+		typedef typename TopologyModule::Triangle Triangle;
 
 		Merge();
 
@@ -46,6 +47,16 @@ namespace dyno
 		DEF_INSTANCE_IN(TriangleSet<TDataType>, TriangleSet03, "")
 
 		DEF_INSTANCE_IN(TriangleSet<TDataType>, TriangleSet04, "")
+
+		/**
+		 * @brief An arbitrary number of additional triangle sets, merged after the four fixed inputs
+		 */
+		DEF_INSTANCES_IN(TriangleSet<TDataType>, TriangleSet, "");
+
+		/**
+		 * @brief Point sets merged after all triangle sets, only their vertices are appended
+		 */
+		DEF_INSTANCES_IN(PointSet<TDataType>, PointSet, "");
 		
 		DECLARE_ENUM(UpdateMode,
 			Reset = 0,
@@ -57,11 +68,31 @@ namespace dyno
 
 		void disableRender();
 		void preUpdateStates()override;
-		void MergeCPU();
+
+		/**
+		 * @brief Merge all inputs on the GPU
+		 *
+		 * @param inPlace if true and the inputs, their vertex and triangle numbers and their triangle indices are
+		 *		unchanged since the last merge, only the vertex positions are copied and the triangle indices are reused
+		 */
+		void mergeInputs(bool inPlace = false);
+
 	protected:
 		void resetStates() override;
 
 		std::shared_ptr <GLSurfaceVisualModule> glModule;
+
+	private:
+		void collectInputs(std::vector<std::shared_ptr<PointSet<TDataType>>>& inputs);
+
+		bool isTriangleIndexUnchanged(std::vector<std::shared_ptr<PointSet<TDataType>>>& inputs);
+
+		//Inputs used in the last merge
+		std::vector<PointSet<TDataType>*> mInputs;
+
+		//Prefix sums of vertex and triangle numbers of the inputs used in the last merge
+		std::vector<uint> mVertexOffsets;
+		std::vector<uint> mTriangleOffsets;
 	};
 
 
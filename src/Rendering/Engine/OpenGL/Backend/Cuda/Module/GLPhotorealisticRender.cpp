@@ -48,7 +48,6 @@ namespace dyno
 			SURFACE_FRAG, sizeof(SURFACE_FRAG),
 			SURFACE_GEOM, sizeof(SURFACE_GEOM));
 		// create shader uniform buffer
-		mRenderParamsUBlock.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
 		mPBRMaterialUBlock.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
 
 		mPosition.create(GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_DRAW);
@@ -163,8 +162,7 @@ namespace dyno
 		mShaderProgram->setInt("uColorMode", 2);
 		mShaderProgram->setInt("uInstanced", 0);
 
-		mRenderParamsUBlock.load((void*)&rparams, sizeof(RenderParams));
-		mRenderParamsUBlock.bindBufferBase(0);
+		// the render params uniform block is bound by the render engine
 
 		mPosition.bindBufferBase(8);
 		mTexCoord.bindBufferBase(10);
@@ -61,7 +61,6 @@ namespace dyno
 
 	private:
 		gl::Program*	mShaderProgram;
-		gl::Buffer		mRenderParamsUBlock;
 		gl::Buffer		mPBRMaterialUBlock;
 		gl::VertexArray	mVAO;
 
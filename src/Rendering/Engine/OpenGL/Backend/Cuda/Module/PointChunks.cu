@@ -0,0 +1,268 @@
+#include "PointChunks.h"
+
+#include "Algorithm/Reduction.h"
+
+#include <thrust/sort.h>
+
+namespace dyno
+{
+	__device__ uint PC_ExpandBits(uint v)
+	{
+		v = (v * 0x00010001u) & 0xFF0000FFu;
+		v = (v * 0x00000101u) & 0x0F00F00Fu;
+		v = (v * 0x00000011u) & 0xC30C30C3u;
+		v = (v * 0x00000005u) & 0x49249249u;
+		return v;
+	}
+
+	__global__ void PC_CalculateMortonCode(
+		DArray<uint> keys,
+		DArray<uint> ids,
+		DArray<Vec3f> points,
+		Vec3f lo,
+		Vec3f scale)
+	{
+		int pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= points.size()) return;
+
+		Vec3f p = (points[pId] - lo) * scale;
+
+		uint x = (uint)fminf(fmaxf(p.x, 0.0f), 1023.0f);
+		uint y = (uint)fminf(fmaxf(p.y, 0.0f), 1023.0f);
+		uint z = (uint)fminf(fmaxf(p.z, 0.0f), 1023.0f);
+
+		keys[pId] = (PC_ExpandBits(x) << 2) | (PC_ExpandBits(y) << 1) | PC_ExpandBits(z);
+		ids[pId] = pId;
+	}
+
+	// place the point of rank r inside a full chunk at the bit reversal of r
+	__global__ void PC_PermuteInChunks(
+		DArray<uint> order,
+		DArray<uint> ids,
+		uint chunkSize,
+		uint chunkBits)
+	{
+		uint pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= ids.size()) return;
+
+		uint chunk = pId / chunkSize;
+		uint rank = pId % chunkSize;
+
+		uint slot = pId;
+		if ((chunk + 1) * chunkSize <= ids.size())
+			slot = chunk * chunkSize + (__brev(rank) >> (32 - chunkBits));
+
+		order[slot] = ids[pId];
+	}
+
+	// gather in place and flag the chunks whose values changed
+	__global__ void PC_Gather(
+		DArray<Vec3f> dst,
+		DArray<Vec3f> src,
+		DArray<uint> order,
+		DArray<uint> changed,
+		uint chunkSize)
+	{
+		uint pId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (pId >= order.size()) return;
+
+		Vec3f v = src[order[pId]];
+		Vec3f old = dst[pId];
+
+		if (v.x != old.x || v.y != old.y || v.z != old.z)
+		{
+			dst[pId] = v;
+			changed[pId / chunkSize] = 1;
+		}
+	}
+
+	__global__ void PC_ComputeChunkBounds(
+		DArray<Vec3f> lower,
+		DArray<Vec3f> upper,
+		DArray<Vec3f> points,
+		uint chunkSize)
+	{
+		uint cId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (cId >= lower.size()) return;
+
+		uint first = cId * chunkSize;
+		uint last = min(first + chunkSize, points.size());
+
+		Vec3f lo = points[first];
+		Vec3f hi = points[first];
+		for (uint i = first + 1; i < last; i++)
+		{
+			Vec3f p = points[i];
+			lo = lo.minimum(p);
+			hi = hi.maximum(p);
+		}
+
+		lower[cId] = lo;
+		upper[cId] = hi;
+	}
+
+	PointChunks::PointChunks()
+	{
+	}
+
+	PointChunks::~PointChunks()
+	{
+		mOrder.clear();
+		mPoints.clear();
+		mColors.clear();
+		mChanged.clear();
+		mLower.clear();
+		mUpper.clear();
+	}
+
+	void PointChunks::setChunkSize(uint size)
+	{
+		uint s = 1;
+		while (s < size && s < (1u << 30))
+			s <<= 1;
+
+		if (s != mChunkSize)
+		{
+			mChunkSize = s;
+			mOrder.clear();
+		}
+	}
+
+	void PointChunks::reorder(DArray<Vec3f>& points)
+	{
+		uint num = points.size();
+
+		Reduction<Vec3f> reduce;
+		Vec3f lo = reduce.minimum(points.begin(), num);
+		Vec3f hi = reduce.maximum(points.begin(), num);
+
+		Vec3f ext = hi - lo;
+		Vec3f scale(
+			ext.x > 0.0f ? 1024.0f / ext.x : 0.0f,
+			ext.y > 0.0f ? 1024.0f / ext.y : 0.0f,
+			ext.z > 0.0f ? 1024.0f / ext.z : 0.0f);
+
+		DArray<uint> keys(num);
+		DArray<uint> ids(num);
+
+		cuExecute(num,
+			PC_CalculateMortonCode,
+			keys,
+			ids,
+			points,
+			lo,
+			scale);
+
+		thrust::sort_by_key(thrust::device, keys.begin(), keys.begin() + keys.size(), ids.begin());
+
+		uint chunkBits = 0;
+		while ((1u << chunkBits) < mChunkSize)
+			chunkBits++;
+
+		mOrder.resize(num);
+		if (chunkBits == 0)
+			mOrder.assign(ids);
+		else
+		{
+			cuExecute(num,
+				PC_PermuteInChunks,
+				mOrder,
+				ids,
+				mChunkSize,
+				chunkBits);
+		}
+
+		keys.clear();
+		ids.clear();
+	}
+
+	void PointChunks::update(DArray<Vec3f>& points, DArray<Vec3f>* colors)
+	{
+		uint num = points.size();
+		uint chunkNum = (num + mChunkSize - 1) / mChunkSize;
+
+		bool reordered = false;
+		if (mOrder.size() != num || (mReorderInterval > 0 && mUpdateCount % mReorderInterval == 0))
+		{
+			if (num > 0)
+				reorder(points);
+
+			reordered = true;
+		}
+		mUpdateCount++;
+
+		if (mPoints.size() != num)
+			mPoints.resize(num);
+
+		mChanged.resize(chunkNum);
+		mChanged.reset();
+
+		if (num == 0)
+		{
+			mLowerBounds.clear();
+			mUpperBounds.clear();
+			mChangedRanges.clear();
+			return;
+		}
+
+		cuExecute(num,
+			PC_Gather,
+			mPoints,
+			points,
+			mOrder,
+			mChanged,
+			mChunkSize);
+
+		if (colors != nullptr && colors->size() == num)
+		{
+			if (mColors.size() != num)
+				mColors.resize(num);
+
+			cuExecute(num,
+				PC_Gather,
+				mColors,
+				*colors,
+				mOrder,
+				mChanged,
+				mChunkSize);
+		}
+
+		mLower.resize(chunkNum);
+		mUpper.resize(chunkNum);
+
+		cuExecute(chunkNum,
+			PC_ComputeChunkBounds,
+			mLower,
+			mUpper,
+			mPoints,
+			mChunkSize);
+
+		mLowerBounds.assign(mLower);
+		mUpperBounds.assign(mUpper);
+
+		mChangedRanges.clear();
+
+		// the whole layout changes once the points are reordered
+		if (reordered)
+		{
+			mChangedRanges.push_back(std::make_pair(0u, num));
+			return;
+		}
+
+		// merge adjacent changed chunks into ranges of points
+		mChangedHost.assign(mChanged);
+		for (uint c = 0; c < chunkNum; c++)
+		{
+			if (mChangedHost[c] == 0)
+				continue;
+
+			uint first = c * mChunkSize;
+			uint count = std::min(mChunkSize, num - first);
+
+			if (!mChangedRanges.empty() && mChangedRanges.back().first + mChangedRanges.back().second == first)
+				mChangedRanges.back().second += count;
+			else
+				mChangedRanges.push_back(std::make_pair(first, count));
+		}
+	}
+}
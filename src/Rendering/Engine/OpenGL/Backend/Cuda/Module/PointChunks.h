@@ -0,0 +1,78 @@
+#pragma once
+#include "Vector.h"
+#include "Array/Array.h"
+
+#include <vector>
+
+namespace dyno
+{
+	/**
+	 * @brief Points arranged into spatially coherent chunks for frustum culling and level of detail.
+	 *
+	 * Points are sorted by their Morton codes and split into chunks of chunkSize points. Inside each full chunk the
+	 * points are further permuted by the bit reversal of their ranks, so that the first chunkSize / 2^l points of a
+	 * chunk are exactly every 2^l-th point in Morton order, i.e., a coarser level of the chunk is just a shorter prefix.
+	 */
+	class PointChunks
+	{
+	public:
+		PointChunks();
+		~PointChunks();
+
+		/**
+		 * @brief Number of points per chunk, rounded up to a power of two
+		 */
+		void setChunkSize(uint size);
+		uint chunkSize() const { return mChunkSize; }
+
+		/**
+		 * @brief The Morton order is only recomputed when the number of points changes or every interval updates,
+		 * 	in between the points are gathered in the previous order and the chunk bounds are refit
+		 */
+		void setReorderInterval(uint interval) { mReorderInterval = interval; }
+
+		/**
+		 * @brief Gather points (and optionally colors) into the chunk layout
+		 */
+		void update(DArray<Vec3f>& points, DArray<Vec3f>* colors = nullptr);
+
+		DArray<Vec3f>& points() { return mPoints; }
+		DArray<Vec3f>& colors() { return mColors; }
+
+		uint pointNumber() const { return mPoints.size(); }
+		uint chunkNumber() const { return mLowerBounds.size(); }
+
+		/**
+		 * @brief Bounding boxes of chunks, copied to host for culling
+		 */
+		CArray<Vec3f>& lowerBounds() { return mLowerBounds; }
+		CArray<Vec3f>& upperBounds() { return mUpperBounds; }
+
+		/**
+		 * @brief Ranges of points [first, first + count) covering all chunks changed by the last update
+		 */
+		const std::vector<std::pair<uint, uint>>& changedRanges() const { return mChangedRanges; }
+
+	private:
+		void reorder(DArray<Vec3f>& points);
+
+		uint mChunkSize = 4096;
+		uint mReorderInterval = 32;
+		uint mUpdateCount = 0;
+
+		// mOrder[i] is the index of the source point stored at the i-th slot
+		DArray<uint> mOrder;
+
+		DArray<Vec3f> mPoints;
+		DArray<Vec3f> mColors;
+
+		DArray<uint> mChanged;
+		CArray<uint> mChangedHost;
+		std::vector<std::pair<uint, uint>> mChangedRanges;
+
+		DArray<Vec3f> mLower;
+		DArray<Vec3f> mUpper;
+		CArray<Vec3f> mLowerBounds;
+		CArray<Vec3f> mUpperBounds;
+	};
+}
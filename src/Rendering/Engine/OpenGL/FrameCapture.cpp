@@ -0,0 +1,255 @@
+#include "FrameCapture.h"
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace dyno
+{
+	FrameCapture::FrameCapture()
+	{
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		// GL objects have to be released by release() while the context is current
+		if (mWorker.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mQuit = true;
+			}
+			mQueueCond.notify_all();
+			mWorker.join();
+		}
+	}
+
+	void FrameCapture::initialize(int ringSize)
+	{
+		for (int i = 0; i < ringSize; i++)
+		{
+			std::unique_ptr<Slot> slot(new Slot());
+			slot->pbo.create(GL_PIXEL_PACK_BUFFER, GL_STREAM_READ);
+			mSlots.push_back(std::move(slot));
+		}
+
+		mQuit = false;
+		mWorker = std::thread(&FrameCapture::workerLoop, this);
+	}
+
+	void FrameCapture::release()
+	{
+		stop();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQuit = true;
+		}
+		mQueueCond.notify_all();
+
+		if (mWorker.joinable())
+			mWorker.join();
+
+		for (auto& slot : mSlots)
+			slot->pbo.release();
+
+		mSlots.clear();
+	}
+
+	bool FrameCapture::start(const std::string& path, Format format, unsigned int firstIndex)
+	{
+		stop();
+
+		mPath = path;
+		mFormat = format;
+		mFrameIndex = firstIndex;
+
+		if (format == RAW_VIDEO)
+		{
+			mVideoFile = fopen(path.c_str(), "wb");
+			if (mVideoFile == nullptr)
+			{
+				std::cerr << "Failed to open " << path << std::endl;
+				return false;
+			}
+		}
+
+		mCapturing = true;
+		return true;
+	}
+
+	void FrameCapture::stop()
+	{
+		if (!mCapturing)
+			return;
+
+		// drain the ring in the order the frames were issued
+		for (size_t i = 0; i < mSlots.size(); i++)
+		{
+			retire(*mSlots[(mNext + i) % mSlots.size()], true);
+		}
+
+		// wait for the worker
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mDoneCond.wait(lock, [&] { return mQueue.empty() && !mWorkerBusy; });
+		}
+
+		if (mVideoFile != nullptr)
+		{
+			fclose(mVideoFile);
+			mVideoFile = nullptr;
+		}
+
+		mCapturing = false;
+	}
+
+	void FrameCapture::capture(unsigned int fbo, int width, int height)
+	{
+		if (!mCapturing || mSlots.empty() || width <= 0 || height <= 0)
+			return;
+
+		// copy out frames that are already finished, so that they reach the worker as early as possible
+		for (size_t i = 0; i < mSlots.size(); i++)
+		{
+			if (!retire(*mSlots[(mNext + i) % mSlots.size()], false))
+				break;
+		}
+
+		// the slot to reuse holds the oldest frame, it only blocks if the GPU is a whole ring behind
+		Slot& slot = *mSlots[mNext];
+		retire(slot, true);
+
+		slot.width = width;
+		slot.height = height;
+		slot.index = mFrameIndex++;
+
+		slot.pbo.allocate(width * height * 3);
+
+		GLint prevRead;
+		glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevRead);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+		glReadBuffer(fbo == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+		slot.pbo.bind();
+		glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+		slot.pbo.unbind();
+
+		slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, prevRead);
+		gl::glCheckError();
+
+		mNext = (mNext + 1) % mSlots.size();
+	}
+
+	bool FrameCapture::retire(Slot& slot, bool wait)
+	{
+		if (slot.fence == nullptr)
+			return true;
+
+		GLsync fence = (GLsync)slot.fence;
+
+		GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+		if (status == GL_TIMEOUT_EXPIRED)
+			return false;
+
+		glDeleteSync(fence);
+		slot.fence = nullptr;
+
+		// the frame is dropped
+		if (status == GL_WAIT_FAILED)
+			return true;
+
+		Frame frame;
+		frame.width = slot.width;
+		frame.height = slot.height;
+		frame.index = slot.index;
+		frame.pixels.resize(slot.width * slot.height * 3);
+
+		slot.pbo.bind();
+		void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame.pixels.size(), GL_MAP_READ_BIT);
+		if (data != nullptr)
+		{
+			memcpy(frame.pixels.data(), data, frame.pixels.size());
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		slot.pbo.unbind();
+		gl::glCheckError();
+
+		if (data == nullptr)
+			return true;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mDoneCond.wait(lock, [&] { return mQueue.size() < mMaxQueued; });
+			mQueue.push_back(std::move(frame));
+		}
+		mQueueCond.notify_one();
+
+		return true;
+	}
+
+	void FrameCapture::writeFrame(Frame& frame)
+	{
+		size_t rowSize = frame.width * 3;
+
+		FILE* file = mVideoFile;
+		if (mFormat == PPM_SEQUENCE)
+		{
+			std::stringstream name;
+			name << mPath << frame.index << ".ppm";
+
+			file = fopen(name.str().c_str(), "wb");
+			if (file == nullptr)
+			{
+				std::cerr << "Failed to open " << name.str() << std::endl;
+				return;
+			}
+
+			fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height);
+		}
+
+		if (file == nullptr)
+			return;
+
+		// OpenGL rows start from the bottom
+		for (int j = frame.height - 1; j >= 0; j--)
+			fwrite(frame.pixels.data() + j * rowSize, 1, rowSize, file);
+
+		if (mFormat == PPM_SEQUENCE)
+			fclose(file);
+	}
+
+	void FrameCapture::workerLoop()
+	{
+		while (true)
+		{
+			Frame frame;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mQueueCond.wait(lock, [&] { return !mQueue.empty() || mQuit; });
+
+				if (mQueue.empty())
+					break;
+
+				frame = std::move(mQueue.front());
+				mQueue.pop_front();
+				mWorkerBusy = true;
+			}
+			mDoneCond.notify_all();
+
+			writeFrame(frame);
+
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mWorkerBusy = false;
+			}
+			mDoneCond.notify_all();
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gl/Buffer.h"
+
+namespace dyno
+{
+	/*!
+	*	\class	FrameCapture
+	*	\brief	Asynchronous readback of rendered frames.
+	*
+	*	Each call to capture() only issues a glReadPixels into the next pixel buffer object of a ring and inserts
+	*	a fence, the pixels are copied out once the fence has signaled, which is usually a few frames later. Encoding
+	*	and writing happen on a worker thread, so neither rendering nor simulation waits for the disk.
+	*
+	*	All methods except isCapturing() and frameNumber() must be called on the thread that owns the GL context.
+	*/
+	class FrameCapture
+	{
+	public:
+		enum Format
+		{
+			PPM_SEQUENCE,	//!< one binary ppm file per frame, named as <path>XXX.ppm
+			RAW_VIDEO		//!< all frames appended to the file <path> as top-down rgb24, e.g., for ffmpeg -f rawvideo
+		};
+
+		FrameCapture();
+		~FrameCapture();
+
+		void initialize(int ringSize = 3);
+		void release();
+
+		/**
+		 * @brief Start a new recording, frames are numbered from firstIndex
+		 */
+		bool start(const std::string& path, Format format = PPM_SEQUENCE, unsigned int firstIndex = 0);
+
+		/**
+		 * @brief Read back all frames in flight and wait until all of them are written
+		 */
+		void stop();
+
+		bool isCapturing() const { return mCapturing; }
+
+		/**
+		 * @brief Issue an asynchronous readback of the color buffer of the framebuffer fbo
+		 */
+		void capture(unsigned int fbo, int width, int height);
+
+		unsigned int frameNumber() const { return mFrameIndex; }
+
+	private:
+		struct Slot
+		{
+			gl::Buffer pbo;
+			void* fence = nullptr;
+
+			int width = 0;
+			int height = 0;
+			unsigned int index = 0;
+		};
+
+		struct Frame
+		{
+			int width;
+			int height;
+			unsigned int index;
+			std::vector<unsigned char> pixels;
+		};
+
+		// copy the pixels of a slot out once its fence has signaled, return false if the fence is not signaled yet
+		bool retire(Slot& slot, bool wait);
+
+		void writeFrame(Frame& frame);
+		void workerLoop();
+
+	private:
+		std::vector<std::unique_ptr<Slot>> mSlots;
+		size_t mNext = 0;
+
+		bool mCapturing = false;
+
+		std::string mPath;
+		Format mFormat = PPM_SEQUENCE;
+		unsigned int mFrameIndex = 0;
+
+		FILE* mVideoFile = nullptr;
+
+		// frames waiting for the worker, the render thread blocks once mMaxQueued frames are waiting
+		const size_t mMaxQueued = 16;
+		std::deque<Frame> mQueue;
+		std::mutex mMutex;
+		std::condition_variable mQueueCond;
+		std::condition_variable mDoneCond;
+		bool mWorkerBusy = false;
+		bool mQuit = false;
+
+		std::thread mWorker;
+	};
+}
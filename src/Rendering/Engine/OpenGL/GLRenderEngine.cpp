@@ -23,6 +23,7 @@
 #include <TrackballCamera.h>
 #include <unordered_set>
 #include <memory>
+#include <typeindex>
 
 #include "screen.vert.h"
 #include "blend.frag.h"
@@ -54,6 +55,12 @@ namespace dyno
 
 		createFramebuffer();
 
+		// shared render params of all visual modules
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		mRenderParamsStride = (sizeof(RenderParams) + alignment - 1) / alignment * alignment;
+		mRenderParamsBuffer.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
+
 		// OIT
 		setupTransparencyPass();
 
@@ -74,6 +81,10 @@ namespace dyno
 		for (auto item : mRenderItems) {
 			item.visualModule->release();
 		}
+		mRenderItems.clear();
+		mCachedScene = nullptr;
+
+		mRenderParamsBuffer.release();
 
 		// release framebuffer
 		mFramebuffer.release();
@@ -174,6 +185,16 @@ namespace dyno
 
 	void GLRenderEngine::updateRenderItems(dyno::SceneGraph* scene)
 	{
+		// module versions of pipelines only increase, so any change alters their sum
+		unsigned int queueVersion = scene->queueVersion();
+		unsigned int pipelineVersion = 0;
+		for (auto iter = scene->begin(); iter != scene->end(); iter++) {
+			pipelineVersion += iter->graphicsPipeline()->moduleVersion();
+		}
+
+		if (scene == mCachedScene && queueVersion == mCachedQueueVersion && pipelineVersion == mCachedPipelineVersion)
+			return;
+
 		std::vector<RenderItem> items;
 		for (auto iter = scene->begin(); iter != scene->end(); iter++) {
 			for (auto m : iter->graphicsPipeline()->activeModules()) {
@@ -182,12 +203,55 @@ namespace dyno
 			}
 		}
 
+		// group draws by shader, the order of nodes is kept within the same type of visual modules
+		std::stable_sort(items.begin(), items.end(), [](const RenderItem& a, const RenderItem& b) {
+			return std::type_index(typeid(*a.visualModule)) < std::type_index(typeid(*b.visualModule));
+		});
+
 		// release GL resource for unreferenced visual module
-		for (auto item : mRenderItems) {			
-			if (std::find(items.begin(), items.end(), item) == items.end())
+		std::unordered_set<GLVisualModule*> referenced;
+		for (auto& item : items) {
+			referenced.insert(item.visualModule.get());
+		}
+
+		for (auto& item : mRenderItems) {
+			if (referenced.find(item.visualModule.get()) == referenced.end())
 				item.visualModule->release();
 		}
 		mRenderItems = items;
+
+		mCachedScene = scene;
+		mCachedQueueVersion = queueVersion;
+		mCachedPipelineVersion = pipelineVersion;
+	}
+
+	void GLRenderEngine::loadRenderParams(const RenderParams& rparams, int pass)
+	{
+		size_t count = mRenderItems.size();
+		size_t passSize = count * mRenderParamsStride;
+
+		// records of both passes live in one buffer, so that uploading the second pass never waits for draws of the first one
+		if (mRenderParamsData.size() < passSize)
+			mRenderParamsData.resize(passSize);
+
+		if (pass == 0 && passSize > 0)
+			mRenderParamsBuffer.allocate((int)(2 * passSize));
+
+		for (size_t i = 0; i < count; i++)
+		{
+			RenderParams* params = (RenderParams*)(mRenderParamsData.data() + i * mRenderParamsStride);
+			*params = rparams;
+			params->index = (int)i;
+		}
+
+		if (passSize > 0)
+			mRenderParamsBuffer.load(mRenderParamsData.data(), (int)passSize, (int)(pass * passSize));
+	}
+
+	void GLRenderEngine::bindRenderParams(int pass, int i)
+	{
+		size_t offset = (pass * mRenderItems.size() + i) * mRenderParamsStride;
+		glBindBufferRange(GL_UNIFORM_BUFFER, 0, mRenderParamsBuffer.id, offset, sizeof(RenderParams));
 	}
 
 	void GLRenderEngine::draw(dyno::SceneGraph* scene, const RenderParams& rparams)
@@ -233,12 +297,14 @@ namespace dyno
 		// Step 2: render opacity objects
 		{
 			params.mode = GLRenderMode::COLOR;
+			loadRenderParams(params, 0);
 
 			for (int i = 0; i < mRenderItems.size(); i++) 
 			{
 				if (mRenderItems[i].node->isVisible() && !mRenderItems[i].visualModule->isTransparent())
 				{
 					params.index = i;
+					bindRenderParams(0, i);
 					mRenderItems[i].visualModule->draw(params);
 				}
 			}
@@ -274,11 +340,14 @@ namespace dyno
 			// OIT: first pass
 			glDepthMask(false);
 			params.mode = GLRenderMode::TRANSPARENCY;
+			loadRenderParams(params, 1);
+
 			for (int i = 0; i < mRenderItems.size(); i++) 
 			{
 				if (mRenderItems[i].node->isVisible() && mRenderItems[i].visualModule->isTransparent())
 				{
 					params.index = i;
+					bindRenderParams(1, i);
 					mRenderItems[i].visualModule->draw(params);
 				}
 			}
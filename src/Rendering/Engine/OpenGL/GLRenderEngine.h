@@ -59,6 +59,11 @@ namespace dyno
 		void setupTransparencyPass();
 		void updateRenderItems(dyno::SceneGraph* scene);
 
+		// upload the render params of one pass for all render items at once
+		void loadRenderParams(const RenderParams& rparams, int pass);
+		// bind the render params of the i-th render item to the uniform block binding 0
+		void bindRenderParams(int pass, int i);
+
 	private:
 
 		// objects to render
@@ -71,8 +76,19 @@ namespace dyno
 			}
 		};
 
+		// render items are sorted by the type of visual modules so that draws sharing the same shader are adjacent,
+		// and only rebuilt once the node queue of the scene or one of its graphics pipelines has changed
 		std::vector<RenderItem> mRenderItems;
 
+		dyno::SceneGraph* mCachedScene = nullptr;
+		unsigned int mCachedQueueVersion = 0;
+		unsigned int mCachedPipelineVersion = 0;
+
+		// one render params record per render item and pass, aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+		gl::Buffer		mRenderParamsBuffer;
+		int				mRenderParamsStride = 256;
+		std::vector<unsigned char> mRenderParamsData;
+
 	private:
 		// internal framebuffer
 		gl::Framebuffer	mFramebuffer;
@@ -12,6 +12,8 @@
 #ifdef CUDA_BACKEND
 // cuda
 #include <cuda_gl_interop.h>
+
+#include <glm/gtc/matrix_access.hpp>
 #endif
 
 #ifdef VK_BACKEND
@@ -59,9 +61,6 @@ namespace dyno
 			POINT_VERT, sizeof(POINT_VERT),
 			POINT_FRAG, sizeof(POINT_FRAG));
 
-		// create shader uniform buffer
-		mUniformBlock.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
-
 		gl::glCheckError();
 
 		return true;
@@ -75,8 +74,6 @@ namespace dyno
 		mPosition.release();
 		mColor.release();
 		mVertexArray.release();
-
-		mUniformBlock.release();
 	}
 
 	void GLPointVisualModule::updateGL()
@@ -99,6 +96,16 @@ namespace dyno
 			glDisableVertexAttribArray(1);
 			mVertexArray.unbind();
 		}
+
+#ifdef CUDA_BACKEND
+		mDrawChunks = mChunkLoaded;
+		if (mDrawChunks)
+		{
+			mDrawChunkSize = mChunks.chunkSize();
+			mChunkLower.assign(mChunks.lowerBounds().begin(), mChunks.lowerBounds().begin() + mChunks.chunkNumber());
+			mChunkUpper.assign(mChunks.upperBounds().begin(), mChunks.upperBounds().begin() + mChunks.chunkNumber());
+		}
+#endif
 	}
 
 	void GLPointVisualModule::updateImpl()
@@ -107,10 +114,39 @@ namespace dyno
 		auto pPointSet = this->inPointSet()->getDataPtr();
 		auto points = pPointSet->getPoints();
 
+		bool perVertexColor = this->varColorMode()->currentKey() == ColorMapMode::PER_VERTEX_SHADER
+			&& !this->inColor()->isEmpty();
+
+#ifdef CUDA_BACKEND
+		if (this->varLevelOfDetail()->getValue())
+		{
+			mChunks.setChunkSize(this->varChunkSize()->getValue());
+			mChunks.update(points, perVertexColor ? &this->inColor()->getData() : nullptr);
+
+			// only chunks whose points moved are uploaded once the buffers hold the chunk layout
+			if (mChunkLoaded)
+				mPosition.load(mChunks.points(), mChunks.changedRanges());
+			else
+				mPosition.load(mChunks.points());
+
+			if (perVertexColor)
+			{
+				if (mChunkLoaded)
+					mColor.load(mChunks.colors(), mChunks.changedRanges());
+				else
+					mColor.load(mChunks.colors());
+			}
+
+			mChunkLoaded = true;
+			return;
+		}
+
+		mChunkLoaded = false;
+#endif
+
 		mPosition.load(points);
 
-		if (this->varColorMode()->currentKey() == ColorMapMode::PER_VERTEX_SHADER
-			&& !this->inColor()->isEmpty())
+		if (perVertexColor)
 		{
 			auto colors = this->inColor()->getData();
 			mColor.load(colors);
@@ -122,10 +158,7 @@ namespace dyno
 		if (mNumPoints == 0)
 			return;
 
-		// setup uniform buffer
-		mUniformBlock.load((void*)&rparams, sizeof(RenderParams));
-		mUniformBlock.bindBufferBase(0);
-
+		// the render params uniform block is bound by the render engine
 		mShaderProgram->use();
 		mShaderProgram->setFloat("uPointSize", this->varPointSize()->getValue());
 
@@ -155,7 +188,98 @@ namespace dyno
 		glVertexAttrib3f(1, color.r, color.g, color.b);
 
 		mVertexArray.bind();
+
+#ifdef CUDA_BACKEND
+		if (mDrawChunks)
+		{
+			drawChunks(rparams);
+			gl::glCheckError();
+			return;
+		}
+#endif
+
 		glDrawArrays(GL_POINTS, 0, mNumPoints);
 		gl::glCheckError();
 	}
+
+#ifdef CUDA_BACKEND
+	void GLPointVisualModule::drawChunks(const RenderParams& rparams)
+	{
+		const glm::mat4& proj = rparams.transforms.proj;
+		glm::mat4 modelView = rparams.transforms.view * rparams.transforms.model;
+		glm::mat4 mvp = proj * modelView;
+
+		// frustum planes in model space, with normals pointing inwards
+		glm::vec4 r0 = glm::row(mvp, 0);
+		glm::vec4 r1 = glm::row(mvp, 1);
+		glm::vec4 r2 = glm::row(mvp, 2);
+		glm::vec4 r3 = glm::row(mvp, 3);
+		glm::vec4 planes[6] = { r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2 };
+
+		bool ortho = proj[3][3] == 1.0f;
+		float pixelScale = proj[1][1] * 0.5f * rparams.height;
+		float detail = this->varDetailScale()->getValue();
+
+		unsigned int chunkSize = mDrawChunkSize;
+		unsigned int chunkNum = (unsigned int)mChunkLower.size();
+
+		mDrawFirsts.clear();
+		mDrawCounts.clear();
+
+		for (unsigned int c = 0; c < chunkNum; c++)
+		{
+			glm::vec3 lo(mChunkLower[c].x, mChunkLower[c].y, mChunkLower[c].z);
+			glm::vec3 hi(mChunkUpper[c].x, mChunkUpper[c].y, mChunkUpper[c].z);
+
+			// the box is outside once its corner farthest along a plane normal is behind the plane
+			bool culled = false;
+			for (int i = 0; i < 6 && !culled; i++)
+			{
+				glm::vec3 n(planes[i]);
+				glm::vec3 p(n.x >= 0.0f ? hi.x : lo.x, n.y >= 0.0f ? hi.y : lo.y, n.z >= 0.0f ? hi.z : lo.z);
+				culled = glm::dot(n, p) + planes[i].w < 0.0f;
+			}
+
+			if (culled)
+				continue;
+
+			unsigned int first = c * chunkSize;
+			unsigned int count = std::min(chunkSize, mNumPoints - first);
+
+			// only full chunks are permuted, so that any power-of-two prefix is a uniform subsample
+			if (count == chunkSize)
+			{
+				glm::vec3 center = 0.5f * (lo + hi);
+				float radius = 0.5f * glm::length(hi - lo);
+				float depth = ortho ? 1.0f : -glm::vec3(modelView * glm::vec4(center, 1.0f)).z - radius;
+
+				if (depth > 0.0f)
+				{
+					float pixels = 2.0f * radius * pixelScale / depth;
+					float target = detail * pixels * pixels;
+
+					while (count > 1 && count / 2 >= target)
+						count /= 2;
+				}
+			}
+
+			// merge with the previous chunk if both are drawn in full
+			if (!mDrawFirsts.empty()
+				&& mDrawFirsts.back() + mDrawCounts.back() == (int)first
+				&& count == chunkSize)
+			{
+				mDrawCounts.back() += count;
+				continue;
+			}
+
+			mDrawFirsts.push_back(first);
+			mDrawCounts.push_back(count);
+		}
+
+		if (mDrawFirsts.empty())
+			return;
+
+		glMultiDrawArrays(GL_POINTS, mDrawFirsts.data(), mDrawCounts.data(), (GLsizei)mDrawFirsts.size());
+	}
+#endif
 }
@@ -22,6 +22,9 @@
 #include "gl/VertexArray.h"
 #include "gl/Shader.h"
 
+#ifdef CUDA_BACKEND
+#include "PointChunks.h"
+#endif
 
 namespace dyno
 {
@@ -58,6 +61,14 @@ namespace dyno
 
 		DEF_ENUM(ColorMapMode, ColorMode, ColorMapMode::PER_OBJECT_SHADER, "Color Mode");
 
+#ifdef CUDA_BACKEND
+		DEF_VAR(bool, LevelOfDetail, false, "Cull chunks of points outside the view and draw distant chunks with fewer points");
+
+		DEF_VAR(uint, ChunkSize, 4096, "Number of points per chunk, rounded up to a power of two");
+
+		DEF_VAR(float, DetailScale, 1.0f, "Number of points drawn per pixel covered by a chunk");
+#endif
+
 	protected:
 		virtual void updateImpl() override;
 
@@ -76,6 +87,21 @@ namespace dyno
 		unsigned int	mNumPoints;
 		gl::Program*	mShaderProgram = 0;
 
-		gl::Buffer		mUniformBlock;
+#ifdef CUDA_BACKEND
+		void drawChunks(const RenderParams& rparams);
+
+		// points sorted into chunks, only accessed while the update mutex is held
+		PointChunks		mChunks;
+		bool			mChunkLoaded = false;
+
+		// copies used by the render thread
+		bool			mDrawChunks = false;
+		unsigned int	mDrawChunkSize = 0;
+		std::vector<Vec3f>	mChunkLower;
+		std::vector<Vec3f>	mChunkUpper;
+
+		std::vector<int>	mDrawFirsts;
+		std::vector<int>	mDrawCounts;
+#endif
 	};
 };
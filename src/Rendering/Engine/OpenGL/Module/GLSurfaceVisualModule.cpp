@@ -67,7 +67,6 @@ namespace dyno
 			SURFACE_GEOM, sizeof(SURFACE_GEOM));
 
 		// create shader uniform buffer
-		mRenderParamsUBlock.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
 		mPBRMaterialUBlock.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
 
 		return true;
@@ -94,7 +93,6 @@ namespace dyno
 		mTexCoord.release();
 
 		// release uniform block
-		mRenderParamsUBlock.release();
 		mPBRMaterialUBlock.release();
 	}
 
@@ -239,11 +237,7 @@ namespace dyno
 		mShaderProgram->setInt("uColorMode", this->varColorMode()->currentKey());
 		mShaderProgram->setInt("uInstanced", mInstanceCount > 0);
 
-		// setup uniform buffer
-		mRenderParamsUBlock.load((void*)&rparams, sizeof(RenderParams));
-
-		// uniform block binding
-		mRenderParamsUBlock.bindBufferBase(0);
+		// uniform block binding, the render params uniform block is bound by the render engine
 		mPBRMaterialUBlock.bindBufferBase(1);
 
 		// bind vertex data
@@ -78,7 +78,6 @@ namespace dyno
 		gl::Program*	mShaderProgram;
 
 		// uniform blocks
-		gl::Buffer		mRenderParamsUBlock;
 		gl::Buffer		mPBRMaterialUBlock;
 
 		gl::VertexArray	mVAO;
@@ -50,9 +50,6 @@ namespace dyno
 			SURFACE_FRAG, sizeof(SURFACE_FRAG),
 			LINE_GEOM, sizeof(LINE_GEOM));
 
-		// create shader uniform buffer
-		mUniformBlock.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
-
 		return true;
 	}
 
@@ -64,8 +61,6 @@ namespace dyno
 		mVAO.release();
 		mVertexBuffer.release();
 		mIndexBuffer.release();
-
-		mUniformBlock.release();
 	}
 
 
@@ -98,10 +93,7 @@ namespace dyno
 		if (mNumEdges == 0)
 			return;
 
-		// setup uniform buffer
-		mUniformBlock.load((void*)&rparams, sizeof(RenderParams));
-		mUniformBlock.bindBufferBase(0);
-
+		// the render params uniform block is bound by the render engine
 		mShaderProgram->use();
 
 		if (rparams.mode == GLRenderMode::COLOR)
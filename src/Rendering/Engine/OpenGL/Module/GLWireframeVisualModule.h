@@ -71,7 +71,5 @@ namespace dyno
 		gl::XBuffer<Vec3f>						mVertexBuffer;
 		gl::XBuffer<TopologyModule::Edge>		mIndexBuffer;
 		unsigned int	mNumEdges = 0;
-
-		gl::Buffer		mUniformBlock;
 	};
 };
\ No newline at end of file
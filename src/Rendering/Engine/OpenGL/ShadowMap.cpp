@@ -60,6 +60,7 @@ namespace dyno
 
 		// uniform buffers
 		mShadowUniform.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
+		mRenderParamsUniform.create(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
 
 		// for blur depth textures
 		mQuad = gl::Mesh::ScreenQuad();
@@ -76,6 +77,7 @@ namespace dyno
 		mShadowBlur.release();
 
 		mShadowUniform.release();
+		mRenderParamsUniform.release();
 
 		mQuad->release();
 		delete mQuad;
@@ -222,6 +224,9 @@ namespace dyno
 			action.params.width = this->width;
 			action.params.height = this->height;
 
+			mRenderParamsUniform.load((void*)&action.params, sizeof(RenderParams));
+			mRenderParamsUniform.bindBufferBase(0);
+
 			scene->traverseForward(&action);
 
 			// blur shadow map		
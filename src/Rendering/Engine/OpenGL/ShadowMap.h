@@ -53,6 +53,7 @@ namespace dyno
 
 
 		gl::Buffer			mShadowUniform;	// uniform buffer for shadow lookup matrices
+		gl::Buffer			mRenderParamsUniform;	// render params of the shadow pass, shared by all visual modules
 
 	public:
 		int				width;
@@ -213,19 +213,33 @@ void main() { vDst[uDstPitch * gl_GlobalInvocationID.x + gl_GlobalInvocationID.y
 		// resized
 		if(newSize != this->size) {
 			allocate(newSize);
-			// need re-register resource
+			// need re-register resource, the content is kept on mapping since partial updates rely on it
 			if(resource != 0)
 				cuSafeCall(cudaGraphicsUnregisterResource(resource));
-			cuSafeCall(cudaGraphicsGLRegisterBuffer(&resource, id, cudaGraphicsRegisterFlagsWriteDiscard));
+			cuSafeCall(cudaGraphicsGLRegisterBuffer(&resource, id, cudaGraphicsRegisterFlagsNone));
+			fullUpdate = true;
 		}
 
+		if (!fullUpdate && dirtyRanges.empty())
+			return;
+
 		size_t size0;
 		void* devicePtr = 0;
 		cuSafeCall(cudaGraphicsMapResources(1, &resource));
 		cuSafeCall(cudaGraphicsResourceGetMappedPointer(&devicePtr, &size0, resource));
-		cuSafeCall(cudaMemcpy(devicePtr, buffer.begin(), size, cudaMemcpyDeviceToDevice));
+		if (fullUpdate) {
+			cuSafeCall(cudaMemcpy(devicePtr, buffer.begin(), size, cudaMemcpyDeviceToDevice));
+		}
+		else {
+			for (auto& r : dirtyRanges) {
+				cuSafeCall(cudaMemcpy((T*)devicePtr + r.first, buffer.begin() + r.first, r.second * sizeof(T), cudaMemcpyDeviceToDevice));
+			}
+		}
 		cuSafeCall(cudaGraphicsUnmapResources(1, &resource));
 
+		fullUpdate = false;
+		dirtyRanges.clear();
+
 #endif // CUDA_BACKEND
 
 #ifdef VK_BACKEND
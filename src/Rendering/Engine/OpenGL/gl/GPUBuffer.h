@@ -23,6 +23,8 @@
 #include <Matrix/Transform3x3.h>
 #include <Module/TopologyModule.h>
 
+#include <vector>
+
 #ifdef CUDA_BACKEND
 struct cudaGraphicsResource;
 #endif
@@ -55,6 +57,32 @@ namespace gl
 
 #ifdef CUDA_BACKEND
 			buffer.assign(data);
+			fullUpdate = true;
+#endif // CUDA_BACKEND
+		}
+
+		// load only the ranges of elements [first, first + count) that have changed since the last load,
+		// the next updateGL() then only copies these ranges
+		template<typename T1>
+		void load(dyno::DArray<T1> data, const std::vector<std::pair<dyno::uint, dyno::uint>>& ranges)
+		{
+#ifdef VK_BACKEND
+			this->loadVkBuffer(data.buffer(), data.bufferSize());
+#endif // VK_BACKEND
+
+#ifdef CUDA_BACKEND
+			if (buffer.size() != data.size())
+			{
+				buffer.assign(data);
+				fullUpdate = true;
+				return;
+			}
+
+			for (auto& r : ranges)
+			{
+				buffer.assign(data, r.second, r.first, r.first);
+				dirtyRanges.push_back(r);
+			}
 #endif // CUDA_BACKEND
 		}
 
@@ -86,6 +114,9 @@ namespace gl
 #ifdef CUDA_BACKEND
 		dyno::DArray<T>	buffer;
 		cudaGraphicsResource* resource = 0;
+
+		bool fullUpdate = true;
+		std::vector<std::pair<dyno::uint, dyno::uint>> dirtyRanges;
 #endif
 	};
 
@@ -66,6 +66,15 @@ namespace dyno
 	GlfwRenderWindow::~GlfwRenderWindow()
 	{
 		// Cleanup
+		mCapture.release();
+
+		if (mOffscreen)
+		{
+			mOffscreenFramebuffer.release();
+			mOffscreenColorTex.release();
+			mOffscreenDepthTex.release();
+		}
+
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
@@ -108,6 +117,16 @@ namespace dyno
 		// enable multisamples for anti alias
 		glfwWindowHint(GLFW_SAMPLES, 4);
 
+		if (mOffscreen)
+		{
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+			if (mOffscreenContext == CONTEXT_EGL)
+				glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+			else if (mOffscreenContext == CONTEXT_OSMESA)
+				glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+		}
+
 		// Create window with graphics context
 		mWindow = glfwCreateWindow(width, height, mWindowTitle.c_str(), NULL, NULL);
 		if (mWindow == NULL)
@@ -168,8 +187,9 @@ namespace dyno
 		ImGui_ImplOpenGL3_Init(glsl_version);
 
 		// Get Context scale
-		float xscale, yscale;
-		glfwGetMonitorContentScale(glfwGetPrimaryMonitor(), &xscale, &yscale);
+		float xscale = 1.0f, yscale = 1.0f;
+		if (glfwGetPrimaryMonitor() != nullptr)
+			glfwGetMonitorContentScale(glfwGetPrimaryMonitor(), &xscale, &yscale);
 
 		// initialize rendering engine
 		mRenderEngine->initialize();
@@ -178,6 +198,36 @@ namespace dyno
 		mImWindow.initialize(xscale);
 
 		this->setWindowSize(width, height);
+
+		mCapture.initialize();
+
+		if (mOffscreen)
+			createOffscreenFramebuffer(width, height);
+	}
+
+	void GlfwRenderWindow::createOffscreenFramebuffer(int width, int height)
+	{
+		mOffscreenColorTex.format = GL_RGBA;
+		mOffscreenColorTex.internalFormat = GL_RGBA8;
+		mOffscreenColorTex.type = GL_UNSIGNED_BYTE;
+		mOffscreenColorTex.create();
+		mOffscreenColorTex.resize(width, height);
+
+		mOffscreenDepthTex.internalFormat = GL_DEPTH_COMPONENT32;
+		mOffscreenDepthTex.format = GL_DEPTH_COMPONENT;
+		mOffscreenDepthTex.create();
+		mOffscreenDepthTex.resize(width, height);
+
+		mOffscreenFramebuffer.create();
+		mOffscreenFramebuffer.bind();
+		mOffscreenFramebuffer.setTexture2D(GL_COLOR_ATTACHMENT0, mOffscreenColorTex.id);
+		mOffscreenFramebuffer.setTexture2D(GL_DEPTH_ATTACHMENT, mOffscreenDepthTex.id);
+
+		const GLenum buffers[] = { GL_COLOR_ATTACHMENT0 };
+		mOffscreenFramebuffer.drawBuffers(1, buffers);
+
+		mOffscreenFramebuffer.checkStatus();
+		mOffscreenFramebuffer.unbind();
 	}
 
 	void GlfwRenderWindow::initializeStyle()
@@ -191,6 +241,12 @@ namespace dyno
 	
 	void GlfwRenderWindow::mainLoop()
 	{
+		if (mOffscreen)
+		{
+			offscreenLoop();
+			return;
+		}
+
 		auto activeScene = SceneGraphFactory::instance()->active();
 
 		activeScene->reset();
@@ -201,12 +257,12 @@ namespace dyno
 			
 			glfwPollEvents();
 
+			bool captureFrame = false;
 			if (mAnimationToggle){
 
 				if (mSaveScreenToggle)
 				{
-					if (activeScene->getFrameNumber() % mSaveScreenInterval == 0)
-						saveScreen();
+					captureFrame = activeScene->getFrameNumber() % mSaveScreenInterval == 0;
 				}
 
 				activeScene->takeOneFrame();
@@ -214,23 +270,27 @@ namespace dyno
 			
 			activeScene->updateGraphicsContext();
 
-			// update rendering params
-			mRenderParams.width = mCamera->viewportWidth();
-			mRenderParams.height = mCamera->viewportHeight();
-			mRenderParams.transforms.model = glm::mat4(1);	 // TODO: world transform?
-			mRenderParams.transforms.view = mCamera->getViewMat();
-			mRenderParams.transforms.proj = mCamera->getProjMat();
-
-			// Jian SHI: hack for unit scaling...
-			float planeScale = mRenderEngine->planeScale;
-			float rulerScale = mRenderEngine->rulerScale;
-			mRenderEngine->planeScale *= mCamera->unitScale();
-			mRenderEngine->rulerScale *= mCamera->unitScale();
+			drawScene();
 
-			mRenderEngine->draw(activeScene.get(), mRenderParams);
+			// record the scene without the GUI, the readback is asynchronous
+			if (captureFrame)
+			{
+				if (!mCapture.isCapturing())
+				{
+					std::string path = mCaptureFormat == FrameCapture::RAW_VIDEO ?
+						mOutputPath + std::string("screen_capture.rgb") : mOutputPath + std::string("screen_capture_");
+					mCapture.start(path, mCaptureFormat, mSaveScreenIndex);
+				}
 
-			mRenderEngine->planeScale = planeScale;
-			mRenderEngine->rulerScale = rulerScale;
+				int width, height;
+				glfwGetFramebufferSize(mWindow, &width, &height);
+				mCapture.capture(0, width, height);
+			}
+			else if (!mSaveScreenToggle && mCapture.isCapturing())
+			{
+				mCapture.stop();
+				mSaveScreenIndex = mCapture.frameNumber();
+			}
 
 			// Start the Dear ImGui frame
 			ImGui_ImplOpenGL3_NewFrame();
@@ -277,6 +337,47 @@ namespace dyno
 			glfwSwapBuffers(mWindow);
 		}
 
+		mCapture.stop();
+
+		mRenderEngine->terminate();
+	}
+
+	void GlfwRenderWindow::offscreenLoop()
+	{
+		auto activeScene = SceneGraphFactory::instance()->active();
+
+		activeScene->reset();
+
+		int width = mCamera->viewportWidth();
+		int height = mCamera->viewportHeight();
+
+		if (mSaveScreenToggle)
+		{
+			std::string path = mCaptureFormat == FrameCapture::RAW_VIDEO ?
+				mOutputPath + std::string("screen_capture.rgb") : mOutputPath + std::string("screen_capture_");
+			mCapture.start(path, mCaptureFormat, mSaveScreenIndex);
+		}
+
+		for (uint i = 0; i < mOffscreenFrames; i++)
+		{
+			bool captureFrame = mSaveScreenToggle && activeScene->getFrameNumber() % mSaveScreenInterval == 0;
+
+			activeScene->takeOneFrame();
+			activeScene->updateGraphicsContext();
+
+			// the render engine draws into the framebuffer bound at the time draw() is called
+			mOffscreenFramebuffer.bind(GL_DRAW_FRAMEBUFFER);
+			drawScene();
+
+			if (captureFrame)
+				mCapture.capture(mOffscreenFramebuffer.id, width, height);
+		}
+
+		mOffscreenFramebuffer.unbind();
+
+		mCapture.stop();
+		mSaveScreenIndex = mCapture.frameNumber();
+
 		mRenderEngine->terminate();
 	}
 
@@ -392,7 +493,25 @@ namespace dyno
 
 	void GlfwRenderWindow::drawScene(void)
 	{
-		
+		auto activeScene = SceneGraphFactory::instance()->active();
+
+		// update rendering params
+		mRenderParams.width = mCamera->viewportWidth();
+		mRenderParams.height = mCamera->viewportHeight();
+		mRenderParams.transforms.model = glm::mat4(1);	 // TODO: world transform?
+		mRenderParams.transforms.view = mCamera->getViewMat();
+		mRenderParams.transforms.proj = mCamera->getProjMat();
+
+		// Jian SHI: hack for unit scaling...
+		float planeScale = mRenderEngine->planeScale;
+		float rulerScale = mRenderEngine->rulerScale;
+		mRenderEngine->planeScale *= mCamera->unitScale();
+		mRenderEngine->rulerScale *= mCamera->unitScale();
+
+		mRenderEngine->draw(activeScene.get(), mRenderParams);
+
+		mRenderEngine->planeScale = planeScale;
+		mRenderEngine->rulerScale = rulerScale;
 	}
 
 	void GlfwRenderWindow::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
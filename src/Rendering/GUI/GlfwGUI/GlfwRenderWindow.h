@@ -5,6 +5,10 @@
 
 #include "RenderWindow.h"
 
+#include <FrameCapture.h>
+#include <gl/Framebuffer.h>
+#include <gl/Texture.h>
+
 struct GLFWwindow;
 namespace dyno {
 
@@ -18,6 +22,13 @@ namespace dyno {
 		GLFW_UP
 	};
 
+	enum OffscreenContext
+	{
+		CONTEXT_NATIVE = 0,	//the native context of the platform, e.g., GLX or WGL
+		CONTEXT_EGL,
+		CONTEXT_OSMESA		//Mesa's software rasterizer, a GLFW built with GLFW_USE_OSMESA is required if there is no display server
+	};
+
     class GlfwRenderWindow : public RenderWindow
     {
     public:
@@ -57,6 +68,22 @@ namespace dyno {
 		void setSaveScreenInterval(int n) { mSaveScreenInterval = n < 1 ? 1 : n; }
 		int getSaveScreenInternal() { return mSaveScreenInterval; }
 
+		/**
+		 * @brief Frames recorded by enableSaveScreen() are either a numbered ppm sequence or a single raw rgb24 stream
+		 */
+		void setCaptureFormat(FrameCapture::Format format) { mCaptureFormat = format; }
+
+		/**
+		 * @brief Render into a framebuffer object of an invisible window, must be called before initialize()
+		 *
+		 * In offscreen mode, mainLoop() takes the number of frames set by setOffscreenFrameNumber() and returns,
+		 * call enableSaveScreen() to record them.
+		 */
+		void setOffscreen(bool offscreen, OffscreenContext context = CONTEXT_EGL) { mOffscreen = offscreen; mOffscreenContext = context; }
+		bool isOffscreen() const { return mOffscreen; }
+
+		void setOffscreenFrameNumber(uint frames) { mOffscreenFrames = frames; }
+
 		void turnOnVSync();
 		void turnOffVSync();
 
@@ -77,6 +104,10 @@ namespace dyno {
 
 		void drawScene(void);
 
+		void offscreenLoop();
+
+		void createOffscreenFramebuffer(int width, int height);
+
 		static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 		static void keyboardCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 		static void reshapeCallback(GLFWwindow* window, int w, int h);
@@ -118,11 +149,22 @@ namespace dyno {
 		int mSaveScreenInterval = 1;
 
 		//current screen capture file index
-		uint mSaveScreenIndex;
+		uint mSaveScreenIndex = 0;
 
 		std::string mOutputPath;
 		std::string mWindowTitle;
 
+		FrameCapture mCapture;
+		FrameCapture::Format mCaptureFormat = FrameCapture::PPM_SEQUENCE;
+
+		bool mOffscreen = false;
+		OffscreenContext mOffscreenContext = CONTEXT_EGL;
+		uint mOffscreenFrames = 100;
+
+		gl::Framebuffer mOffscreenFramebuffer;
+		gl::Texture2D mOffscreenColorTex;
+		gl::Texture2D mOffscreenDepthTex;
+
 	private:
 		bool mShowImWindow = true;
 
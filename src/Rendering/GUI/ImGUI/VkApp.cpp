@@ -446,7 +446,7 @@ VkApp::~VkApp()
 	vkDestroyImage(ctx->deviceHandle(), depthStencil.image, nullptr);
 	vkFreeMemory(ctx->deviceHandle(), depthStencil.mem, nullptr);
 
-	vkDestroyPipelineCache(ctx->deviceHandle(), ctx->pipelineCacheHandle(), nullptr);
+	ctx->destroyPipelineCache();
 
 	vkDestroyCommandPool(ctx->deviceHandle(), cmdPool, nullptr);
 
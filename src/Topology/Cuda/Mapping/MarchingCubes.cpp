@@ -55,18 +55,40 @@ namespace dyno
 		Scan<int> scan;
 		scan.exclusive(voxelVertNum.begin(), voxelVertNum.size());
 
-		DArray<Coord> vertices(totalVNum);
+		DArray<Coord> vertices;
+		DArray<Coord> normals;
 
 		DArray<TopologyModule::Triangle> triangles(totalVNum / 3);
 
-		MarchingCubesHelper<TDataType>::constructTriangles(
-			vertices,
-			triangles,
-			voxelVertNum,
-			distances,
-			lowerBound,
-			isoValue,
-			h);
+		bool welded = this->varWelded()->getData();
+		bool gradientNormals = welded && this->varGradientNormals()->getData();
+
+		if (welded)
+		{
+			MarchingCubesHelper<TDataType>::constructWeldedTriangles(
+				vertices,
+				normals,
+				triangles,
+				voxelVertNum,
+				distances,
+				lowerBound,
+				isoValue,
+				h,
+				gradientNormals);
+		}
+		else
+		{
+			vertices.resize(totalVNum);
+
+			MarchingCubesHelper<TDataType>::constructTriangles(
+				vertices,
+				triangles,
+				voxelVertNum,
+				distances,
+				lowerBound,
+				isoValue,
+				h);
+		}
 
 		if (this->outTriangleSet()->isEmpty()) {
 			this->outTriangleSet()->setDataPtr(std::make_shared<TriangleSet<TDataType>>());
@@ -76,9 +98,14 @@ namespace dyno
 		triSet->setPoints(vertices);
 		triSet->setTriangles(triangles);
 
+		triSet->setAutoUpdateNormals(!gradientNormals);
+		if (gradientNormals)
+			triSet->setNormals(normals);
+
 		distances.clear();
 		voxelVertNum.clear();
 		vertices.clear();
+		normals.clear();
 		triangles.clear();
 	}
 
@@ -38,6 +38,10 @@ namespace dyno
 
 		DEF_VAR(Real, GridSpacing, Real(0.05), "");
 
+		DEF_VAR(bool, Welded, true, "Generate one vertex per grid edge crossed by the iso surface instead of welding a triangle soup");
+
+		DEF_VAR(bool, GradientNormals, false, "Compute vertex normals from the field gradient, only used in the welded mode");
+
 		DEF_INSTANCE_IN(SignedDistanceField<TDataType>, LevelSet, "A 3D signed distance field");
 
 		DEF_INSTANCE_OUT(TriangleSet<TDataType>, TriangleSet, "An iso surface");
@@ -2,6 +2,9 @@
 
 #include "Topology/EdgeSet.h"
 
+#include "Algorithm/Reduction.h"
+#include "Algorithm/Scan.h"
+
 #include <thrust/sort.h>
 
 namespace dyno
@@ -937,6 +940,226 @@ namespace dyno
 		newVertices.clear();
 	}
 
+	// edge slot of a cube edge, each grid node owns the three edges along +x, +y and +z
+	DYN_FUNC inline uint MCH_EdgeSlot(uint nodeId, uint axis)
+	{
+		return 3 * nodeId + axis;
+	}
+
+	template<typename Real>
+	DYN_FUNC Real MCH_Gradient(DArray3D<Real>& distances, int i, int j, int k, int axis)
+	{
+		int n[3] = { (int)distances.nx(), (int)distances.ny(), (int)distances.nz() };
+		int id[3] = { i, j, k };
+
+		int lo[3] = { i, j, k };
+		int hi[3] = { i, j, k };
+		lo[axis] = maximum(id[axis] - 1, 0);
+		hi[axis] = minimum(id[axis] + 1, n[axis] - 1);
+
+		if (hi[axis] == lo[axis]) return Real(0);
+
+		return (distances(hi[0], hi[1], hi[2]) - distances(lo[0], lo[1], lo[2])) / Real(hi[axis] - lo[axis]);
+	}
+
+	template<typename Real>
+	__global__ void MCH_CountActiveEdges(
+		DArray<int> counter,
+		DArray3D<Real> distances,
+		Real isoValue)
+	{
+		uint i = threadIdx.x + blockDim.x * blockIdx.x;
+		uint j = threadIdx.y + blockDim.y * blockIdx.y;
+		uint k = threadIdx.z + blockDim.z * blockIdx.z;
+
+		uint nx = distances.nx();
+		uint ny = distances.ny();
+		uint nz = distances.nz();
+
+		if (i >= nx || j >= ny || k >= nz) return;
+
+		uint nId = distances.index(i, j, k);
+		bool in0 = distances(i, j, k) < isoValue;
+
+		counter[MCH_EdgeSlot(nId, 0)] = i < nx - 1 && in0 != (distances(i + 1, j, k) < isoValue) ? 1 : 0;
+		counter[MCH_EdgeSlot(nId, 1)] = j < ny - 1 && in0 != (distances(i, j + 1, k) < isoValue) ? 1 : 0;
+		counter[MCH_EdgeSlot(nId, 2)] = k < nz - 1 && in0 != (distances(i, j, k + 1) < isoValue) ? 1 : 0;
+	}
+
+	template<typename Real, typename Coord>
+	__global__ void MCH_SetupEdgeVertices(
+		DArray<Coord> vertices,
+		DArray<Coord> normals,
+		DArray<int> counter,
+		DArray<int> radix,
+		DArray3D<Real> distances,
+		Coord origin,
+		Real isoValue,
+		Real h,
+		bool computeNormals)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= counter.size()) return;
+
+		if (counter[tId] == 0) return;
+
+		uint nx = distances.nx();
+		uint ny = distances.ny();
+
+		int axis = tId % 3;
+		int nId = tId / 3;
+
+		int i0 = nId % nx;
+		int j0 = (nId / nx) % ny;
+		int k0 = nId / (nx * ny);
+
+		int i1 = i0 + (axis == 0 ? 1 : 0);
+		int j1 = j0 + (axis == 1 ? 1 : 0);
+		int k1 = k0 + (axis == 2 ? 1 : 0);
+
+		Real f0 = distances(i0, j0, k0);
+		Real f1 = distances(i1, j1, k1);
+
+		Coord p0 = origin + h * Coord(i0, j0, k0);
+		Coord p1 = origin + h * Coord(i1, j1, k1);
+
+		int vId = radix[tId];
+		vertices[vId] = vertexInterp(isoValue, p0, p1, f0, f1);
+
+		if (computeNormals)
+		{
+			Real t = abs(f1 - f0) < EPSILON ? Real(0.5) : clamp((isoValue - f0) / (f1 - f0), Real(0), Real(1));
+
+			Coord g0(MCH_Gradient(distances, i0, j0, k0, 0), MCH_Gradient(distances, i0, j0, k0, 1), MCH_Gradient(distances, i0, j0, k0, 2));
+			Coord g1(MCH_Gradient(distances, i1, j1, k1, 0), MCH_Gradient(distances, i1, j1, k1, 1), MCH_Gradient(distances, i1, j1, k1, 2));
+
+			Coord n = (1 - t) * g0 + t * g1;
+			normals[vId] = n.norm() > EPSILON ? n.normalize() : Coord(0);
+		}
+	}
+
+	template<typename Triangle, typename Real>
+	__global__ void MCH_ConstructWeldedTriangles(
+		DArray<Triangle> triangles,
+		DArray<int> vertNum,
+		DArray<int> radix,
+		DArray3D<Real> distances,
+		Real isoValue)
+	{
+		uint i = threadIdx.x + blockDim.x * blockIdx.x;
+		uint j = threadIdx.y + blockDim.y * blockIdx.y;
+		uint k = threadIdx.z + blockDim.z * blockIdx.z;
+
+		uint nx = distances.nx();
+		uint ny = distances.ny();
+		uint nz = distances.nz();
+
+		if (i >= nx - 1 || j >= ny - 1 || k >= nz - 1) return;
+
+		uint cubeindex;
+		cubeindex = uint(distances(i, j, k) < isoValue);
+		cubeindex += uint(distances(i + 1, j, k) < isoValue) * 2;
+		cubeindex += uint(distances(i + 1, j + 1, k) < isoValue) * 4;
+		cubeindex += uint(distances(i, j + 1, k) < isoValue) * 8;
+		cubeindex += uint(distances(i, j, k + 1) < isoValue) * 16;
+		cubeindex += uint(distances(i + 1, j, k + 1) < isoValue) * 32;
+		cubeindex += uint(distances(i + 1, j + 1, k + 1) < isoValue) * 64;
+		cubeindex += uint(distances(i, j + 1, k + 1) < isoValue) * 128;
+
+		uint numVerts = numVertsTable[cubeindex];
+		if (numVerts == 0) return;
+
+		// map the 12 cube edges to the edge slots owned by grid nodes
+		uint edgelist[12];
+		edgelist[0] = MCH_EdgeSlot(distances.index(i, j, k), 0);
+		edgelist[1] = MCH_EdgeSlot(distances.index(i + 1, j, k), 1);
+		edgelist[2] = MCH_EdgeSlot(distances.index(i, j + 1, k), 0);
+		edgelist[3] = MCH_EdgeSlot(distances.index(i, j, k), 1);
+
+		edgelist[4] = MCH_EdgeSlot(distances.index(i, j, k + 1), 0);
+		edgelist[5] = MCH_EdgeSlot(distances.index(i + 1, j, k + 1), 1);
+		edgelist[6] = MCH_EdgeSlot(distances.index(i, j + 1, k + 1), 0);
+		edgelist[7] = MCH_EdgeSlot(distances.index(i, j, k + 1), 1);
+
+		edgelist[8] = MCH_EdgeSlot(distances.index(i, j, k), 2);
+		edgelist[9] = MCH_EdgeSlot(distances.index(i + 1, j, k), 2);
+		edgelist[10] = MCH_EdgeSlot(distances.index(i + 1, j + 1, k), 2);
+		edgelist[11] = MCH_EdgeSlot(distances.index(i, j + 1, k), 2);
+
+		int index1D = i + j * (nx - 1) + k * (nx - 1) * (ny - 1);
+
+		int tIdx = vertNum[index1D] / 3;
+		for (int n = 0; n < numVerts; n += 3)
+		{
+			int v0 = radix[edgelist[triTable[cubeindex][n]]];
+			int v1 = radix[edgelist[triTable[cubeindex][n + 1]]];
+			int v2 = radix[edgelist[triTable[cubeindex][n + 2]]];
+
+			triangles[tIdx++] = Triangle(v0, v1, v2);
+		}
+	}
+
+	template<typename TDataType>
+	void MarchingCubesHelper<TDataType>::constructWeldedTriangles(
+		DArray<Coord>& vertices,
+		DArray<Coord>& normals,
+		DArray<TopologyModule::Triangle>& triangles,
+		DArray<int>& vertNum,
+		DArray3D<Real>& distances,
+		Coord origin,
+		Real isoValue,
+		Real h,
+		bool computeNormals)
+	{
+		uint nodeNum = distances.nx() * distances.ny() * distances.nz();
+
+		DArray<int> counter(3 * nodeNum);
+
+		cuExecute3D(make_uint3(distances.nx(), distances.ny(), distances.nz()),
+			MCH_CountActiveEdges,
+			counter,
+			distances,
+			isoValue);
+
+		DArray<int> radix;
+		radix.assign(counter);
+
+		Reduction<int> reduce;
+		int num = reduce.accumulate(radix.begin(), radix.size());
+
+		Scan<int> scan;
+		scan.exclusive(radix.begin(), radix.size());
+
+		vertices.resize(num);
+		if (computeNormals)
+			normals.resize(num);
+		else
+			normals.clear();
+
+		cuExecute(counter.size(),
+			MCH_SetupEdgeVertices,
+			vertices,
+			normals,
+			counter,
+			radix,
+			distances,
+			origin,
+			isoValue,
+			h,
+			computeNormals);
+
+		cuExecute3D(make_uint3(distances.nx() - 1, distances.ny() - 1, distances.nz() - 1),
+			MCH_ConstructWeldedTriangles,
+			triangles,
+			vertNum,
+			radix,
+			distances,
+			isoValue);
+
+		counter.clear();
+		radix.clear();
+	}
+
 	template<typename Real, typename Coord>
 	__global__ void MCH_CountVertexNumberForClipper(
 		DArray<int> num,
@@ -54,6 +54,25 @@ namespace dyno
 			Real isoValue,
 			Real h);
 
+		/**
+		 * @brief Extract an indexed mesh with one vertex per grid edge crossed by the iso surface.
+		 *		No duplicated vertices are generated, so the output is watertight without a welding pass.
+		 *
+		 * @param normals vertex normals interpolated from the field gradient, only filled if computeNormals is true
+		 * @param vertNum exclusive scan of the vertex numbers returned by countVerticeNumber(),
+		 *		triangles should be allocated with the total number of vertices divided by 3
+		 */
+		static void constructWeldedTriangles(
+			DArray<Coord>& vertices,
+			DArray<Coord>& normals,
+			DArray<TopologyModule::Triangle>& triangles,
+			DArray<int>& vertNum,
+			DArray3D<Real>& distances,
+			Coord origin,
+			Real isoValue,
+			Real h,
+			bool computeNormals = false);
+
 		static void countVerticeNumberForClipper(
 			DArray<int>& num,
 			DistanceField3D<TDataType>& sdf,
@@ -2,6 +2,7 @@
 #include "DistanceField3D.h"
 #include "Vector.h"
 #include "DataTypes.h"
+#include "AssetCache.h"
 
 namespace dyno{
 
@@ -349,55 +350,76 @@ namespace dyno{
 		K_DistanceFieldToSphere << <gridDims, blockSize >> >(m_distance, m_left, m_h, center, radius, inverted);
 	}
 
+	//Parsed content of an SDF file, shared through the AssetCache
+	template<typename Real>
+	struct SDFFileData
+	{
+		int nx = 0, ny = 0, nz = 0;
+		Real left[3];
+		Real h;
+
+		CArray3D<Real> distances;
+	};
+
 	template<typename TDataType>
 	void DistanceField3D<TDataType>::loadSDF(std::string filename, bool inverted)
 	{
-		std::ifstream input(filename.c_str(), std::ios::in);
-		if (!input.is_open())
+		auto data = AssetCache::instance()->loadFile<SDFFileData<Real>>(filename, [&]() -> std::shared_ptr<SDFFileData<Real>> {
+			std::ifstream input(filename.c_str(), std::ios::in);
+			if (!input.is_open())
+				return nullptr;
+
+			auto sdf = std::make_shared<SDFFileData<Real>>();
+
+			input >> sdf->nx;
+			input >> sdf->ny;
+			input >> sdf->nz;
+
+			input >> sdf->left[0];
+			input >> sdf->left[1];
+			input >> sdf->left[2];
+
+			input >> sdf->h;
+
+			sdf->distances.resize(sdf->nx, sdf->ny, sdf->nz);
+			for (int k = 0; k < sdf->nz; k++) {
+				for (int j = 0; j < sdf->ny; j++) {
+					for (int i = 0; i < sdf->nx; i++) {
+						float dist;
+						input >> dist;
+						sdf->distances(i, j, k) = dist;
+					}
+				}
+			}
+			input.close();
+
+			return sdf;
+		});
+
+		if (data == nullptr)
 		{
 			std::cout << "Reading file " << filename << " error!" << std::endl;
 			exit(0);
 		}
 
-		int nbx, nby, nbz;
-		int xx, yy, zz;
-
-		input >> xx;
-		input >> yy;
-		input >> zz;
+		int xx = data->nx;
+		int yy = data->ny;
+		int zz = data->nz;
 
-		input >> m_left[0];
-		input >> m_left[1];
-		input >> m_left[2];
+		m_left = Coord(data->left[0], data->left[1], data->left[2]);
 
-		Real t_h;
-		input >> t_h;
+		Real t_h = data->h;
 
 		std::cout << "SDF: " << xx << ", " << yy << ", " << zz << std::endl;
 		std::cout << "SDF: " << m_left[0] << ", " << m_left[1] << ", " << m_left[2] << std::endl;
 		std::cout << "SDF: " << m_left[0] + t_h*xx << ", " << m_left[1] + t_h*yy << ", " << m_left[2] + t_h*zz << std::endl;
 
-		nbx = xx;
-		nby = yy;
-		nbz = zz;
 		m_h[0] = t_h;
 		m_h[1] = t_h;
 		m_h[2] = t_h;
 
-		CArray3D<Real> distances(nbx, nby, nbz);
-		for (int k = 0; k < zz; k++) {
-			for (int j = 0; j < yy; j++) {
-				for (int i = 0; i < xx; i++) {
-					float dist;
-					input >> dist;
-					distances(i, j, k) = dist;
-				}
-			}
-		}
-		input.close();
-
-		m_distance.resize(nbx, nby, nbz);
-		m_distance.assign(distances);
+		m_distance.resize(xx, yy, zz);
+		m_distance.assign(data->distances);
 
 		m_bInverted = inverted;
 		if (inverted)
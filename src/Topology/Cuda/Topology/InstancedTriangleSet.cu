@@ -0,0 +1,152 @@
+#include "InstancedTriangleSet.h"
+
+namespace dyno
+{
+	IMPLEMENT_TCLASS(InstancedTriangleSet, TDataType)
+
+	template<typename TDataType>
+	InstancedTriangleSet<TDataType>::InstancedTriangleSet()
+		: TopologyModule()
+	{
+	}
+
+	template<typename TDataType>
+	InstancedTriangleSet<TDataType>::~InstancedTriangleSet()
+	{
+		mTransforms.clear();
+	}
+
+	template<typename TDataType>
+	void InstancedTriangleSet<TDataType>::setPrototype(std::shared_ptr<TriangleSet<TDataType>> prototype)
+	{
+		mPrototype = prototype;
+
+		mFlattenedIsDirty = true;
+	}
+
+	template<typename TDataType>
+	void InstancedTriangleSet<TDataType>::setTransforms(DArray<InstanceTransform>& transforms)
+	{
+		mTransforms.assign(transforms);
+
+		mFlattenedIsDirty = true;
+	}
+
+	template<typename TDataType>
+	void InstancedTriangleSet<TDataType>::setTransforms(std::vector<InstanceTransform>& transforms)
+	{
+		mTransforms.assign(transforms);
+
+		mFlattenedIsDirty = true;
+	}
+
+	template<typename Coord, typename Transform>
+	__global__ void ITS_SetupVertices(
+		DArray<Coord> vertices,
+		DArray<Coord> prototype,
+		DArray<Transform> transforms)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= vertices.size()) return;
+
+		uint vNum = prototype.size();
+
+		vertices[tId] = transforms[tId / vNum] * prototype[tId % vNum];
+	}
+
+	template<typename Triangle>
+	__global__ void ITS_SetupTriangles(
+		DArray<Triangle> triangles,
+		DArray<Triangle> prototype,
+		uint vNum)
+	{
+		int tId = threadIdx.x + (blockIdx.x * blockDim.x);
+		if (tId >= triangles.size()) return;
+
+		uint tNum = prototype.size();
+
+		int shift = (tId / tNum) * vNum;
+		Triangle t = prototype[tId % tNum];
+
+		triangles[tId] = Triangle(t[0] + shift, t[1] + shift, t[2] + shift);
+	}
+
+	template<typename TDataType>
+	std::shared_ptr<TriangleSet<TDataType>> InstancedTriangleSet<TDataType>::flatten()
+	{
+		if (mFlattened == nullptr)
+			mFlattened = std::make_shared<TriangleSet<TDataType>>();
+
+		if (!mFlattenedIsDirty)
+			return mFlattened;
+
+		uint instNum = mTransforms.size();
+
+		if (mPrototype == nullptr || instNum == 0)
+		{
+			DArray<Coord> vertices;
+			DArray<Triangle> triangles;
+			mFlattened->setPoints(vertices);
+			mFlattened->setTriangles(triangles);
+		}
+		else
+		{
+			auto& protoVertices = mPrototype->getPoints();
+			auto& protoTriangles = mPrototype->getTriangles();
+
+			uint vNum = protoVertices.size();
+			uint tNum = protoTriangles.size();
+
+			DArray<Coord> vertices(instNum * vNum);
+			DArray<Triangle> triangles(instNum * tNum);
+
+			cuExecute(vertices.size(),
+				ITS_SetupVertices,
+				vertices,
+				protoVertices,
+				mTransforms);
+
+			cuExecute(triangles.size(),
+				ITS_SetupTriangles,
+				triangles,
+				protoTriangles,
+				vNum);
+
+			mFlattened->setPoints(vertices);
+			mFlattened->setTriangles(triangles);
+
+			vertices.clear();
+			triangles.clear();
+		}
+
+		mFlattened->update();
+
+		mFlattenedIsDirty = false;
+
+		return mFlattened;
+	}
+
+	template<typename TDataType>
+	void InstancedTriangleSet<TDataType>::copyFrom(InstancedTriangleSet<TDataType>& instances)
+	{
+		mPrototype = instances.mPrototype;
+		mTransforms.assign(instances.mTransforms);
+
+		mFlattenedIsDirty = true;
+	}
+
+	template<typename TDataType>
+	bool InstancedTriangleSet<TDataType>::isEmpty()
+	{
+		return mPrototype == nullptr || mTransforms.size() == 0;
+	}
+
+	template<typename TDataType>
+	void InstancedTriangleSet<TDataType>::updateTopology()
+	{
+		//The prototype may be modified in place by its owner
+		mFlattenedIsDirty = true;
+	}
+
+	DEFINE_CLASS(InstancedTriangleSet);
+}
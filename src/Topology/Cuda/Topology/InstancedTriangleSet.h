@@ -0,0 +1,58 @@
+#pragma once
+#include "TriangleSet.h"
+#include "Matrix.h"
+
+namespace dyno
+{
+	/*!
+	*	\class	InstancedTriangleSet
+	*	\brief	One prototype triangle mesh shared by a set of instances, each instance only stores a transform.
+	*
+	*	The expanded mesh is only built when flatten() is called, e.g., by a collision mapping that requires the
+	*	explicit geometry, and is cached until the prototype or the transforms are changed.
+	*/
+	template<typename TDataType>
+	class InstancedTriangleSet : public TopologyModule
+	{
+		DECLARE_TCLASS(InstancedTriangleSet, TDataType)
+	public:
+		typedef typename TDataType::Real Real;
+		typedef typename TDataType::Coord Coord;
+		typedef typename TopologyModule::Triangle Triangle;
+		typedef Transform<Real, 3> InstanceTransform;
+
+		InstancedTriangleSet();
+		~InstancedTriangleSet() override;
+
+		void setPrototype(std::shared_ptr<TriangleSet<TDataType>> prototype);
+		std::shared_ptr<TriangleSet<TDataType>> getPrototype() { return mPrototype; }
+
+		void setTransforms(DArray<InstanceTransform>& transforms);
+		void setTransforms(std::vector<InstanceTransform>& transforms);
+		DArray<InstanceTransform>& getTransforms() { return mTransforms; }
+
+		uint instanceNumber() { return mTransforms.size(); }
+
+		/**
+		 * @brief Expand all instances into a single triangle set
+		 *
+		 * @return the cached triangle set, rebuilt only if the instances have changed since the last call
+		 */
+		std::shared_ptr<TriangleSet<TDataType>> flatten();
+
+		void copyFrom(InstancedTriangleSet<TDataType>& instances);
+
+		bool isEmpty();
+
+	protected:
+		void updateTopology() override;
+
+	private:
+		std::shared_ptr<TriangleSet<TDataType>> mPrototype;
+
+		DArray<InstanceTransform> mTransforms;
+
+		std::shared_ptr<TriangleSet<TDataType>> mFlattened;
+		bool mFlattenedIsDirty = true;
+	};
+}
@@ -19,6 +19,7 @@
 
 #include "Array/Array.h"
 #include "STL/List.h"
+#include "STL/Stack.h"
 
 #include "Primitive/Primitive3D.h"
 
@@ -65,6 +66,13 @@ namespace dyno
 		GPU_FUNC uint requestIntersectionNumber(const AABB& queryAABB, const int queryId = EMPTY) const;
 		GPU_FUNC void requestIntersectionIds(List<int>& ids, const AABB& queryAABB, const int queryId = EMPTY) const;
 
+		/**
+		 * @brief Call func(objId) for each object whose bounding box overlaps queryAABB, 
+		 *		useful when the results can be reduced on the fly without storing the ids.
+		 */
+		template<typename Func>
+		GPU_FUNC void traverse(const AABB& queryAABB, Func func) const;
+
 		GPU_FUNC NodePtr getRoot() const { return &mAllNodes[0]; }
 
 		GPU_FUNC AABB getAABB(const uint idx) const { return mSortedAABBs[idx]; }
@@ -90,4 +98,45 @@ namespace dyno
 
 		DArray<uint64> mMortonCodes;
 	};
+
+	template<typename TDataType>
+	template<typename Func>
+	GPU_FUNC void LinearBVH<TDataType>::traverse(const AABB& queryAABB, Func func) const
+	{
+		int buffer[64];
+
+		Stack<int> stack;
+		stack.reserve(buffer, 64);
+
+		uint N = mSortedObjectIds.size();
+
+		int idx = 0;
+		do
+		{
+			int idxL = mAllNodes[idx].left;
+			int idxR = mAllNodes[idx].right;
+			bool overlapL = queryAABB.checkOverlap(getAABB(idxL));
+			bool overlapR = queryAABB.checkOverlap(getAABB(idxR));
+
+			if (overlapL && mAllNodes[idxL].isLeaf())
+				func(mSortedObjectIds[idxL - N + 1]);
+
+			if (overlapR && mAllNodes[idxR].isLeaf())
+				func(mSortedObjectIds[idxR - N + 1]);
+
+			bool traverseL = (overlapL && !mAllNodes[idxL].isLeaf());
+			bool traverseR = (overlapR && !mAllNodes[idxR].isLeaf());
+
+			if (!traverseL && !traverseR) {
+				idx = !stack.empty() ? stack.top() : EMPTY;
+				stack.pop();
+			}
+			else
+			{
+				idx = (traverseL) ? idxL : idxR;
+				if (traverseL && traverseR)
+					stack.push(idxR);
+			}
+		} while (idx != EMPTY);
+	}
 }
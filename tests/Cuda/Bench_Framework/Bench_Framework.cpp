@@ -0,0 +1,240 @@
+#include <benchmark/benchmark.h>
+
+#include "SceneGraph.h"
+#include "Action.h"
+#include "Module/AnimationPipeline.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dyno;
+
+/**
+ * Costs of the framework itself, measured on synthetic scenes of N nodes x M modules x K fields whose modules do
+ * trivial work on the host. Compare releases with --benchmark_out=<file> --benchmark_out_format=json.
+ */
+
+class BenchModule : public Module
+{
+	DECLARE_CLASS(BenchModule)
+public:
+	BenchModule(int fields = 1)
+	{
+		for (int i = 0; i < fields; i++)
+			mInputs.emplace_back(new FVar<float>("Input" + std::to_string(i), "", FieldTypeEnum::In, this));
+	}
+
+	std::vector<std::unique_ptr<FVar<float>>>& inputs() { return mInputs; }
+
+	DEF_VAR_OUT(float, Value, "");
+
+protected:
+	void updateImpl() override
+	{
+		float sum = 0.0f;
+		for (auto& f : mInputs)
+			sum += f->getValue();
+
+		this->outValue()->setValue(sum);
+	}
+
+private:
+	std::vector<std::unique_ptr<FVar<float>>> mInputs;
+};
+
+IMPLEMENT_CLASS(BenchModule)
+
+class LastModule : public Module
+{
+	DECLARE_CLASS(LastModule)
+};
+
+IMPLEMENT_CLASS(LastModule)
+
+class BenchNode : public Node
+{
+public:
+	BenchNode(int modules, int fields)
+	{
+		this->inUpstream()->tagOptional(true);
+
+		//Each module reads all its inputs from the output of the previous one
+		FVar<float>* prev = this->stateValue();
+		for (int j = 0; j < modules; j++)
+		{
+			auto m = std::make_shared<BenchModule>(fields);
+			for (auto& f : m->inputs())
+				prev->connect(f.get());
+
+			this->animationPipeline()->pushModule(m);
+			prev = m->outValue();
+		}
+	}
+
+	DEF_VAR_IN(float, Upstream, "");
+
+	DEF_VAR_STATE(float, Value, 0.0f, "");
+
+protected:
+	void preUpdateStates() override
+	{
+		this->stateValue()->setValue(this->stateValue()->getValue() + 1.0f);
+	}
+};
+
+//A chain of nodes, each reading the state of the previous one
+static std::shared_ptr<SceneGraph> createScene(int nodes, int modules, int fields)
+{
+	auto scn = std::make_shared<SceneGraph>();
+	scn->printFrameInfo(false);
+
+	std::shared_ptr<BenchNode> prev = nullptr;
+	for (int i = 0; i < nodes; i++)
+	{
+		auto node = scn->addNode(std::make_shared<BenchNode>(modules, fields));
+		if (prev != nullptr)
+			prev->stateValue()->connect(node->inUpstream());
+
+		prev = node;
+	}
+
+	scn->initialize();
+
+	return scn;
+}
+
+static void BM_GetTopField(benchmark::State& state)
+{
+	const int length = (int)state.range(0);
+
+	std::vector<std::unique_ptr<FVar<float>>> chain;
+	for (int i = 0; i < length; i++)
+	{
+		chain.emplace_back(new FVar<float>());
+		if (i > 0)
+			chain[i - 1]->connect(chain[i].get());
+	}
+	chain[0]->setValue(1.0f);
+
+	FBase* last = chain.back().get();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(last->getTopField());
+}
+BENCHMARK(BM_GetTopField)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_TickTack(benchmark::State& state)
+{
+	const int sinkNum = (int)state.range(0);
+
+	FVar<float> source;
+	source.setValue(1.0f);
+
+	std::vector<std::unique_ptr<FVar<float>>> sinks;
+	for (int i = 0; i < sinkNum; i++)
+	{
+		sinks.emplace_back(new FVar<float>());
+		source.connect(sinks[i].get());
+	}
+
+	for (auto _ : state)
+	{
+		source.tick();
+		for (auto& s : sinks)
+		{
+			benchmark::DoNotOptimize(s->isModified());
+			s->tack();
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * sinkNum);
+}
+BENCHMARK(BM_TickTack)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_PipelineUpdate(benchmark::State& state)
+{
+	const int modules = (int)state.range(0);
+	const int fields = (int)state.range(1);
+
+	auto node = std::make_shared<BenchNode>(modules, fields);
+	auto pipeline = node->animationPipeline();
+
+	for (auto _ : state)
+	{
+		node->stateValue()->setValue(1.0f);
+		pipeline->update();
+	}
+
+	state.SetItemsProcessed(state.iterations() * modules);
+}
+BENCHMARK(BM_PipelineUpdate)->ArgsProduct({ { 1, 8, 64 }, { 1, 4, 16 } })->ArgNames({ "M", "K" });
+
+class EmptyAct : public Action
+{
+public:
+	void process(Node* node) override {
+		benchmark::DoNotOptimize(node);
+	}
+};
+
+static void BM_TraverseForward(benchmark::State& state)
+{
+	const int nodes = (int)state.range(0);
+
+	auto scn = createScene(nodes, 1, 1);
+
+	for (auto _ : state)
+		scn->traverseForward<EmptyAct>();
+
+	state.SetItemsProcessed(state.iterations() * nodes);
+}
+BENCHMARK(BM_TraverseForward)->RangeMultiplier(8)->Range(1, 4096);
+
+static void BM_NodeIterator(benchmark::State& state)
+{
+	const int nodes = (int)state.range(0);
+
+	auto scn = createScene(nodes, 1, 1);
+
+	for (auto _ : state)
+	{
+		for (auto it = scn->begin(); it != scn->end(); it++)
+			benchmark::DoNotOptimize(it.get());
+	}
+
+	state.SetItemsProcessed(state.iterations() * nodes);
+}
+BENCHMARK(BM_NodeIterator)->RangeMultiplier(8)->Range(1, 4096);
+
+static void BM_GetModule(benchmark::State& state)
+{
+	const int modules = (int)state.range(0);
+
+	//The module looked up is the last one of the list
+	auto node = std::make_shared<BenchNode>(0, 0);
+	for (int j = 0; j < modules; j++)
+		node->addModule(std::make_shared<BenchModule>());
+	node->addModule(std::make_shared<LastModule>());
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(node->getModule<LastModule>());
+}
+BENCHMARK(BM_GetModule)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_TakeOneFrame(benchmark::State& state)
+{
+	const int nodes = (int)state.range(0);
+	const int modules = (int)state.range(1);
+	const int fields = (int)state.range(2);
+
+	auto scn = createScene(nodes, modules, fields);
+
+	for (auto _ : state)
+		scn->takeOneFrame();
+
+	state.SetItemsProcessed(state.iterations() * nodes * modules);
+}
+BENCHMARK(BM_TakeOneFrame)
+	->ArgsProduct({ { 1, 16, 256 }, { 1, 8 }, { 1, 4 } })
+	->ArgNames({ "N", "M", "K" })
+	->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,177 @@
+#include <benchmark/benchmark.h>
+
+#include "Smesh_IO/smesh.h"
+#include "Gmsh_IO/gmsh.h"
+#include "Surface_Mesh_IO/ObjFileLoader.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+
+using namespace dyno;
+
+enum SyntheticFormat
+{
+	SF_Smesh = 0,
+	SF_Gmsh,
+	SF_Obj
+};
+
+/**
+ * Writes a random tetrahedral mesh with tetNum elements and tetNum / 5 vertices in one of the supported formats,
+ * an obj file stores the first three vertices of every element as a triangle.
+ */
+static std::string writeSyntheticMesh(SyntheticFormat format, int tetNum)
+{
+	const int vertNum = tetNum / 5;
+
+	const char* ext[] = { ".smesh", ".msh", ".obj" };
+	std::string fileName = (std::filesystem::temp_directory_path() / ("peridyno_bench_" + std::to_string(tetNum) + ext[format])).string();
+
+	FILE* fp = fopen(fileName.c_str(), "w");
+	if (fp == nullptr)
+		return std::string();
+
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+	std::uniform_int_distribution<int> vertex(1, vertNum);
+
+	if (format == SF_Smesh)
+		fprintf(fp, "*VERTICES\n%d 3 0 0\n", vertNum);
+	else if (format == SF_Gmsh)
+		fprintf(fp, "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n$Nodes\n%d\n", vertNum);
+
+	for (int i = 1; i <= vertNum; i++)
+	{
+		float x = coord(rng), y = coord(rng), z = coord(rng);
+		if (format == SF_Obj)
+			fprintf(fp, "v %.9g %.9g %.9g\n", x, y, z);
+		else
+			fprintf(fp, "%d %.9g %.9g %.9g\n", i, x, y, z);
+	}
+
+	if (format == SF_Smesh)
+		fprintf(fp, "*ELEMENTS\nTET\n%d 4 0\n", tetNum);
+	else if (format == SF_Gmsh)
+		fprintf(fp, "$EndNodes\n$Elements\n%d\n1 15 2 0 1 1\n", tetNum + 1);
+
+	for (int i = 1; i <= tetNum; i++)
+	{
+		int a = vertex(rng), b = vertex(rng), c = vertex(rng), d = vertex(rng);
+		if (format == SF_Smesh)
+			fprintf(fp, "%d %d %d %d %d\n", i, a, b, c, d);
+		else if (format == SF_Gmsh)
+			fprintf(fp, "%d 4 2 0 1 %d %d %d %d\n", i + 1, a, b, c, d);
+		else
+			fprintf(fp, "f %d %d %d\n", a, b, c);
+	}
+
+	if (format == SF_Gmsh)
+		fprintf(fp, "$EndElements\n");
+
+	fclose(fp);
+
+	return fileName;
+}
+
+static void setFileCounters(benchmark::State& state, const std::string& fileName, size_t records)
+{
+	double bytes = double(std::filesystem::file_size(fileName));
+	state.counters["MB"] = benchmark::Counter(bytes / (1024.0 * 1024.0), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["records"] = double(records);
+}
+
+/**
+ * Loading of a synthetic mesh with n elements, the counter "MB" is the parsed megabytes per second.
+ */
+static void BM_SmeshLoad(benchmark::State& state)
+{
+	std::string fileName = writeSyntheticMesh(SF_Smesh, int(state.range(0)));
+	if (fileName.empty())
+	{
+		state.SkipWithError("Failed to write the synthetic mesh");
+		return;
+	}
+
+	size_t records = 0;
+	for (auto _ : state)
+	{
+		Smesh mesh;
+		mesh.loadFile(fileName);
+		records = mesh.m_points.size() + mesh.m_tets.size();
+		benchmark::DoNotOptimize(records);
+	}
+
+	setFileCounters(state, fileName, records);
+	std::filesystem::remove(fileName);
+}
+BENCHMARK(BM_SmeshLoad)->ArgName("n")->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_GmshLoad(benchmark::State& state)
+{
+	std::string fileName = writeSyntheticMesh(SF_Gmsh, int(state.range(0)));
+	if (fileName.empty())
+	{
+		state.SkipWithError("Failed to write the synthetic mesh");
+		return;
+	}
+
+	size_t records = 0;
+	for (auto _ : state)
+	{
+		Gmsh mesh;
+		mesh.loadFile(fileName);
+		records = mesh.m_points.size() + mesh.m_tets.size();
+		benchmark::DoNotOptimize(records);
+	}
+
+	setFileCounters(state, fileName, records);
+	std::filesystem::remove(fileName);
+}
+BENCHMARK(BM_GmshLoad)->ArgName("n")->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_ObjLoad(benchmark::State& state)
+{
+	std::string fileName = writeSyntheticMesh(SF_Obj, int(state.range(0)));
+	if (fileName.empty())
+	{
+		state.SkipWithError("Failed to write the synthetic mesh");
+		return;
+	}
+
+	size_t records = 0;
+	for (auto _ : state)
+	{
+		ObjFileLoader loader(fileName);
+		records = loader.getVertexList().size() + loader.getFaceList().size();
+		benchmark::DoNotOptimize(records);
+	}
+
+	setFileCounters(state, fileName, records);
+	std::filesystem::remove(fileName);
+}
+BENCHMARK(BM_ObjLoad)->ArgName("n")->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Loading of the tetrahedral bunny shipped with the assets, node, ele, edge and face files together.
+ */
+static void BM_TetgenAssetLoad(benchmark::State& state)
+{
+	std::string prefix = getAssetPath() + "smesh/bunny_mesh.1";
+
+	size_t records = 0;
+	for (auto _ : state)
+	{
+		Smesh mesh;
+		mesh.loadNodeFile(prefix + ".node");
+		mesh.loadTetFile(prefix + ".ele");
+		mesh.loadEdgeFile(prefix + ".edge");
+		mesh.loadTriangleFile(prefix + ".face");
+		records = mesh.m_points.size() + mesh.m_tets.size() + mesh.m_edges.size() + mesh.m_triangles.size();
+		benchmark::DoNotOptimize(records);
+	}
+
+	state.counters["records"] = double(records);
+}
+BENCHMARK(BM_TetgenAssetLoad)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include "Collision/NeighborPointQuery.h"
+#include "ParticleSystem/Module/SummationDensity.h"
+
+using namespace dyno;
+
+/**
+ * Summation density on a block of n x n x n particles with analytic kernel policies against tabulated kernels.
+ * The counter "pairs" is the number of neighbor pairs evaluated per second.
+ */
+static void BM_SummationDensity(benchmark::State& state)
+{
+	int n = int(state.range(0));
+	int kernelType = int(state.range(1));
+	bool tabulated = state.range(2) != 0;
+
+	float d = 0.005f;
+	float h = 0.0125f;
+
+	CArray<Vec3f> hPos;
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			for (int k = 0; k < n; k++)
+			{
+				hPos.pushBack(Vec3f(i * d, j * d, k * d));
+			}
+		}
+	}
+
+	NeighborPointQuery<DataType3f> nbrQuery;
+	nbrQuery.inRadius()->setValue(h);
+	nbrQuery.inPosition()->assign(hPos);
+	nbrQuery.update();
+
+	SummationDensity<DataType3f> density;
+	density.varKernelType()->setCurrentKey(kernelType);
+	density.varTabulatedKernel()->setValue(tabulated);
+	density.inSmoothingLength()->setValue(h);
+	density.inSamplingDistance()->setValue(d);
+	density.inPosition()->assign(hPos);
+	nbrQuery.outNeighborIds()->connect(density.inNeighborIds());
+
+	//Builds the tables and computes the particle mass outside of the timed loop
+	density.update();
+
+	for (auto _ : state)
+	{
+		density.update();
+	}
+
+	double pairs = double(nbrQuery.outNeighborIds()->getData().elementSize());
+	state.counters["pairs"] = benchmark::Counter(pairs, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_SummationDensity)
+	->ArgNames({ "n", "kernel", "tabulated" })
+	->ArgsProduct({ { 32, 64 }, { 0, 1 }, { 0, 1 } })
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include "Collision/NeighborPointQuery.h"
+#include "ParticleSystem/Attribute.h"
+#include "ParticleSystem/Module/VariationalApproximateProjection.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace dyno;
+
+/**
+ * Pressure solve of VariationalApproximateProjection on a block of n x n x n fluid particles whose initial velocity
+ * field is divergent, comparing the plain CG with the Jacobi preconditioned, pipelined CG. Each projection starts
+ * from zero pressure, the time includes the allocation of the solver arrays on the first call. The counter
+ * "iterations" reports the CG iterations of a solve.
+ */
+static void BM_Projection(benchmark::State& state)
+{
+	int n = int(state.range(0));
+	bool preconditioned = state.range(1) != 0;
+
+	float d = 0.005f;
+
+	CArray<Vec3f> hPos;
+	CArray<Vec3f> hVel;
+	CArray<Attribute> hAtt;
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			for (int k = 0; k < n; k++)
+			{
+				Vec3f p(i * d, j * d, k * d);
+
+				Attribute att;
+				att.setFluid();
+				att.setDynamic();
+
+				hPos.pushBack(p);
+				hVel.pushBack(Vec3f(std::sin(20.0f * p[1]), -0.5f * p[1], std::cos(20.0f * p[0])));
+				hAtt.pushBack(att);
+			}
+		}
+	}
+
+	NeighborPointQuery<DataType3f> nbrQuery;
+	nbrQuery.inRadius()->setValue(0.006f);
+	nbrQuery.inPosition()->assign(hPos);
+	nbrQuery.update();
+
+	uint iterations = 0;
+	for (auto _ : state)
+	{
+		//The pressure is warm started across calls, a new module solves from zero pressure every time
+		state.PauseTiming();
+		auto projection = std::make_shared<VariationalApproximateProjection<DataType3f>>();
+		projection->varPreconditioned()->setValue(preconditioned);
+		projection->inTimeStep()->setValue(0.001f);
+		projection->inSamplingDistance()->setValue(d);
+		projection->inSmoothingLength()->setValue(0.006f);
+		projection->inPosition()->assign(hPos);
+		projection->inVelocity()->assign(hVel);
+		projection->inAttribute()->assign(hAtt);
+		projection->inNormal()->allocate();
+		projection->inNormal()->getData().resize(hPos.size());
+		projection->inNormal()->getData().reset();
+		nbrQuery.outNeighborIds()->connect(projection->inNeighborIds());
+		cudaDeviceSynchronize();
+		state.ResumeTiming();
+
+		projection->update();
+		cudaDeviceSynchronize();
+
+		iterations = projection->getIterationNumber();
+
+		state.PauseTiming();
+		nbrQuery.outNeighborIds()->disconnect(projection->inNeighborIds());
+		projection = nullptr;
+		state.ResumeTiming();
+	}
+
+	state.counters["particles"] = double(hPos.size());
+	state.counters["iterations"] = double(iterations);
+}
+BENCHMARK(BM_Projection)
+	->ArgNames({ "n", "preconditioned" })
+	->ArgsProduct({ { 16, 32, 64 }, { 0, 1 } })
+	->Unit(benchmark::kMillisecond);
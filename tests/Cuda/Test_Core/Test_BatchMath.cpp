@@ -0,0 +1,215 @@
+#include "gtest/gtest.h"
+#include "Math/BatchMath.h"
+#include "Matrix/MatrixFunc.h"
+
+#include <random>
+
+using namespace dyno;
+
+static void randomVectors(CArray<Vec3f>& arr, uint n, unsigned int seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+
+	arr.resize(n);
+	for (uint i = 0; i < n; i++)
+		arr[i] = Vec3f(dist(gen), dist(gen), dist(gen));
+}
+
+static void expectNear(const Vec3f& a, const Vec3f& b, float tol)
+{
+	EXPECT_NEAR(a.x, b.x, tol);
+	EXPECT_NEAR(a.y, b.y, tol);
+	EXPECT_NEAR(a.z, b.z, tol);
+}
+
+// sizes that are not multiples of any batch width to cover the remainders
+static const uint sizes[] = { 0, 1, 3, 17, 50, 1001 };
+
+TEST(BatchMath, axpy)
+{
+	for (uint n : sizes)
+	{
+		CArray<Vec3f> x, y;
+		randomVectors(x, n, 1);
+		randomVectors(y, n, 2);
+
+		CArray<Vec3f> ref;
+		ref.assign(y);
+		for (uint i = 0; i < n; i++)
+			ref[i] += x[i] * 0.5f;
+
+		batchAxpy(y, x, 0.5f);
+
+		for (uint i = 0; i < n; i++)
+			expectNear(y[i], ref[i], 1e-5f);
+	}
+}
+
+TEST(BatchMath, dot_cross)
+{
+	for (uint n : sizes)
+	{
+		CArray<Vec3f> a, b;
+		randomVectors(a, n, 3);
+		randomVectors(b, n, 4);
+
+		CArray<float> d;
+		CArray<Vec3f> c;
+		batchDot(d, a, b);
+		batchCross(c, a, b);
+
+		for (uint i = 0; i < n; i++)
+		{
+			EXPECT_NEAR(d[i], a[i].dot(b[i]), 1e-3f);
+			expectNear(c[i], a[i].cross(b[i]), 1e-3f);
+		}
+	}
+}
+
+TEST(BatchMath, normalize)
+{
+	for (uint n : sizes)
+	{
+		CArray<Vec3f> v;
+		randomVectors(v, n, 5);
+		if (n > 0)
+			v[n - 1] = Vec3f(0.0f);
+
+		CArray<Vec3f> ref;
+		ref.assign(v);
+		for (uint i = 0; i < n; i++)
+			ref[i].normalize();
+
+		batchNormalize(v);
+
+		for (uint i = 0; i < n; i++)
+			expectNear(v[i], ref[i], 1e-6f);
+	}
+}
+
+TEST(BatchMath, matrix)
+{
+	std::mt19937 gen(6);
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+	for (uint n : sizes)
+	{
+		CArray<Vec3f> v;
+		randomVectors(v, n, 7);
+
+		CArray<Mat3f> m(n);
+		for (uint i = 0; i < n; i++)
+		{
+			for (int r = 0; r < 3; r++)
+				for (int c = 0; c < 3; c++)
+					m[i](r, c) = dist(gen);
+		}
+
+		Mat3f rot = n > 0 ? m[0] : Mat3f::identityMatrix();
+		Vec3f t(1.0f, -2.0f, 3.0f);
+
+		CArray<Vec3f> mv, tv;
+		batchMultiply(mv, m, v);
+		batchTransform(tv, rot, t, v);
+
+		for (uint i = 0; i < n; i++)
+		{
+			expectNear(mv[i], m[i] * v[i], 1e-4f);
+			expectNear(tv[i], rot * v[i] + t, 1e-4f);
+		}
+	}
+}
+
+static Mat3f randomMatrix(std::mt19937& gen, float lo, float hi)
+{
+	std::uniform_real_distribution<float> dist(lo, hi);
+
+	Mat3f m;
+	for (int r = 0; r < 3; r++)
+		for (int c = 0; c < 3; c++)
+			m(r, c) = dist(gen);
+
+	return m;
+}
+
+static float maxDifference(const Mat3f& a, const Mat3f& b)
+{
+	float diff = 0.0f;
+	for (int r = 0; r < 3; r++)
+		for (int c = 0; c < 3; c++)
+			diff = std::max(diff, std::fabs(a(r, c) - b(r, c)));
+
+	return diff;
+}
+
+TEST(BatchMath, svd)
+{
+	std::mt19937 gen(8);
+
+	const uint n = 1001;
+	CArray<Mat3f> A(n);
+	for (uint i = 0; i < n; i++)
+		A[i] = randomMatrix(gen, -1.0f, 1.0f);
+
+	// degenerate cases
+	A[0] = Mat3f(0.0f);
+	A[1] = Mat3f::identityMatrix();
+	A[2](0, 0) = 1.0f; A[2](0, 1) = 2.0f; A[2](0, 2) = 3.0f;
+	A[2](1, 0) = 2.0f; A[2](1, 1) = 4.0f; A[2](1, 2) = 6.0f;
+	A[2](2, 0) = 3.0f; A[2](2, 1) = 6.0f; A[2](2, 2) = 9.0f;
+
+	CArray<Mat3f> U, V;
+	CArray<Vec3f> S;
+	batchSVD(U, S, V, A);
+
+	Mat3f I = Mat3f::identityMatrix();
+	for (uint i = 0; i < n; i++)
+	{
+		Mat3f D(0.0f);
+		D(0, 0) = S[i][0];
+		D(1, 1) = S[i][1];
+		D(2, 2) = S[i][2];
+
+		EXPECT_LT(maxDifference(U[i] * D * V[i].transpose(), A[i]), 1e-4f);
+
+		EXPECT_LT(maxDifference(U[i] * U[i].transpose(), I), 1e-4f);
+		EXPECT_LT(maxDifference(V[i] * V[i].transpose(), I), 1e-4f);
+		EXPECT_NEAR(U[i].determinant(), 1.0f, 1e-4f);
+		EXPECT_NEAR(V[i].determinant(), 1.0f, 1e-4f);
+
+		EXPECT_GE(std::fabs(S[i][0]) + 1e-5f, std::fabs(S[i][1]));
+		EXPECT_GE(std::fabs(S[i][1]) + 1e-5f, std::fabs(S[i][2]));
+	}
+}
+
+TEST(BatchMath, polarDecomposition)
+{
+	std::mt19937 gen(9);
+
+	// the iterative routine is the reference, it only converges to a rotation for matrices with a positive determinant
+	const uint n = 1001;
+	CArray<Mat3f> A(n);
+	for (uint i = 0; i < n; i++)
+	{
+		Mat3f m;
+		do {
+			m = randomMatrix(gen, -1.0f, 1.0f);
+		} while (std::fabs(m.determinant()) < 0.05f);
+
+		A[i] = m.determinant() > 0.0f ? m : -m;
+	}
+
+	CArray<Mat3f> R(n), S(n);
+	batchPolarDecomposition(R.begin(), S.begin(), A.begin(), n);
+
+	for (uint i = 0; i < n; i++)
+	{
+		Mat3f ref;
+		polarDecomposition(A[i], ref, 1e-6f);
+
+		EXPECT_LT(maxDifference(R[i], ref), 1e-3f);
+		EXPECT_LT(maxDifference(R[i] * S[i], A[i]), 1e-4f);
+		EXPECT_LT(maxDifference(S[i], S[i].transpose()), 1e-4f);
+	}
+}
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+
+#include "AssetCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace dyno;
+
+TEST(AssetCache, concurrent_load)
+{
+	auto cache = AssetCache::instance();
+	bool enabled = cache->isEnabled();
+	cache->setEnabled(true);
+
+	std::atomic<int> loads(0);
+	auto loader = [&]() {
+		loads++;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		return std::make_shared<std::vector<int>>(3, 1);
+	};
+
+	const int threadNum = 8;
+	std::vector<std::shared_ptr<const std::vector<int>>> assets(threadNum);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadNum; t++)
+		threads.emplace_back([&, t]() { assets[t] = cache->load<std::vector<int>>("Test_AssetCache", loader); });
+
+	for (auto& t : threads)
+		t.join();
+
+	// loaded once and shared by all requests
+	EXPECT_EQ(loads.load(), 1);
+	for (auto& a : assets)
+		EXPECT_EQ(a, assets[0]);
+
+	// the type of a request has to match the cached asset
+	EXPECT_EQ(cache->load<int>("Test_AssetCache", []() { return std::make_shared<int>(0); }), nullptr);
+
+	// failures are not cached
+	EXPECT_EQ(cache->load<int>("Test_AssetCache_Failure", []() { return std::shared_ptr<int>(); }), nullptr);
+	auto value = cache->load<int>("Test_AssetCache_Failure", []() { return std::make_shared<int>(1); });
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, 1);
+
+	cache->clear();
+	cache->setEnabled(enabled);
+}
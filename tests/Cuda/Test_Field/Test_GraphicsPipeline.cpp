@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+
+#include "Node.h"
+#include "Module/VisualModule.h"
+#include "Module/GraphicsPipeline.h"
+
+using namespace dyno;
+
+class SourceNode : public Node {
+public:
+	SourceNode() {};
+	~SourceNode() override {};
+
+	DEF_VAR_OUT(float, Value, "");
+};
+
+class DoublingMapping : public Module {
+public:
+	DoublingMapping() {};
+	~DoublingMapping() override {};
+
+	DEF_VAR_IN(float, Value, "");
+
+	DEF_VAR_OUT(float, Value, "");
+
+	int updates = 0;
+
+protected:
+	void updateImpl() override {
+		updates++;
+		this->outValue()->setValue(2.0f * this->inValue()->getValue());
+	}
+};
+
+class CountingVisual : public VisualModule {
+public:
+	CountingVisual() {};
+	~CountingVisual() override {};
+
+	DEF_VAR_IN(float, Value, "");
+
+	int updates = 0;
+	float value = 0.0f;
+
+protected:
+	void updateImpl() override {
+		updates++;
+		value = this->inValue()->getValue();
+	}
+};
+
+TEST(GraphicsPipeline, lazy_update)
+{
+	auto node = std::make_shared<SourceNode>();
+	node->outValue()->setValue(1.0f);
+
+	auto mapping = std::make_shared<DoublingMapping>();
+	node->outValue()->connect(mapping->inValue());
+	node->graphicsPipeline()->pushModule(mapping);
+
+	auto visual = std::make_shared<CountingVisual>();
+	mapping->outValue()->connect(visual->inValue());
+	node->graphicsPipeline()->pushModule(visual);
+
+	auto pipeline = node->graphicsPipeline();
+
+	pipeline->update();
+	EXPECT_EQ(mapping->updates, 1);
+	EXPECT_EQ(visual->updates, 1);
+	EXPECT_EQ(visual->value, 2.0f);
+
+	// nothing changed upstream
+	pipeline->update();
+	EXPECT_EQ(visual->updates, 1);
+
+	node->outValue()->setValue(2.0f);
+	pipeline->update();
+	EXPECT_EQ(mapping->updates, 2);
+	EXPECT_EQ(visual->updates, 2);
+	EXPECT_EQ(visual->value, 4.0f);
+
+	// the mapping only feeds a hidden visual module
+	visual->setVisible(false);
+	node->outValue()->setValue(3.0f);
+	pipeline->update();
+	EXPECT_EQ(mapping->updates, 2);
+	EXPECT_EQ(visual->updates, 2);
+
+	// changes made while hidden are picked up once visible again
+	visual->setVisible(true);
+	pipeline->update();
+	EXPECT_EQ(mapping->updates, 3);
+	EXPECT_EQ(visual->updates, 3);
+	EXPECT_EQ(visual->value, 6.0f);
+
+	// throttled to one update every three
+	visual->varUpdateInterval()->setValue(3);
+	for (int i = 0; i < 6; i++)
+	{
+		node->outValue()->setValue(4.0f + i);
+		pipeline->update();
+	}
+	EXPECT_EQ(mapping->updates, 5);
+	EXPECT_EQ(visual->updates, 5);
+	EXPECT_EQ(visual->value, 18.0f);
+
+	// hidden nodes skip their graphics pipelines
+	node->setVisible(false);
+	node->outValue()->setValue(20.0f);
+	for (int i = 0; i < 3; i++)
+		pipeline->update();
+	EXPECT_EQ(visual->updates, 5);
+}
+
+TEST(GraphicsPipeline, force_update)
+{
+	auto node = std::make_shared<SourceNode>();
+	node->outValue()->setValue(1.0f);
+
+	auto mapping = std::make_shared<DoublingMapping>();
+	node->outValue()->connect(mapping->inValue());
+	node->graphicsPipeline()->pushModule(mapping);
+
+	auto visual = std::make_shared<CountingVisual>();
+	visual->varForceUpdate()->setValue(true);
+	mapping->outValue()->connect(visual->inValue());
+	node->graphicsPipeline()->pushModule(visual);
+
+	auto pipeline = node->graphicsPipeline();
+
+	pipeline->update();
+	EXPECT_EQ(mapping->updates, 1);
+	EXPECT_EQ(visual->updates, 1);
+
+	// inputs are unchanged, only the visual module forcing updates runs
+	for (int i = 0; i < 3; i++)
+		pipeline->update();
+	EXPECT_EQ(mapping->updates, 1);
+	EXPECT_EQ(visual->updates, 4);
+	EXPECT_EQ(visual->value, 2.0f);
+
+	// hidden modules are still skipped
+	visual->setVisible(false);
+	pipeline->update();
+	EXPECT_EQ(visual->updates, 4);
+}
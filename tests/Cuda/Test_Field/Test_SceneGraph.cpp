@@ -0,0 +1,270 @@
+#include "gtest/gtest.h"
+
+#include "SceneGraph.h"
+#include "Module/OutputModule.h"
+#include "Module/GraphicsPipeline.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace dyno;
+
+class CountingNode : public Node {
+public:
+	CountingNode() {};
+	~CountingNode() override {};
+
+	std::atomic<int> updates{ 0 };
+
+protected:
+	void updateStates() override {
+		updates++;
+	}
+};
+
+TEST(SceneGraph, concurrent_scenes)
+{
+	const int frames = 50;
+	const int sceneNum = 4;
+
+	std::vector<std::shared_ptr<SceneGraph>> scenes;
+	std::vector<std::shared_ptr<CountingNode>> nodes;
+	for (int i = 0; i < sceneNum; i++)
+	{
+		auto scn = std::make_shared<SceneGraph>();
+		scn->printFrameInfo(false);
+		nodes.push_back(scn->addNode(std::make_shared<CountingNode>()));
+		scenes.push_back(scn);
+	}
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < sceneNum; i++)
+	{
+		threads.emplace_back([&scenes, i, frames]() {
+			scenes[i]->initialize();
+			for (int f = 0; f < frames; f++)
+				scenes[i]->takeOneFrame();
+		});
+	}
+
+	for (auto& t : threads)
+		t.join();
+
+	for (int i = 0; i < sceneNum; i++)
+	{
+		EXPECT_EQ(scenes[i]->getFrameNumber(), frames);
+		EXPECT_EQ(nodes[i]->updates, frames);
+	}
+}
+
+TEST(SceneGraph, shared_scene)
+{
+	const int frames = 50;
+	const int threadNum = 4;
+
+	auto scn = std::make_shared<SceneGraph>();
+	scn->printFrameInfo(false);
+	auto node = scn->addNode(std::make_shared<CountingNode>());
+
+	// frames requested from several threads are serialized by the scene
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadNum; i++)
+	{
+		threads.emplace_back([&scn, frames]() {
+			scn->initialize();
+			for (int f = 0; f < frames; f++)
+				scn->takeOneFrame();
+		});
+	}
+
+	for (auto& t : threads)
+		t.join();
+
+	EXPECT_EQ(scn->getFrameNumber(), frames * threadNum);
+	EXPECT_EQ(node->updates, frames * threadNum);
+}
+
+class RateNode : public Node {
+public:
+	RateNode(float dt) {
+		this->setDt(dt);
+		this->inValue()->tagOptional(true);
+	};
+	~RateNode() override {};
+
+	DEF_VAR_IN(float, Value, "");
+
+	DEF_VAR_OUT(float, Value, "");
+
+	std::vector<float> steps;
+	std::vector<float> received;
+
+protected:
+	void updateStates() override {
+		steps.push_back(this->stateTimeStep()->getValue());
+
+		if (!this->inValue()->isEmpty())
+			received.push_back(this->inValue()->getValue());
+
+		this->outValue()->setValue(this->stateElapsedTime()->getValue() + this->stateTimeStep()->getValue());
+	}
+};
+
+class CoupledRateNode : public RateNode {
+public:
+	CoupledRateNode(float dt) : RateNode(dt) {};
+	~CoupledRateNode() override {};
+
+	DEF_NODE_PORT(RateNode, Partner, "");
+};
+
+TEST(SceneGraph, multi_rate)
+{
+	auto scn = std::make_shared<SceneGraph>();
+	scn->printFrameInfo(false);
+	scn->setFrameRate(25.0f);
+	scn->setMultiRate(true);
+
+	// a slow node, a fast node and a slow node coupled to the fast one through a node port
+	auto slow = scn->addNode(std::make_shared<RateNode>(1.0f));
+	auto fast = scn->addNode(std::make_shared<RateNode>(0.01f));
+	auto coupled = scn->addNode(std::make_shared<CoupledRateNode>(1.0f));
+	fast->connect(coupled->importPartner());
+
+	// a fast consumer reading the output of the slow node
+	auto consumer = scn->addNode(std::make_shared<RateNode>(0.01f));
+	slow->outValue()->setValue(0.0f);
+	slow->outValue()->connect(consumer->inValue());
+
+	scn->initialize();
+	scn->takeOneFrame();
+
+	EXPECT_EQ(slow->steps.size(), 1u);
+	EXPECT_NEAR(slow->steps[0], 0.04f, 1e-6f);
+
+	EXPECT_EQ(fast->steps.size(), 4u);
+	EXPECT_EQ(coupled->steps.size(), 4u);
+	EXPECT_NEAR(coupled->steps[0], 0.01f, 1e-6f);
+
+	// the input is interpolated between the start and the end of the frame
+	ASSERT_EQ(consumer->received.size(), 4u);
+	for (int k = 0; k < 4; k++)
+		EXPECT_NEAR(consumer->received[k], 0.01f * (k + 1), 1e-6f);
+
+	// and restored afterwards
+	EXPECT_NEAR(slow->outValue()->getValue(), 0.04f, 1e-6f);
+	EXPECT_NEAR(scn->getElapsedTime(), 0.04f, 1e-6f);
+}
+
+class RecordingOutput : public OutputModule {
+public:
+	RecordingOutput() {};
+	~RecordingOutput() override {};
+
+	DEF_VAR_IN(float, Value, "");
+
+	std::vector<float> values;
+
+	void flush() override {
+		values.push_back(this->inValue()->getValue());
+	}
+};
+
+class RecordingVisual : public Module {
+public:
+	RecordingVisual() {};
+	~RecordingVisual() override {};
+
+	DEF_VAR_IN(float, Value, "");
+
+	std::vector<float> values;
+
+protected:
+	void updateImpl() override {
+		values.push_back(this->inValue()->getValue());
+	}
+};
+
+static void createPresentedNode(std::shared_ptr<SceneGraph> scn,
+	std::shared_ptr<RecordingOutput>& output,
+	std::shared_ptr<RecordingVisual>& visual)
+{
+	auto node = scn->addNode(std::make_shared<RateNode>(0.01f));
+	node->outValue()->setValue(0.0f);
+
+	output = std::make_shared<RecordingOutput>();
+	node->outValue()->connect(output->inValue());
+	node->addModule(output);
+
+	visual = std::make_shared<RecordingVisual>();
+	node->outValue()->connect(visual->inValue());
+	node->graphicsPipeline()->pushModule(visual);
+}
+
+TEST(SceneGraph, pipelined_frames)
+{
+	const int frames = 20;
+
+	std::shared_ptr<RecordingOutput> serialOutput, pipelinedOutput;
+	std::shared_ptr<RecordingVisual> serialVisual, pipelinedVisual;
+
+	auto serial = std::make_shared<SceneGraph>();
+	serial->printFrameInfo(false);
+	createPresentedNode(serial, serialOutput, serialVisual);
+
+	auto pipelined = std::make_shared<SceneGraph>();
+	pipelined->printFrameInfo(false);
+	pipelined->setPipelined(true);
+	createPresentedNode(pipelined, pipelinedOutput, pipelinedVisual);
+
+	serial->initialize();
+	pipelined->initialize();
+	for (int f = 0; f < frames; f++)
+	{
+		serial->takeOneFrame();
+		serial->updateGraphicsContext();
+
+		pipelined->takeOneFrame();
+	}
+
+	pipelined->finishPresentation();
+
+	// graphics and output modules see every frame as in serial order
+	ASSERT_EQ(serialOutput->values.size(), (size_t)frames);
+	ASSERT_EQ(serialVisual->values.size(), (size_t)frames);
+	EXPECT_EQ(pipelinedOutput->values, serialOutput->values);
+	EXPECT_EQ(pipelinedVisual->values, serialVisual->values);
+}
+
+TEST(SceneGraph, pipelined_frames_of_connected_nodes)
+{
+	const int frames = 5;
+
+	auto scn = std::make_shared<SceneGraph>();
+	scn->printFrameInfo(false);
+	scn->setPipelined(true);
+
+	auto source = scn->addNode(std::make_shared<RateNode>(0.01f));
+	source->outValue()->setValue(0.0f);
+
+	// only reached through the field connection, never added to the scene graph
+	auto sink = std::make_shared<RateNode>(0.01f);
+	source->outValue()->connect(sink->inValue());
+	sink->outValue()->setValue(0.0f);
+
+	auto visual = std::make_shared<RecordingVisual>();
+	sink->outValue()->connect(visual->inValue());
+	sink->graphicsPipeline()->pushModule(visual);
+
+	scn->initialize();
+	for (int f = 0; f < frames; f++)
+		scn->takeOneFrame();
+
+	scn->finishPresentation();
+
+	EXPECT_EQ(visual->values.size(), (size_t)frames);
+
+	// presenting must not register the connected node with the scene graph
+	scn->deleteNode(source);
+	EXPECT_TRUE(scn->isEmpty());
+}
@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+
+#include "SceneGraphEnsemble.h"
+#include "SceneGraphFactory.h"
+
+using namespace dyno;
+
+// Accelerates by the gravity of the scene graph its node belongs to, as the particle integrators do
+class GravityIntegrator : public Module {
+public:
+	GravityIntegrator() {
+		this->varForceUpdate()->setValue(true);
+	};
+	~GravityIntegrator() override {};
+
+	DEF_VAR(float, Damping, 0.0f, "");
+
+	DEF_VAR_IN(float, Velocity, "");
+
+protected:
+	void updateImpl() override {
+		Vec3f g = this->getSceneGraph()->getGravity();
+		this->inVelocity()->setValue(this->inVelocity()->getValue() + 0.01f * g[1]);
+	}
+};
+
+class FallingNode : public Node {
+public:
+	FallingNode() {
+		auto integrator = std::make_shared<GravityIntegrator>();
+		integrator->setName("Integrator");
+		this->stateVelocity()->connect(integrator->inVelocity());
+		this->animationPipeline()->pushModule(integrator);
+	};
+	~FallingNode() override {};
+
+	DEF_VAR_STATE(float, Velocity, 0.0f, "");
+};
+
+TEST(SceneGraphEnsemble, gravity_per_member)
+{
+	const float gravity[2] = { -9.8f, -1.62f };
+
+	// members are created one after another before any of them runs
+	int created = 0;
+	SceneGraphEnsemble ensemble([&]() {
+		auto scn = std::make_shared<SceneGraph>();
+		scn->setGravity(Vec3f(0.0f, gravity[created++], 0.0f));
+		scn->addNode(std::make_shared<FallingNode>());
+		return scn;
+	});
+	ensemble.setFrameNumber(20);
+	ensemble.setThreadNumber(2);
+
+	ensemble.addMember();
+	ensemble.addMember();
+
+	std::vector<float> velocity(2, 0.0f);
+	ensemble.setFinishCallback([&](EnsembleMember& member) {
+		auto node = std::dynamic_pointer_cast<FallingNode>(member.scene->begin().get());
+		velocity[member.index] = node->stateVelocity()->getValue();
+	});
+
+	// members must not take the gravity of whichever scene happens to be active
+	auto active = std::make_shared<SceneGraph>();
+	active->setGravity(Vec3f(0.0f, -100.0f, 0.0f));
+	SceneGraphFactory::instance()->pushScene(active);
+
+	EXPECT_TRUE(ensemble.run());
+
+	SceneGraphFactory::instance()->popScene();
+
+	ASSERT_LT(velocity[1], 0.0f);
+	EXPECT_NE(velocity[0], velocity[1]);
+	EXPECT_NEAR(velocity[0] / velocity[1], gravity[0] / gravity[1], 1e-3f);
+}
+
+static std::shared_ptr<SceneGraph> createFallingScene()
+{
+	auto scn = std::make_shared<SceneGraph>();
+	auto node = std::make_shared<FallingNode>();
+	node->setName("Faller");
+	scn->addNode(node);
+	return scn;
+}
+
+static std::shared_ptr<GravityIntegrator> integratorOf(std::shared_ptr<SceneGraph> scn)
+{
+	auto node = scn->begin().get();
+	for (auto& m : node->getModuleList())
+	{
+		auto integrator = std::dynamic_pointer_cast<GravityIntegrator>(m);
+		if (integrator != nullptr)
+			return integrator;
+	}
+
+	return nullptr;
+}
+
+TEST(SceneGraphEnsemble, override_node_field)
+{
+	auto scn = createFallingScene();
+	auto node = std::dynamic_pointer_cast<FallingNode>(scn->begin().get());
+
+	std::string error;
+
+	// nodes are matched by their names
+	EXPECT_TRUE(SceneGraphEnsemble::applyOverride(scn, "Faller.Velocity", "2.5", error));
+	EXPECT_EQ(node->stateVelocity()->getValue(), 2.5f);
+
+	// or by their class names
+	EXPECT_TRUE(SceneGraphEnsemble::applyOverride(scn, "FallingNode.Velocity", "-1.5", error));
+	EXPECT_EQ(node->stateVelocity()->getValue(), -1.5f);
+	EXPECT_TRUE(error.empty());
+}
+
+TEST(SceneGraphEnsemble, override_module_field)
+{
+	auto scn = createFallingScene();
+	auto integrator = integratorOf(scn);
+	ASSERT_TRUE(integrator != nullptr);
+
+	std::string error;
+
+	// modules are matched by their names
+	EXPECT_TRUE(SceneGraphEnsemble::applyOverride(scn, "Faller.Integrator.Damping", "0.25", error));
+	EXPECT_EQ(integrator->varDamping()->getValue(), 0.25f);
+
+	// or by their class names
+	EXPECT_TRUE(SceneGraphEnsemble::applyOverride(scn, "Faller.GravityIntegrator.Damping", "0.75", error));
+	EXPECT_EQ(integrator->varDamping()->getValue(), 0.75f);
+	EXPECT_TRUE(error.empty());
+}
+
+TEST(SceneGraphEnsemble, override_invalid_path)
+{
+	auto scn = createFallingScene();
+	auto node = std::dynamic_pointer_cast<FallingNode>(scn->begin().get());
+	auto integrator = integratorOf(scn);
+	ASSERT_TRUE(integrator != nullptr);
+
+	node->stateVelocity()->setValue(1.0f);
+	integrator->varDamping()->setValue(0.5f);
+
+	const char* paths[] = {
+		"Faller",
+		"Faller.Velocty",
+		"Falling.Velocity",
+		"Faller.Integratr.Damping",
+		"Faller.Integrator.Dampng",
+		"Faller.Integrator.Damping.Value",
+		""
+	};
+
+	for (auto path : paths)
+	{
+		std::string error;
+		EXPECT_FALSE(SceneGraphEnsemble::applyOverride(scn, path, "3.0", error)) << path;
+		EXPECT_FALSE(error.empty()) << path;
+	}
+
+	// the scene is left untouched
+	EXPECT_EQ(node->stateVelocity()->getValue(), 1.0f);
+	EXPECT_EQ(integrator->varDamping()->getValue(), 0.5f);
+
+	// a member with an invalid override is not run
+	SceneGraphEnsemble ensemble(createFallingScene);
+	ensemble.setFrameNumber(1);
+	ensemble.addMember({ { "Faller.Velocty", "3.0" } });
+	ensemble.addMember({ { "Faller.Velocity", "3.0" } });
+
+	EXPECT_FALSE(ensemble.run());
+	EXPECT_FALSE(ensemble.members()[0].succeeded);
+	EXPECT_TRUE(ensemble.members()[0].scene == nullptr);
+	EXPECT_FALSE(ensemble.members()[0].error.empty());
+	EXPECT_TRUE(ensemble.members()[1].succeeded);
+}
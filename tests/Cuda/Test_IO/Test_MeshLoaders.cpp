@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+
+#include "Smesh_IO/smesh.h"
+#include "Gmsh_IO/gmsh.h"
+#include "Surface_Mesh_IO/ObjFileLoader.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <vector>
+using namespace dyno;
+
+TEST(MeshLoaders, smesh)
+{
+	Smesh mesh;
+	mesh.loadFile(getAssetPath() + "smesh/armadillo-coarse.smesh");
+
+	EXPECT_EQ(mesh.m_points.size(), 5803);
+	EXPECT_EQ(mesh.m_tets.size(), 20140);
+
+	EXPECT_EQ(mesh.m_tets[0][0], 4215);
+	EXPECT_EQ(mesh.m_tets[0][3], 5395);
+	EXPECT_EQ(mesh.m_tets.back()[0], 568);
+	EXPECT_EQ(mesh.m_tets.back()[3], 5600);
+	EXPECT_NEAR(mesh.m_points.back()[0], 0.37931574f, 1e-6f);
+}
+
+TEST(MeshLoaders, tetgen)
+{
+	Smesh mesh;
+	mesh.loadNodeFile(getAssetPath() + "smesh/bunny_mesh.1.node");
+	mesh.loadTetFile(getAssetPath() + "smesh/bunny_mesh.1.ele");
+	mesh.loadEdgeFile(getAssetPath() + "smesh/bunny_mesh.1.edge");
+	mesh.loadTriangleFile(getAssetPath() + "smesh/bunny_mesh.1.face");
+
+	EXPECT_EQ(mesh.m_points.size(), 35596);
+	EXPECT_EQ(mesh.m_tets.size(), 122437);
+	EXPECT_EQ(mesh.m_edges.size(), 100768);
+	EXPECT_EQ(mesh.m_triangles.size(), 71188);
+
+	EXPECT_EQ(mesh.m_tets[0][0], 18585);
+	EXPECT_EQ(mesh.m_tets.back()[3], 35517);
+	EXPECT_EQ(mesh.m_edges[0][1], 20462);
+	EXPECT_EQ(mesh.m_triangles[1][2], 8845);
+	EXPECT_NEAR(mesh.m_points[1][0], -0.089558f, 1e-6f);
+}
+
+TEST(MeshLoaders, obj)
+{
+	ObjFileLoader* loader = new ObjFileLoader(getAssetPath() + "obj/boat_mesh.obj");
+
+	EXPECT_EQ(loader->getVertexList().size(), 15288);
+	EXPECT_EQ(loader->getFaceList().size(), 30512);
+	EXPECT_NEAR(loader->getVertexList()[0][0], -0.459030986f, 1e-6f);
+
+	delete loader;
+}
+
+TEST(MeshLoaders, synthetic)
+{
+	//Slightly more records than one parsing chunk (16384), so that chunks are stitched together
+	const int TET_NUM = 20000;
+	const int VERT_NUM = TET_NUM / 5;
+
+	auto dir = std::filesystem::temp_directory_path();
+	std::string smeshFile = (dir / "peridyno_synthetic.smesh").string();
+	std::string gmshFile = (dir / "peridyno_synthetic.msh").string();
+	std::string objFile = (dir / "peridyno_synthetic.obj").string();
+
+	FILE* smesh = fopen(smeshFile.c_str(), "w");
+	FILE* gmsh = fopen(gmshFile.c_str(), "w");
+	FILE* obj = fopen(objFile.c_str(), "w");
+	ASSERT_TRUE(smesh != nullptr && gmsh != nullptr && obj != nullptr);
+
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+	std::uniform_int_distribution<int> vertex(1, VERT_NUM);
+
+	fprintf(smesh, "*VERTICES\n%d 3 0 0\n", VERT_NUM);
+	fprintf(gmsh, "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n$Nodes\n%d\n", VERT_NUM);
+	std::vector<float> coords;
+	for (int i = 1; i <= VERT_NUM; i++)
+	{
+		float x = coord(rng), y = coord(rng), z = coord(rng);
+		coords.push_back(x);
+		coords.push_back(y);
+		coords.push_back(z);
+		fprintf(smesh, "%d %.9g %.9g %.9g\n", i, x, y, z);
+		fprintf(gmsh, "%d %.9g %.9g %.9g\n", i, x, y, z);
+		fprintf(obj, "v %.9g %.9g %.9g\n", x, y, z);
+	}
+
+	fprintf(smesh, "*ELEMENTS\nTET\n%d 4 0\n", TET_NUM);
+	fprintf(gmsh, "$EndNodes\n$Elements\n%d\n", TET_NUM + 1);
+	fprintf(gmsh, "1 15 2 0 1 1\n");
+	for (int i = 1; i <= TET_NUM; i++)
+	{
+		int a = vertex(rng), b = vertex(rng), c = vertex(rng), d = vertex(rng);
+		fprintf(smesh, "%d %d %d %d %d\n", i, a, b, c, d);
+		fprintf(gmsh, "%d 4 2 0 1 %d %d %d %d\n", i + 1, a, b, c, d);
+		fprintf(obj, "f %d %d %d\n", a, b, c);
+	}
+	fprintf(gmsh, "$EndElements\n");
+
+	fclose(smesh);
+	fclose(gmsh);
+	fclose(obj);
+
+	Smesh smeshLoader;
+	smeshLoader.loadFile(smeshFile);
+	EXPECT_EQ(smeshLoader.m_points.size(), VERT_NUM);
+	EXPECT_EQ(smeshLoader.m_tets.size(), TET_NUM);
+
+	Gmsh gmshLoader;
+	gmshLoader.loadFile(gmshFile);
+	EXPECT_EQ(gmshLoader.m_points.size(), VERT_NUM);
+	EXPECT_EQ(gmshLoader.m_tets.size(), TET_NUM);
+
+	ObjFileLoader* objLoader = new ObjFileLoader(objFile);
+	EXPECT_EQ(objLoader->getVertexList().size(), VERT_NUM);
+	EXPECT_EQ(objLoader->getFaceList().size(), TET_NUM);
+
+	//%.9g round-trips floats exactly, all loaders must agree on every record
+	if (smeshLoader.m_points.size() == VERT_NUM && gmshLoader.m_points.size() == VERT_NUM && objLoader->getVertexList().size() == VERT_NUM)
+	{
+		for (int i = 0; i < VERT_NUM; i++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				ASSERT_EQ(smeshLoader.m_points[i][k], coords[3 * i + k]);
+				ASSERT_EQ(gmshLoader.m_points[i][k], coords[3 * i + k]);
+				ASSERT_EQ(objLoader->getVertexList()[i][k], coords[3 * i + k]);
+			}
+		}
+	}
+
+	if (smeshLoader.m_tets.size() == TET_NUM && gmshLoader.m_tets.size() == TET_NUM && objLoader->getFaceList().size() == TET_NUM)
+	{
+		for (int i = 0; i < TET_NUM; i++)
+		{
+			for (int k = 0; k < 4; k++)
+				ASSERT_EQ(gmshLoader.m_tets[i][k], smeshLoader.m_tets[i][k]);
+
+			for (int k = 0; k < 3; k++)
+				ASSERT_EQ(objLoader->getFaceList()[i][k], smeshLoader.m_tets[i][k]);
+		}
+	}
+
+	delete objLoader;
+
+	std::filesystem::remove(smeshFile);
+	std::filesystem::remove(gmshFile);
+	std::filesystem::remove(objFile);
+}
@@ -0,0 +1,50 @@
+#include "Object.h"
+#include "Plugin/PluginEntry.h"
+
+#if defined(_WIN32)
+#define DEFERRED_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define DEFERRED_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace dyno
+{
+	class DeferredObject : public Object
+	{
+		DECLARE_CLASS(DeferredObject)
+	};
+
+	IMPLEMENT_CLASS(DeferredObject)
+
+	class DeferredObjectB : public Object
+	{
+		DECLARE_CLASS(DeferredObjectB)
+	};
+
+	IMPLEMENT_CLASS(DeferredObjectB)
+}
+
+static int gEntryCount = 0;
+
+DEFERRED_PLUGIN_EXPORT dyno::PluginEntry* initDynoPlugin()
+{
+	static dyno::PluginEntry entry;
+	if (gEntryCount == 0)
+	{
+		entry.setName("Deferred Plugin");
+		entry.setVersion("1.0");
+		entry.setDescription("A plugin used to test deferred loading");
+	}
+
+	gEntryCount++;
+
+	return &entry;
+}
+
+/**
+ * @brief Number of times the plugin was loaded through PluginManager
+ */
+DEFERRED_PLUGIN_EXPORT int deferredPluginEntryCount()
+{
+	return gEntryCount;
+}
@@ -0,0 +1,28 @@
+#include "Object.h"
+#include "Plugin/PluginEntry.h"
+
+#if defined(_WIN32)
+#define MANIFEST_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define MANIFEST_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace dyno
+{
+	class ManifestObject : public Object
+	{
+		DECLARE_CLASS(ManifestObject)
+	};
+
+	IMPLEMENT_CLASS(ManifestObject)
+}
+
+MANIFEST_PLUGIN_EXPORT dyno::PluginEntry* initDynoPlugin()
+{
+	static dyno::PluginEntry entry;
+	entry.setName("Manifest Plugin");
+	entry.setVersion("1.0");
+	entry.setDescription("A plugin used to test writing manifests");
+
+	return &entry;
+}
@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+
+#include "Object.h"
+#include "Plugin/PluginManager.h"
+
+#include <ghc/fs_std.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace dyno;
+
+//Number of times the deferred plugin has been loaded, 0 if it is not mapped into the process
+static int deferredPluginEntryCount(const fs::path& lib)
+{
+	typedef int(*CountFunc)();
+
+	int count = 0;
+#if defined(_WIN32)
+	HMODULE hnd = ::GetModuleHandleA(lib.string().c_str());
+	if (hnd == nullptr)
+		return 0;
+
+	auto func = reinterpret_cast<CountFunc>(::GetProcAddress(hnd, "deferredPluginEntryCount"));
+	count = func != nullptr ? func() : 0;
+#else
+	void* hnd = ::dlopen(lib.string().c_str(), RTLD_LAZY | RTLD_NOLOAD);
+	if (hnd == nullptr)
+		return 0;
+
+	auto func = reinterpret_cast<CountFunc>(::dlsym(hnd, "deferredPluginEntryCount"));
+	count = func != nullptr ? func() : 0;
+
+	::dlclose(hnd);
+#endif
+	return count;
+}
+
+TEST(PluginManager, deferred_loading)
+{
+	auto manager = PluginManager::instance();
+
+	fs::path dir = fs::temp_directory_path() / "peridyno_test_plugin";
+
+	std::error_code error;
+	fs::remove_all(dir, error);
+	fs::create_directories(dir);
+
+	fs::path lib = dir / fs::path(TEST_DEFERRED_PLUGIN).filename();
+	fs::copy_file(TEST_DEFERRED_PLUGIN, lib);
+
+	{
+		std::ofstream manifest(manager->getManifest(lib.string()));
+		manifest << "# Classes registered by the deferred plugin" << std::endl;
+		manifest << "DeferredObject" << std::endl;
+		manifest << "  DeferredObjectB  " << std::endl;
+		manifest << std::endl;
+	}
+
+	//The manifest is parsed, the library is not loaded yet
+	manager->loadPluginByPath(dir.string());
+	EXPECT_EQ(deferredPluginEntryCount(lib), 0);
+	EXPECT_TRUE(manager->getPlugin(lib.string().c_str()) == nullptr);
+
+	//The first request loads the plugin
+	Object* obj = Object::createObject("DeferredObject");
+	ASSERT_TRUE(obj != nullptr);
+	EXPECT_EQ(obj->getClassInfo()->getClassName(), "DeferredObject");
+	EXPECT_EQ(deferredPluginEntryCount(lib), 1);
+	EXPECT_TRUE(manager->getPlugin(lib.string().c_str()) != nullptr);
+
+	//Further requests for any class of the plugin do not load it again
+	Object* objB = Object::createObject("DeferredObjectB");
+	Object* objC = Object::createObject("DeferredObject");
+	EXPECT_TRUE(objB != nullptr);
+	EXPECT_TRUE(objC != nullptr);
+	EXPECT_TRUE(Object::createObject("UnknownObject") == nullptr);
+	EXPECT_EQ(deferredPluginEntryCount(lib), 1);
+
+	delete obj;
+	delete objB;
+	delete objC;
+}
+
+TEST(PluginManager, class_map_loads_deferred_plugins)
+{
+	auto manager = PluginManager::instance();
+
+	fs::path dir = fs::temp_directory_path() / "peridyno_test_plugin_missing";
+
+	std::error_code error;
+	fs::remove_all(dir, error);
+	fs::create_directories(dir);
+
+	//A manifest whose library can not be loaded
+	fs::path lib = dir / ("Missing" + manager->getExtension());
+	{
+		std::ofstream library(lib.string());
+		library << "not a shared library";
+
+		std::ofstream manifest(manager->getManifest(lib.string()));
+		manifest << "MissingObject" << std::endl;
+	}
+
+	manager->loadPluginByPath(dir.string());
+
+	//Iterating all classes tries every deferred plugin once, a failed plugin is not retried
+	auto classMap = Object::getClassMap();
+	ASSERT_TRUE(classMap != nullptr);
+	EXPECT_TRUE(classMap->find("MissingObject") == classMap->end());
+	EXPECT_FALSE(manager->loadPluginOfClass("MissingObject"));
+	EXPECT_TRUE(Object::createObject("MissingObject") == nullptr);
+
+	fs::remove_all(dir, error);
+}
+
+TEST(PluginManager, write_manifest_of_deferred_plugin)
+{
+	auto manager = PluginManager::instance();
+
+	fs::path dir = fs::temp_directory_path() / "peridyno_test_manifest";
+
+	std::error_code error;
+	fs::remove_all(dir, error);
+	fs::create_directories(dir);
+
+	fs::path lib = dir / fs::path(TEST_MANIFEST_PLUGIN).filename();
+	fs::copy_file(TEST_MANIFEST_PLUGIN, lib);
+
+	{
+		std::ofstream manifest(manager->getManifest(lib.string()));
+		manifest << "ManifestObject" << std::endl;
+	}
+
+	//The plugin is deferred when its manifest is rewritten
+	manager->loadPluginByPath(dir.string());
+	ASSERT_TRUE(manager->writeManifest(lib.string()));
+
+	std::vector<std::string> classes;
+	{
+		std::ifstream manifest(manager->getManifest(lib.string()));
+		std::string line;
+		while (std::getline(manifest, line))
+		{
+			if (!line.empty() && line[0] != '#')
+				classes.push_back(line);
+		}
+	}
+
+	ASSERT_EQ(classes.size(), 1u);
+	EXPECT_EQ(classes[0], "ManifestObject");
+
+	fs::remove_all(dir, error);
+}
@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "VkTransfer.h"
+#include "VkStagingRing.h"
 #include <numeric>
+#include <chrono>
+#include <iostream>
 using namespace dyno;
 
 TEST(VkTransfer, copy)
@@ -30,4 +33,86 @@ TEST(VkTransfer, copy)
 	d_vec.clear();
 	vec2.clear();
 	h_vec2.clear();
-}
\ No newline at end of file
+}
+
+TEST(VkTransfer, async)
+{
+	const uint32_t nArray = 1024;
+	const uint32_t nElement = 64;
+
+	std::vector<std::vector<float>> h_src(nArray);
+	std::vector<std::vector<float>> h_dst(nArray);
+	std::vector<VkDeviceArray<float>> d_arr(nArray);
+	for (uint32_t i = 0; i < nArray; i++)
+	{
+		h_src[i].resize(nElement);
+		std::iota(h_src[i].begin(), h_src[i].end(), float(i));
+		h_dst[i].resize(nElement, 0.0f);
+		d_arr[i].resize(nElement);
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (uint32_t i = 0; i < nArray; i++)
+	{
+		vkTransferAsync(d_arr[i], h_src[i]);
+	}
+
+	uint64_t ticket = 0;
+	for (uint32_t i = 0; i < nArray; i++)
+	{
+		ticket = vkTransferAsync(h_dst[i], d_arr[i]);
+	}
+	vkTransferWait(ticket);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+	std::cout << "Round trip of " << nArray << " small arrays: " << 2 * nArray / seconds << " transfers/s" << std::endl;
+
+	for (uint32_t i = 0; i < nArray; i++)
+	{
+		EXPECT_EQ(h_dst[i] == h_src[i], true);
+		d_arr[i].clear();
+	}
+}
+
+TEST(VkTransfer, large)
+{
+	// Larger than the staging ring, the transfer is split into several batches
+	const uint32_t num = 16 * 1024 * 1024;
+
+	std::vector<uint32_t> vec(num);
+	std::iota(vec.begin(), vec.end(), 0u);
+
+	VkDeviceArray<uint32_t> d_vec(num);
+	vkTransfer(d_vec, vec);
+
+	std::vector<uint32_t> vec2(num, 0u);
+	vkTransfer(vec2, d_vec);
+
+	EXPECT_EQ(vec2 == vec, true);
+
+	d_vec.clear();
+}
+
+TEST(VkTransfer, oversize)
+{
+	// A ring far smaller than the transfers, chunks have to wait for earlier batches to be recycled
+	VkStagingRing ring(VkSystem::instance()->currentContext(), 4096);
+
+	const uint32_t num = 64 * 1024;
+
+	std::vector<uint32_t> vec(num);
+	std::iota(vec.begin(), vec.end(), 0u);
+
+	VkDeviceArray<uint32_t> d_vec(num);
+	ring.upload(d_vec.bufferHandle(), 0, vec.data(), sizeof(uint32_t) * num);
+
+	std::vector<uint32_t> vec2(num, 0u);
+	uint64_t ticket = ring.download(vec2.data(), d_vec.bufferHandle(), 0, sizeof(uint32_t) * num);
+	ring.wait(ticket);
+
+	EXPECT_EQ(vec2 == vec, true);
+
+	d_vec.clear();
+}
@@ -0,0 +1,350 @@
+/**
+ * A headless batch runner that takes a fixed number of frames of a scene without any window or graphics context.
+ *
+ * Usage: HeadlessRunner --scene <file.xml | registered name> [options], run with --help for all options.
+ */
+#include <SceneGraph.h>
+#include <SceneGraphFactory.h>
+#include <SceneLoaderFactory.h>
+#include <Action.h>
+#include <Timer.h>
+#include <Module/OutputModule.h>
+#include <Plugin/PluginManager.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <ghc/fs_std.hpp>
+
+using namespace dyno;
+
+enum ExitCode
+{
+	EXIT_OK = 0,
+	EXIT_INVALID_ARGUMENTS = 1,
+	EXIT_SCENE_NOT_LOADED = 2,
+	EXIT_INITIALIZATION_FAILED = 3,
+	EXIT_SIMULATION_FAILED = 4,
+	EXIT_REPORT_NOT_WRITTEN = 5
+};
+
+struct RunnerOptions
+{
+	std::string scene;
+	std::vector<std::string> plugins;
+
+	int frames = 100;
+	float frameRate = 25.0f;
+	bool adaptive = true;
+
+	std::string outputPath;
+	std::string timingFile;
+	std::string summaryFile;
+
+	bool verbose = false;
+	bool nodeTiming = false;
+	bool list = false;
+};
+
+static void printUsage()
+{
+	std::cout <<
+		"Usage: HeadlessRunner --scene <file.xml | name> [options]\n"
+		"  --scene <file.xml | name>   scene file, or the name of a scene registered in SceneGraphFactory\n"
+		"  --plugin <file | directory> load a plugin or all plugins in a directory before the scene is created,\n"
+		"                              the dynamics libraries are not linked and have to be loaded as plugins\n"
+		"  --frames <n>                number of frames to take, 100 by default\n"
+		"  --frame-rate <f>            frames per second of simulated time, 25 by default\n"
+		"  --dt-policy <policy>        adaptive: one step per frame with the smallest time step of all nodes (default)\n"
+		"                              interval: sub-steps until each frame covers 1/frame-rate seconds\n"
+		"  --output-path <dir>         override the output path of all output modules\n"
+		"  --timing <file.csv>         write the per-frame timing as CSV to a file instead of stdout\n"
+		"  --summary <file.json>       write the JSON summary to a file instead of stderr\n"
+		"  --verbose                   print the frame banners to stdout\n"
+		"  --node-timing               print the time cost of each node\n"
+		"  --list                      list all registered scenes and exit\n"
+		"\n"
+		"Exit codes: 0 success, 1 invalid arguments, 2 scene not loaded, 3 initialization failed,\n"
+		"            4 simulation failed, 5 timing or summary file not written\n";
+}
+
+static bool parseArguments(int argc, char** argv, RunnerOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		auto next = [&](std::string& value) -> bool {
+			if (i + 1 >= argc) {
+				std::cerr << "Missing value for " << arg << std::endl;
+				return false;
+			}
+			value = argv[++i];
+			return true;
+		};
+
+		std::string value;
+		if (arg == "--scene") {
+			if (!next(options.scene)) return false;
+		}
+		else if (arg == "--plugin") {
+			if (!next(value)) return false;
+			options.plugins.push_back(value);
+		}
+		else if (arg == "--frames") {
+			if (!next(value)) return false;
+			options.frames = std::atoi(value.c_str());
+			if (options.frames <= 0) {
+				std::cerr << "--frames must be positive" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--frame-rate") {
+			if (!next(value)) return false;
+			options.frameRate = (float)std::atof(value.c_str());
+			if (options.frameRate <= 0.0f) {
+				std::cerr << "--frame-rate must be positive" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--dt-policy") {
+			if (!next(value)) return false;
+			if (value == "adaptive")
+				options.adaptive = true;
+			else if (value == "interval")
+				options.adaptive = false;
+			else {
+				std::cerr << "Unknown dt policy: " << value << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--output-path") {
+			if (!next(options.outputPath)) return false;
+		}
+		else if (arg == "--timing") {
+			if (!next(options.timingFile)) return false;
+		}
+		else if (arg == "--summary") {
+			if (!next(options.summaryFile)) return false;
+		}
+		else if (arg == "--verbose") {
+			options.verbose = true;
+		}
+		else if (arg == "--node-timing") {
+			options.nodeTiming = true;
+		}
+		else if (arg == "--list") {
+			options.list = true;
+		}
+		else if (arg == "--help" || arg == "-h") {
+			return false;
+		}
+		else {
+			std::cerr << "Unknown argument: " << arg << std::endl;
+			return false;
+		}
+	}
+
+	return options.list || !options.scene.empty();
+}
+
+static std::string escapeJson(const std::string& str)
+{
+	std::string ret;
+	for (auto c : str)
+	{
+		if (c == '"' || c == '\\')
+			ret.push_back('\\');
+		ret.push_back(c);
+	}
+	return ret;
+}
+
+static std::shared_ptr<SceneGraph> createScene(const std::string& scene)
+{
+	SceneLoader* loader = SceneLoaderFactory::getInstance().getEntryByFileName(scene);
+	if (loader != nullptr)
+		return loader->load(scene);
+
+	return SceneGraphFactory::instance()->createRegisteredScene(scene);
+}
+
+//Graphics pipelines are never updated, since there is no graphics context to render into
+class DisableGraphicsAct : public Action
+{
+	void process(Node* node) override {
+		node->graphicsPipeline()->disable();
+	}
+};
+
+class OutputPathAct : public Action
+{
+public:
+	OutputPathAct(std::string path) { mPath = path; }
+
+	void process(Node* node) override {
+		for (auto& m : node->getModuleList())
+		{
+			auto output = std::dynamic_pointer_cast<OutputModule>(m);
+			if (output != nullptr)
+				output->varOutputPath()->setValue(mPath);
+		}
+	}
+
+	std::string mPath;
+};
+
+int main(int argc, char** argv)
+{
+	RunnerOptions options;
+	if (!parseArguments(argc, argv, options))
+	{
+		printUsage();
+		return EXIT_INVALID_ARGUMENTS;
+	}
+
+	for (auto& plugin : options.plugins)
+	{
+		if (fs::is_directory(plugin))
+			PluginManager::instance()->loadPluginByPath(plugin);
+		else if (!PluginManager::instance()->loadPlugin(plugin))
+			return EXIT_INVALID_ARGUMENTS;
+	}
+
+	if (options.list)
+	{
+		for (auto& name : SceneGraphFactory::instance()->registeredScenes())
+			std::cout << name << std::endl;
+
+		return EXIT_OK;
+	}
+
+	std::shared_ptr<SceneGraph> scn;
+	try {
+		scn = createScene(options.scene);
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Failed to load scene " << options.scene << ": " << e.what() << std::endl;
+		return EXIT_SCENE_NOT_LOADED;
+	}
+
+	if (scn == nullptr || scn->isEmpty())
+	{
+		std::cerr << "Failed to load scene " << options.scene << std::endl;
+		return EXIT_SCENE_NOT_LOADED;
+	}
+
+	SceneGraphFactory::instance()->pushScene(scn);
+
+	scn->setFrameRate(options.frameRate);
+	scn->setAdaptiveInterval(options.adaptive);
+	scn->printFrameInfo(options.verbose);
+	scn->printNodeInfo(options.nodeTiming);
+
+	scn->traverseForward<DisableGraphicsAct>();
+
+	if (!options.outputPath.empty())
+		scn->traverseForward<OutputPathAct>(options.outputPath);
+
+	try {
+		if (!scn->initialize())
+		{
+			std::cerr << "Failed to initialize scene " << options.scene << std::endl;
+			return EXIT_INITIALIZATION_FAILED;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Failed to initialize scene " << options.scene << ": " << e.what() << std::endl;
+		return EXIT_INITIALIZATION_FAILED;
+	}
+
+	//The per-frame timing and the summary never share a stream so that both can be parsed as they are
+	std::ofstream timingFile;
+	if (!options.timingFile.empty())
+	{
+		timingFile.open(options.timingFile);
+		if (!timingFile.is_open())
+		{
+			std::cerr << "Failed to open " << options.timingFile << std::endl;
+			return EXIT_REPORT_NOT_WRITTEN;
+		}
+	}
+
+	std::ofstream summaryFile;
+	if (!options.summaryFile.empty())
+	{
+		summaryFile.open(options.summaryFile);
+		if (!summaryFile.is_open())
+		{
+			std::cerr << "Failed to open " << options.summaryFile << std::endl;
+			return EXIT_REPORT_NOT_WRITTEN;
+		}
+	}
+
+	std::ostream& timing = timingFile.is_open() ? timingFile : std::cout;
+	std::ostream& summary = summaryFile.is_open() ? summaryFile : std::cerr;
+	timing << "frame,sim_time,wall_ms" << std::endl;
+
+	std::vector<double> costs;
+	costs.reserve(options.frames);
+
+#ifdef CUDA_BACKEND
+	GTimer timer;
+#else
+	CTimer timer;
+#endif // CUDA_BACKEND
+
+	try {
+		for (int i = 0; i < options.frames; i++)
+		{
+			int frame = scn->getFrameNumber();
+
+			timer.start();
+			scn->takeOneFrame();
+			timer.stop();
+
+			double ms = timer.getElapsedTime();
+			costs.push_back(ms);
+
+			timing << frame << "," << std::setprecision(9) << scn->getElapsedTime() << "," << std::setprecision(6) << ms << "\n";
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Simulation failed at frame " << scn->getFrameNumber() << ": " << e.what() << std::endl;
+		return EXIT_SIMULATION_FAILED;
+	}
+
+	timing.flush();
+	if (timingFile.is_open() && timingFile.fail())
+		return EXIT_REPORT_NOT_WRITTEN;
+
+	std::vector<double> sorted = costs;
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (auto c : costs) total += c;
+
+	auto percentile = [&](double p) {
+		return sorted[std::min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5))];
+	};
+
+	//A single line summary that can be parsed as JSON
+	summary << "{\"scene\":\"" << escapeJson(options.scene) << "\""
+		<< ",\"frames\":" << costs.size()
+		<< ",\"sim_time\":" << scn->getElapsedTime()
+		<< ",\"total_ms\":" << total
+		<< ",\"mean_ms\":" << total / costs.size()
+		<< ",\"min_ms\":" << sorted.front()
+		<< ",\"p50_ms\":" << percentile(0.5)
+		<< ",\"p95_ms\":" << percentile(0.95)
+		<< ",\"max_ms\":" << sorted.back()
+		<< "}" << std::endl;
+
+	if (summaryFile.is_open() && summaryFile.fail())
+		return EXIT_REPORT_NOT_WRITTEN;
+
+	return EXIT_OK;
+}